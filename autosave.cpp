@@ -0,0 +1,56 @@
+/**
+ * @file autosave.cpp
+ * @brief Implementation of the AutosaveEngine class.
+ */
+
+#include "autosave.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+long long settingAsNumber(const NoteManager& manager, const std::string& key, long long fallback) {
+    try {
+        return std::max(0LL, std::stoll(manager.getSetting(key, std::to_string(fallback))));
+    } catch (const std::exception&) {
+        return fallback;
+    }
+}
+
+} // namespace
+
+AutosaveEngine::AutosaveEngine(NoteManager& manager)
+    : manager(manager),
+      quiet_period(settingAsNumber(manager, "autosave_delay_ms", 1000)),
+      version_interval(settingAsNumber(manager, "version_interval_seconds", 300)) {}
+
+void AutosaveEngine::noteEdited(int note_id) {
+    dirty_note_id = note_id;
+}
+
+bool AutosaveEngine::save(int note_id, const std::string& content) {
+    if (dirty_note_id == note_id) {
+        dirty_note_id = 0;
+    }
+    auto note = manager.findNoteById(note_id);
+    if (!note) {
+        last_version.erase(note_id);
+        return false;
+    }
+    if (note->contentEquals(content)) {
+        return true; // Edited back to the saved text; keep the version slot for a real change
+    }
+    const auto now = std::chrono::steady_clock::now();
+    auto last = last_version.find(note_id);
+    const bool record_version = last == last_version.end() || now - last->second >= version_interval;
+    manager.saveNoteContent(note_id, content, record_version);
+    if (record_version) {
+        last_version[note_id] = now;
+    }
+    return true;
+}
+
+bool AutosaveEngine::flush() {
+    return manager.flushStorage();
+}
@@ -0,0 +1,79 @@
+/**
+ * @file autosave.hpp
+ * @brief This file contains the policy behind the editor's debounced autosave.
+ */
+
+#ifndef AUTOSAVE_HPP
+#define AUTOSAVE_HPP
+
+#include "notes.hpp"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @class AutosaveEngine
+ * @brief Decides when editor changes are saved and when a save also keeps a version.
+ *
+ * The editor reports every change with noteEdited(), which only marks the
+ * note dirty, so keystrokes never copy the text. Once the editor has been
+ * quiet for quietPeriod() the window reads the text once and calls save().
+ * A save keeps the previous content as a NoteVersion at most once per
+ * versionInterval() per note; the other saves only replace the content.
+ * Disk writes happen on the storage writer thread (see BackgroundStorage),
+ * and flush() waits for them, e.g. before the window closes.
+ *
+ * Settings: "autosave_delay_ms" (default 1000) and
+ * "version_interval_seconds" (default 300). All calls come from the UI thread.
+ */
+class AutosaveEngine {
+public:
+    /**
+     * @brief Constructs the engine and reads its settings.
+     * @param manager The manager that applies the saves.
+     */
+    explicit AutosaveEngine(NoteManager& manager);
+
+    std::chrono::milliseconds quietPeriod() const { return quiet_period; }
+    std::chrono::seconds versionInterval() const { return version_interval; }
+
+    /**
+     * @brief Records that the editor changed a note. Cheap; call it on every change.
+     * @param note_id The ID of the edited note.
+     */
+    void noteEdited(int note_id);
+
+    /**
+     * @brief Checks whether an edit has not been saved yet.
+     */
+    bool hasPendingChanges() const { return dirty_note_id != 0; }
+
+    /**
+     * @brief Gets the ID of the note with unsaved edits, or 0.
+     */
+    int pendingNoteId() const { return dirty_note_id; }
+
+    /**
+     * @brief Saves the editor's text into a note, versioning it if the note's interval has passed.
+     * @param note_id The ID of the note.
+     * @param content The editor's text.
+     * @return True if the note was saved, false if it no longer exists.
+     */
+    bool save(int note_id, const std::string& content);
+
+    /**
+     * @brief Waits until every save so far is on stable storage.
+     * @return True if every write succeeded, false otherwise.
+     */
+    bool flush();
+
+private:
+    NoteManager& manager;
+    std::chrono::milliseconds quiet_period;
+    std::chrono::seconds version_interval;
+    int dirty_note_id = 0;
+    std::unordered_map<int, std::chrono::steady_clock::time_point> last_version; // Note ID -> time of its last version
+};
+
+#endif // AUTOSAVE_HPP
@@ -0,0 +1,162 @@
+/**
+ * @file background_storage.cpp
+ * @brief Implementation of the BackgroundStorage class.
+ */
+
+#include "background_storage.hpp"
+#include "metrics.hpp"
+
+BackgroundStorage::BackgroundStorage(std::unique_ptr<StorageBackend> inner)
+    : inner(std::move(inner)), writer([this] { writerLoop(); }) {}
+
+BackgroundStorage::~BackgroundStorage() {
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+    writer.join();
+}
+
+bool BackgroundStorage::open() {
+    flush();
+    return inner->open();
+}
+
+bool BackgroundStorage::replay(const std::function<void(const StoredFolder&)>& on_folder,
+                               const std::function<void(StoredNote&&)>& on_note) {
+    flush();
+    return inner->replay(on_folder, on_note);
+}
+
+void BackgroundStorage::enqueue(Mutation mutation) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (mutation.put) {
+            auto queued = queued_puts.find(mutation.note_id);
+            if (queued != queued_puts.end()) {
+                *queued->second = std::move(*mutation.put); // The queued write now carries the newest state
+                NOTES_COUNT("storage.coalesced_writes", 1);
+                return;
+            }
+            queued_puts[mutation.note_id] = mutation.put;
+        } else if (mutation.note_id != 0) {
+            queued_puts.erase(mutation.note_id);
+        }
+        queue.push_back(std::move(mutation));
+    }
+    work_available.notify_one();
+}
+
+bool BackgroundStorage::putNote(const StoredNote& note) {
+    Mutation mutation;
+    mutation.note_id = note.id;
+    mutation.put = std::make_shared<StoredNote>(note);
+    enqueue(std::move(mutation));
+    return true;
+}
+
+bool BackgroundStorage::removeNote(int note_id) {
+    Mutation mutation;
+    mutation.note_id = note_id;
+    mutation.apply = [note_id](StorageBackend& backend) { return backend.removeNote(note_id); };
+    enqueue(std::move(mutation));
+    return true;
+}
+
+bool BackgroundStorage::moveNote(int note_id, int folder_id, bool in_trash) {
+    Mutation mutation;
+    mutation.note_id = note_id;
+    mutation.apply = [=](StorageBackend& backend) { return backend.moveNote(note_id, folder_id, in_trash); };
+    enqueue(std::move(mutation));
+    return true;
+}
+
+bool BackgroundStorage::addTag(int note_id, const std::string& tag_name) {
+    Mutation mutation;
+    mutation.note_id = note_id;
+    mutation.apply = [note_id, tag_name](StorageBackend& backend) { return backend.addTag(note_id, tag_name); };
+    enqueue(std::move(mutation));
+    return true;
+}
+
+bool BackgroundStorage::removeTag(int note_id, const std::string& tag_name) {
+    Mutation mutation;
+    mutation.note_id = note_id;
+    mutation.apply = [note_id, tag_name](StorageBackend& backend) { return backend.removeTag(note_id, tag_name); };
+    enqueue(std::move(mutation));
+    return true;
+}
+
+bool BackgroundStorage::putFolder(const StoredFolder& folder) {
+    Mutation mutation;
+    mutation.apply = [folder](StorageBackend& backend) { return backend.putFolder(folder); };
+    enqueue(std::move(mutation));
+    return true;
+}
+
+bool BackgroundStorage::removeFolder(int folder_id) {
+    Mutation mutation;
+    mutation.apply = [folder_id](StorageBackend& backend) { return backend.removeFolder(folder_id); };
+    enqueue(std::move(mutation));
+    return true;
+}
+
+bool BackgroundStorage::sync() {
+    Mutation mutation;
+    mutation.apply = [](StorageBackend& backend) { return backend.sync(); };
+    enqueue(std::move(mutation));
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    return !failed;
+}
+
+bool BackgroundStorage::flush() {
+    sync();
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    drained.wait(lock, [this] { return queue.empty() && !writing; });
+    const bool ok = !failed;
+    failed = false;
+    return ok;
+}
+
+size_t BackgroundStorage::pendingCount() const {
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    return queue.size() + (writing ? 1 : 0);
+}
+
+void BackgroundStorage::writerLoop() {
+    TRACE_THREAD_NAME("storage");
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    while (true) {
+        work_available.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty()) {
+            return; // Stopping, and the destructor flushed everything first
+        }
+        Mutation mutation = std::move(queue.front());
+        queue.pop_front();
+        StoredNote note;
+        if (mutation.put) {
+            auto queued = queued_puts.find(mutation.note_id);
+            if (queued != queued_puts.end() && queued->second == mutation.put) {
+                queued_puts.erase(queued); // Later saves of this note queue a new write
+            }
+            note = std::move(*mutation.put);
+        }
+        writing = true;
+        lock.unlock();
+
+        bool ok;
+        {
+            NOTES_TIME_OPERATION("storage.background_write");
+            ok = mutation.put ? inner->putNote(note) : mutation.apply(*inner);
+        }
+
+        lock.lock();
+        writing = false;
+        failed = failed || !ok;
+        if (queue.empty()) {
+            drained.notify_all();
+        }
+    }
+}
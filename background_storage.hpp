@@ -0,0 +1,101 @@
+/**
+ * @file background_storage.hpp
+ * @brief This file contains a StorageBackend decorator that performs writes on a background thread.
+ */
+
+#ifndef BACKGROUND_STORAGE_HPP
+#define BACKGROUND_STORAGE_HPP
+
+#include "storage_backend.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * @class BackgroundStorage
+ * @brief Queues every mutation and applies it to another backend on a writer thread.
+ *
+ * Mutations are applied in the order they were made, so the wrapped backend
+ * sees exactly the sequence NoteManager produced, only later. A putNote that
+ * is still queued is overwritten in place by a newer putNote of the same note,
+ * so a burst of saves costs one write; any other mutation of that note ends
+ * the coalescing so ordering is preserved. sync() is queued like the other
+ * mutations; flush() is the call that waits for the disk.
+ *
+ * open() and replay() run synchronously and must happen before the first
+ * mutation, as they do during startup.
+ */
+class BackgroundStorage : public StorageBackend {
+public:
+    /**
+     * @brief Wraps a backend and starts the writer thread.
+     * @param inner The backend that receives the writes. Only the writer thread uses it afterwards.
+     */
+    explicit BackgroundStorage(std::unique_ptr<StorageBackend> inner);
+
+    /**
+     * @brief Applies every queued mutation, syncs, and stops the writer thread.
+     */
+    ~BackgroundStorage() override;
+
+    BackgroundStorage(const BackgroundStorage&) = delete;
+    BackgroundStorage& operator=(const BackgroundStorage&) = delete;
+
+    bool open() override;
+    bool replay(const std::function<void(const StoredFolder&)>& on_folder,
+                const std::function<void(StoredNote&&)>& on_note) override;
+
+    bool putNote(const StoredNote& note) override;
+    bool removeNote(int note_id) override;
+    bool moveNote(int note_id, int folder_id, bool in_trash) override;
+    bool addTag(int note_id, const std::string& tag_name) override;
+    bool removeTag(int note_id, const std::string& tag_name) override;
+    bool putFolder(const StoredFolder& folder) override;
+    bool removeFolder(int folder_id) override;
+
+    /**
+     * @brief Queues a sync of the wrapped backend. Returns at once.
+     * @return False if an earlier queued mutation has failed since the last flush, true otherwise.
+     */
+    bool sync() override;
+
+    /**
+     * @brief Waits until every queued mutation is applied and synced to stable storage.
+     * @return True if every mutation since the last flush succeeded, false otherwise.
+     */
+    bool flush();
+
+    /**
+     * @brief Gets the number of mutations waiting for the writer thread.
+     */
+    size_t pendingCount() const;
+
+private:
+    struct Mutation {
+        int note_id = 0;                    // 0 for folder mutations and syncs
+        std::shared_ptr<StoredNote> put;    // Set for putNote, which may be overwritten while queued
+        std::function<bool(StorageBackend&)> apply;
+    };
+
+    void enqueue(Mutation mutation);
+    void writerLoop();
+
+    std::unique_ptr<StorageBackend> inner;
+
+    mutable std::mutex queue_mutex;
+    std::condition_variable work_available;
+    std::condition_variable drained;
+    std::deque<Mutation> queue;
+    std::unordered_map<int, std::shared_ptr<StoredNote>> queued_puts; // Note ID -> its coalescable putNote
+    bool writing = false;  // The writer is applying a mutation it has taken off the queue
+    bool failed = false;   // A mutation failed since the last flush
+    bool stopping = false;
+    std::thread writer;
+};
+
+#endif // BACKGROUND_STORAGE_HPP
@@ -0,0 +1,570 @@
+/**
+ * @file bench_main.cpp
+ * @brief Entry point of the notes_bench executable: end-to-end benchmarks of NoteManager on a generated corpus.
+ *
+ * build_bench.sh lists the exact sources and builds it. It does not link in
+ * this tree yet: the script names the Note, Folder, Tag, ConfigManager and
+ * NoteManager definitions that are still missing.
+ *
+ * Every run writes the corpus, loads it with initializeFromFileSystem and
+ * times the core operations, then writes one JSON object per benchmark to
+ * --out. Passing --baseline with an earlier results file prints the change in
+ * median latency of every benchmark, so two builds can be compared on the
+ * same machine. Run it from a scratch directory: NoteManager reads app.conf
+ * and writes its index files next to it.
+ *
+ * The executable replaces the global operator new to count heap allocations,
+ * and every result reports the mean number of allocations per operation. The
+ * same hook tracks live heap bytes, which gives the footprint of the loaded
+ * store. To measure the object arena, run once with "object_arena = false" in
+ * app.conf and pass that results file as --baseline to a default run.
+ *
+ * --micro runs the microbenchmarks of benchmarks.hpp (ID indexes and logger)
+ * instead, without a corpus.
+ */
+
+#include "benchmarks.hpp"
+#include "corpus_generator.hpp"
+#include "metrics.hpp"
+#include "note_batch.hpp"
+#include "notes.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> allocation_count{0};
+std::atomic<int64_t> live_allocations{0};
+std::atomic<int64_t> live_heap_bytes{0};
+
+// Each block starts with its requested size, so operator delete can keep live_heap_bytes exact.
+constexpr size_t ALLOCATION_HEADER = alignof(std::max_align_t);
+
+} // namespace
+
+// --- Allocation Counting ---
+// The array and nothrow forms of the default operators forward to these.
+
+void* operator new(std::size_t size) {
+    char* block = static_cast<char*>(std::malloc(size + ALLOCATION_HEADER));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    live_allocations.fetch_add(1, std::memory_order_relaxed);
+    live_heap_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+    return block + ALLOCATION_HEADER;
+}
+
+void operator delete(void* memory) noexcept {
+    if (!memory) {
+        return;
+    }
+    char* block = static_cast<char*>(memory) - ALLOCATION_HEADER;
+    live_allocations.fetch_sub(1, std::memory_order_relaxed);
+    live_heap_bytes.fetch_sub(static_cast<int64_t>(*reinterpret_cast<size_t*>(block)), std::memory_order_relaxed);
+    std::free(block);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    operator delete(memory);
+}
+
+namespace {
+
+struct BenchOptions {
+    CorpusOptions corpus;
+    size_t iterations = 1000; ///< For the fast operations; loads and folder moves use fewer.
+    size_t load_runs = 3;
+    std::string dir = "bench_corpus";
+    std::string out = "bench_results.json";
+    std::string baseline;
+    bool micro = false;
+    size_t micro_notes = 1000000;   ///< Notes indexed by runIdIndexBenchmark.
+    size_t micro_records = 200000;  ///< Records written by runLoggerBenchmark.
+};
+
+/**
+ * @struct Footprint
+ * @brief The heap held by a loaded NoteManager: the live-heap difference across its load.
+ */
+struct Footprint {
+    int64_t heap_bytes = 0;
+    int64_t allocations = 0;
+    ObjectArena::Stats arena;
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;
+    double total_ms = 0.0;
+    double mean_ns = 0.0;
+    uint64_t p50_ns = 0;
+    uint64_t p90_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t max_ns = 0;
+    double allocations_per_op = 0.0;
+};
+
+uint64_t elapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+/**
+ * @brief Runs fn(i) for i in [0, iterations) and records each call in a fresh histogram,
+ * counting the heap allocations made by the calls themselves.
+ */
+BenchResult measure(const std::string& name, size_t iterations, const std::function<void(size_t)>& fn) {
+    LatencyHistogram histogram;
+    uint64_t total = 0;
+    uint64_t allocations = 0;
+    for (size_t i = 0; i < iterations; ++i) {
+        const uint64_t allocations_before = allocation_count.load(std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+        fn(i);
+        const uint64_t ns = elapsedNanoseconds(start);
+        allocations += allocation_count.load(std::memory_order_relaxed) - allocations_before;
+        histogram.record(ns);
+        total += ns;
+    }
+    BenchResult result;
+    result.name = name;
+    result.iterations = histogram.count();
+    result.total_ms = static_cast<double>(total) / 1e6;
+    result.mean_ns = histogram.mean();
+    result.p50_ns = histogram.percentile(50);
+    result.p90_ns = histogram.percentile(90);
+    result.p99_ns = histogram.percentile(99);
+    result.max_ns = histogram.max();
+    result.allocations_per_op = iterations ? static_cast<double>(allocations) / static_cast<double>(iterations) : 0.0;
+    std::cout << "  " << std::left << std::setw(28) << name << std::right << std::setw(8) << result.iterations
+              << std::fixed << std::setprecision(1) << std::setw(14) << result.mean_ns / 1000.0 << " us mean"
+              << std::setw(12) << static_cast<double>(result.p99_ns) / 1000.0 << " us p99" << std::setw(12)
+              << result.allocations_per_op << " allocs/op" << std::endl;
+    return result;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+bool writeResults(const BenchOptions& options, const Corpus& corpus, const Footprint& footprint,
+                  const std::vector<BenchResult>& results) {
+    std::ofstream out(options.out, std::ios::trunc);
+    if (!out) return false;
+    const CorpusOptions& c = options.corpus;
+    out << "{\n"
+        << "  \"schema\": \"notes-bench/1\",\n"
+#ifdef NDEBUG
+        << "  \"build\": {\"compiler\": \"" << jsonEscape(__VERSION__) << "\", \"ndebug\": true},\n"
+#else
+        << "  \"build\": {\"compiler\": \"" << jsonEscape(__VERSION__) << "\", \"ndebug\": false},\n"
+#endif
+        << "  \"corpus\": {\"notes\": " << c.note_count << ", \"min_words\": " << c.min_words
+        << ", \"max_words\": " << c.max_words << ", \"folder_depth\": " << c.folder_depth
+        << ", \"folders_per_level\": " << c.folders_per_level << ", \"folders\": " << corpus.folders.size()
+        << ", \"tags\": " << c.tag_count << ", \"tags_per_note\": " << c.tags_per_note
+        << ", \"vocabulary\": " << c.vocabulary_size << ", \"text_bytes\": " << corpus.textBytes()
+        << ", \"seed\": " << c.seed << "},\n"
+        << "  \"footprint\": {\"live_heap_bytes\": " << footprint.heap_bytes
+        << ", \"live_allocations\": " << footprint.allocations << ", \"arena_slabs\": " << footprint.arena.slab_count
+        << ", \"arena_reserved_bytes\": " << footprint.arena.reserved_bytes
+        << ", \"arena_live_bytes\": " << footprint.arena.live_bytes << "},\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        const double ops_per_sec = r.total_ms > 0.0 ? static_cast<double>(r.iterations) * 1000.0 / r.total_ms : 0.0;
+        out << "    {\"name\": \"" << jsonEscape(r.name) << "\", \"iterations\": " << r.iterations << std::fixed
+            << std::setprecision(3) << ", \"total_ms\": " << r.total_ms << std::setprecision(1)
+            << ", \"mean_ns\": " << r.mean_ns << ", \"p50_ns\": " << r.p50_ns << ", \"p90_ns\": " << r.p90_ns
+            << ", \"p99_ns\": " << r.p99_ns << ", \"max_ns\": " << r.max_ns << ", \"ops_per_sec\": " << ops_per_sec
+            << ", \"allocs_per_op\": " << r.allocations_per_op << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+struct BaselineResult {
+    double p50_ns = 0.0;
+    double allocations_per_op = -1.0; ///< Negative for results files written before allocations were counted.
+};
+
+/**
+ * @brief Reads name -> p50_ns and allocs_per_op from a results file. Relies on the one-result-per-line layout of writeResults.
+ */
+std::map<std::string, BaselineResult> readBaseline(const std::string& path) {
+    std::map<std::string, BaselineResult> baseline;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t name_at = line.find("\"name\": \"");
+        const size_t p50_at = line.find("\"p50_ns\": ");
+        if (name_at == std::string::npos || p50_at == std::string::npos) continue;
+        const size_t name_begin = name_at + 9;
+        const size_t name_end = line.find('"', name_begin);
+        if (name_end == std::string::npos) continue;
+        BaselineResult& result = baseline[line.substr(name_begin, name_end - name_begin)];
+        result.p50_ns = std::atof(line.c_str() + p50_at + 10);
+        const size_t allocations_at = line.find("\"allocs_per_op\": ");
+        if (allocations_at != std::string::npos) {
+            result.allocations_per_op = std::atof(line.c_str() + allocations_at + 17);
+        }
+    }
+    return baseline;
+}
+
+/**
+ * @brief Reads a number that follows `key` on the footprint line of a results file, or -1.
+ */
+double readBaselineFootprint(const std::string& path, const std::string& key) {
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find("\"footprint\"") == std::string::npos) continue;
+        const size_t at = line.find("\"" + key + "\": ");
+        return at == std::string::npos ? -1.0 : std::atof(line.c_str() + at + key.size() + 4);
+    }
+    return -1.0;
+}
+
+void compareWithBaseline(const std::string& path, const Footprint& footprint, const std::vector<BenchResult>& results) {
+    const auto baseline = readBaseline(path);
+    if (baseline.empty()) {
+        std::cerr << "No results found in baseline " << path << std::endl;
+        return;
+    }
+    const double baseline_bytes = readBaselineFootprint(path, "live_heap_bytes");
+    const double baseline_allocations = readBaselineFootprint(path, "live_allocations");
+    if (baseline_bytes > 0.0 && baseline_allocations > 0.0) {
+        std::cout << "\nFootprint against " << path << ": " << std::fixed << std::setprecision(1)
+                  << baseline_bytes / 1048576.0 << " -> " << static_cast<double>(footprint.heap_bytes) / 1048576.0
+                  << " MiB in " << static_cast<int64_t>(baseline_allocations) << " -> " << footprint.allocations
+                  << " blocks\n";
+    }
+    std::cout << "\nMedian latency and allocations per operation against " << path << ":\n";
+    for (const auto& r : results) {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end() || it->second.p50_ns <= 0.0) continue;
+        const double change = (static_cast<double>(r.p50_ns) - it->second.p50_ns) / it->second.p50_ns * 100.0;
+        std::cout << "  " << std::left << std::setw(28) << r.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << it->second.p50_ns / 1000.0 << " us" << std::setw(12)
+                  << static_cast<double>(r.p50_ns) / 1000.0 << " us" << std::showpos << std::setw(9) << change
+                  << "%" << std::noshowpos;
+        if (it->second.allocations_per_op >= 0.0) {
+            std::cout << std::setw(12) << it->second.allocations_per_op << " ->" << std::setw(10)
+                      << r.allocations_per_op << " allocs/op";
+        }
+        std::cout << "\n";
+    }
+}
+
+void collectFolders(const std::shared_ptr<Folder>& folder, std::vector<std::shared_ptr<Folder>>& out) {
+    out.push_back(folder);
+    for (const auto& subfolder : folder->getSubfolderList()) {
+        collectFolders(subfolder, out);
+    }
+}
+
+/**
+ * @brief Lists a folder tree the way the UI and CLI did before the view accessors: every getter returns a copy.
+ * @return The number of bytes listed, so the copies cannot be optimized away.
+ */
+size_t listWithCopies(const std::shared_ptr<Folder>& folder) {
+    size_t bytes = folder->getName().size();
+    for (const auto& note : folder->getNotes()) {
+        bytes += note->getTitle().size();
+        for (const auto& tag : note->getTags()) bytes += tag->getName().size();
+    }
+    for (const auto& subfolder : folder->getSubfolders()) {
+        bytes += listWithCopies(subfolder);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Lists a folder tree through the non-owning accessors.
+ */
+size_t listWithViews(const Folder& folder) {
+    size_t bytes = folder.getNameView().size();
+    for (const auto& note : folder.getNoteList()) {
+        bytes += note->getTitleView().size();
+        for (const auto& tag : note->getTagList()) bytes += tag->getNameView().size();
+    }
+    for (const auto& subfolder : folder.getSubfolderList()) {
+        bytes += listWithViews(*subfolder);
+    }
+    return bytes;
+}
+
+void printUsage() {
+    std::cout << "Usage: notes_bench [options]\n"
+              << "  --notes N           Number of notes (default 10000)\n"
+              << "  --min-words N       Shortest note body in words (default 20)\n"
+              << "  --max-words N       Longest note body in words (default 2000)\n"
+              << "  --depth N           Folder levels below the root (default 3)\n"
+              << "  --fanout N          Subfolders per folder (default 4)\n"
+              << "  --tags N            Distinct tags (default 50)\n"
+              << "  --tags-per-note N   Tags per note (default 3)\n"
+              << "  --vocabulary N      Distinct words (default 5000)\n"
+              << "  --seed N            Corpus seed (default 42)\n"
+              << "  --iterations N      Iterations of the fast benchmarks (default 1000)\n"
+              << "  --load-runs N       Repetitions of the full load (default 3)\n"
+              << "  --dir PATH          Scratch directory for the corpus (default bench_corpus)\n"
+              << "  --out PATH          Results file (default bench_results.json)\n"
+              << "  --baseline PATH     Earlier results file to compare against\n"
+              << "  --micro             Run the ID index and logger microbenchmarks instead\n"
+              << "  --micro-notes N     Notes in the ID index microbenchmark (default 1000000)\n"
+              << "  --micro-records N   Records in the logger microbenchmark (default 200000)\n";
+}
+
+bool parseArguments(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string flag = argv[i];
+        if (flag == "--help" || flag == "-h") {
+            return false;
+        }
+        if (flag == "--micro") {
+            options.micro = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << flag << std::endl;
+            return false;
+        }
+        const std::string value = argv[++i];
+        const auto number = [&value] { return static_cast<size_t>(std::stoull(value)); };
+        if (flag == "--notes") options.corpus.note_count = number();
+        else if (flag == "--min-words") options.corpus.min_words = number();
+        else if (flag == "--max-words") options.corpus.max_words = number();
+        else if (flag == "--depth") options.corpus.folder_depth = number();
+        else if (flag == "--fanout") options.corpus.folders_per_level = number();
+        else if (flag == "--tags") options.corpus.tag_count = number();
+        else if (flag == "--tags-per-note") options.corpus.tags_per_note = number();
+        else if (flag == "--vocabulary") options.corpus.vocabulary_size = number();
+        else if (flag == "--seed") options.corpus.seed = std::stoull(value);
+        else if (flag == "--iterations") options.iterations = number();
+        else if (flag == "--load-runs") options.load_runs = number();
+        else if (flag == "--dir") options.dir = value;
+        else if (flag == "--out") options.out = value;
+        else if (flag == "--baseline") options.baseline = value;
+        else if (flag == "--micro-notes") options.micro_notes = number();
+        else if (flag == "--micro-records") options.micro_records = number();
+        else {
+            std::cerr << "Unknown option " << flag << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    try {
+        if (!parseArguments(argc, argv, options)) {
+            printUsage();
+            return 1;
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Invalid number" << std::endl;
+        printUsage();
+        return 1;
+    }
+
+    if (options.micro) {
+        runIdIndexBenchmark(options.micro_notes);
+        runLoggerBenchmark(options.micro_records);
+        return 0;
+    }
+
+    namespace fs = std::filesystem;
+    const std::string data_path = (fs::path(options.dir) / "data").string();
+    const std::string trash_path = (fs::path(options.dir) / "trash").string();
+
+    const CorpusGenerator generator(options.corpus);
+    const Corpus corpus = generator.generate();
+    std::cout << "Corpus: " << corpus.notes.size() << " notes, " << corpus.folders.size() << " folders, "
+              << corpus.tags.size() << " tags, " << corpus.textBytes() / 1024 << " KiB of text" << std::endl;
+
+    std::error_code ec;
+    fs::remove_all(data_path, ec);
+    fs::remove_all(trash_path, ec);
+    fs::create_directories(trash_path, ec);
+    if (!CorpusGenerator::writeToDirectory(corpus, data_path)) {
+        std::cerr << "Could not write the corpus to " << data_path << std::endl;
+        return 1;
+    }
+
+    std::vector<BenchResult> results;
+    const size_t n = options.iterations;
+
+    // --- Load ---
+    results.push_back(measure("initializeFromFileSystem", options.load_runs, [&](size_t) {
+        NoteManager manager;
+        manager.initializeFromFileSystem(data_path, trash_path);
+    }));
+
+    Footprint footprint;
+    const int64_t heap_bytes_before = live_heap_bytes.load();
+    const int64_t allocations_before = live_allocations.load();
+    NoteManager manager;
+    manager.initializeFromFileSystem(data_path, trash_path);
+    footprint.heap_bytes = live_heap_bytes.load() - heap_bytes_before;
+    footprint.allocations = live_allocations.load() - allocations_before;
+    footprint.arena = manager.getObjectArenaStats();
+    std::cout << "  Loaded store: " << std::fixed << std::setprecision(1)
+              << static_cast<double>(footprint.heap_bytes) / 1048576.0 << " MiB in " << footprint.allocations
+              << " heap blocks; arena " << footprint.arena.slab_count << " slabs, "
+              << static_cast<double>(footprint.arena.live_bytes) / 1048576.0 << " MiB live" << std::endl;
+
+    std::vector<std::shared_ptr<Folder>> folders;
+    collectFolders(manager.getRootFolder(), folders);
+    std::vector<int> note_ids;
+    for (const auto& folder : folders) {
+        for (const auto& note : folder->getNoteList()) note_ids.push_back(note->getId());
+    }
+    if (note_ids.empty()) {
+        std::cerr << "No notes were loaded from " << data_path << std::endl;
+        return 1;
+    }
+    const auto noteAt = [&note_ids](size_t i) { return note_ids[(i * 7919) % note_ids.size()]; };
+    const auto wordAt = [&corpus](size_t i) { return corpus.words[(i * 31) % std::min<size_t>(corpus.words.size(), 500)]; };
+    const auto tagAt = [&corpus](size_t i) { return corpus.tags.empty() ? std::string() : corpus.tags[i % corpus.tags.size()]; };
+    const time_t first = options.corpus.first_date;
+    const time_t span = static_cast<time_t>(options.corpus.date_span_days) * 86400;
+
+    // --- Listing ---
+    // The same walk with copying and with non-owning accessors; compare their allocs/op.
+    size_t listed_bytes = 0;
+    const size_t listings = std::max<size_t>(10, n / 50);
+    results.push_back(measure("listFolderTree.copies", listings, [&](size_t) {
+        listed_bytes += listWithCopies(manager.getRootFolder());
+    }));
+    results.push_back(measure("listFolderTree.views", listings, [&](size_t) {
+        listed_bytes -= listWithViews(*manager.getRootFolder());
+    }));
+    if (listed_bytes != 0) {
+        std::cerr << "The two folder listings disagree" << std::endl;
+    }
+    // Reads the fields a date or tag filter would, for every note: the cost is in touching the objects.
+    size_t scanned = 0;
+    results.push_back(measure("scanNotes", listings, [&](size_t) {
+        for (const auto& folder : folders) {
+            for (const auto& note : folder->getNoteList()) {
+                scanned += static_cast<size_t>(note->getLastModifiedDate()) + note->getTagList().size() +
+                           note->isInTrash();
+            }
+        }
+    }));
+    if (scanned == 0) {
+        std::cerr << "scanNotes read nothing" << std::endl;
+    }
+
+    // --- Search ---
+    results.push_back(measure("searchNotesByKeyword", n, [&](size_t i) { manager.searchNotesByKeyword(wordAt(i)); }));
+    results.push_back(measure("searchNotesByKeyword.rare", n, [&](size_t i) {
+        manager.searchNotesByKeyword(corpus.words[corpus.words.size() - 1 - (i * 31) % corpus.words.size()]);
+    }));
+    results.push_back(measure("searchNotesRanked.top10", n, [&](size_t i) {
+        manager.searchNotesRanked(wordAt(i) + " " + wordAt(i + 7), 10);
+    }));
+    results.push_back(measure("searchNotes.tag", n, [&](size_t i) {
+        NoteManager::SearchCriteria criteria;
+        criteria.tags.push_back(tagAt(i));
+        manager.searchNotes(criteria);
+    }));
+    results.push_back(measure("searchNotes.date", n, [&](size_t i) {
+        NoteManager::SearchCriteria criteria;
+        criteria.start_date = first + static_cast<time_t>(i % 48) * span / 48;
+        criteria.end_date = criteria.start_date + span / 48; // About a month
+        manager.searchNotes(criteria);
+    }));
+    results.push_back(measure("getRecentlyModifiedNotes.50", n, [&](size_t) { manager.getRecentlyModifiedNotes(50); }));
+    results.push_back(measure("searchNotes.keyword_tag_date", n, [&](size_t i) {
+        NoteManager::SearchCriteria criteria;
+        criteria.keyword = wordAt(i);
+        criteria.tags.push_back(tagAt(i));
+        criteria.start_date = first;
+        criteria.end_date = first + span / 2;
+        manager.searchNotes(criteria);
+    }));
+
+    // --- Export ---
+    results.push_back(measure("convertNoteToHtml", n, [&](size_t i) { manager.convertNoteToHtml(noteAt(i)); }));
+    const std::string export_path = (fs::path(options.dir) / "export.tmp").string();
+    results.push_back(measure("exportNoteToMarkdown", n, [&](size_t i) {
+        manager.exportNoteToMarkdown(noteAt(i), export_path);
+    }));
+    results.push_back(measure("exportNoteToJson", n, [&](size_t i) { manager.exportNoteToJson(noteAt(i), export_path); }));
+    fs::remove(export_path, ec);
+
+    // --- Mutations ---
+    results.push_back(measure("editNote", n, [&](size_t i) {
+        const int id = noteAt(i);
+        auto note = manager.findNoteById(id);
+        manager.editNote(id, note->getTitle(), note->getContent() + " " + wordAt(i));
+    }));
+
+    const std::vector<CorpusNote> fresh = generator.generateNotes(corpus, n * 2, 0, options.corpus.seed + 1);
+    results.push_back(measure("createNote", n, [&](size_t i) {
+        manager.createNote(fresh[i].title, fresh[i].content, fresh[i].tags);
+    }));
+    results.push_back(measure("NoteBatch.createNote.x100", std::max<size_t>(1, n / 100), [&](size_t i) {
+        NoteBatch batch(manager);
+        for (size_t j = n + i * 100; j < n + (i + 1) * 100 && j < fresh.size(); ++j) {
+            batch.createNote(fresh[j].title, fresh[j].content, fresh[j].tags);
+        }
+        batch.commit();
+    }));
+
+    // Move the deepest folder under another top-level branch and back; every iteration is one move.
+    std::shared_ptr<Folder> leaf;
+    std::shared_ptr<Folder> destination;
+    const auto& top_level = manager.getRootFolder()->getSubfolderList();
+    if (top_level.size() >= 2) {
+        leaf = top_level.front();
+        while (!leaf->getSubfolderList().empty()) leaf = leaf->getSubfolderList().front();
+        destination = top_level.back();
+    }
+    if (leaf && leaf != top_level.front()) {
+        const int home_id = leaf->getParent()->getId();
+        results.push_back(measure("moveFolder", std::max<size_t>(2, n / 10), [&](size_t i) {
+            manager.moveFolder(leaf->getId(), i % 2 == 0 ? destination->getId() : home_id);
+        }));
+    } else {
+        std::cout << "  moveFolder skipped: needs a depth of at least 2 and at least 2 top-level folders" << std::endl;
+    }
+
+    if (!writeResults(options, corpus, footprint, results)) {
+        std::cerr << "Could not write " << options.out << std::endl;
+        return 1;
+    }
+    std::cout << "Results written to " << options.out << std::endl;
+
+    if (!options.baseline.empty()) {
+        compareWithBaseline(options.baseline, footprint, results);
+    }
+    return 0;
+}
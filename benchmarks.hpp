@@ -0,0 +1,36 @@
+/**
+ * @file benchmarks.hpp
+ * @brief This file contains the microbenchmarks for the NoteManager data structures.
+ */
+
+#ifndef BENCHMARKS_HPP
+#define BENCHMARKS_HPP
+
+#include <cstddef>
+#include <iostream>
+
+/**
+ * @brief Compares the ID indexes and parent lookups used by NoteManager.
+ *
+ * Builds a folder tree with note_count notes out of light stand-in structs,
+ * then times random ID lookups in std::map against IdHashMap, and parent-folder
+ * lookups by tree walk against the per-note back-reference.
+ *
+ * @param note_count The number of notes to generate.
+ * @param out The stream that receives the report.
+ */
+void runIdIndexBenchmark(size_t note_count = 1000000, std::ostream& out = std::cout);
+
+/**
+ * @brief Measures the caller-side cost of Logger::log in synchronous and asynchronous mode.
+ *
+ * Each mode writes message_count INFO records to a temporary file; the
+ * asynchronous timing covers the calls only, then the time to drain is
+ * reported separately. A filtered-out DEBUG call is timed as well.
+ *
+ * @param message_count The number of records to log per mode.
+ * @param out The stream that receives the report.
+ */
+void runLoggerBenchmark(size_t message_count = 200000, std::ostream& out = std::cout);
+
+#endif // BENCHMARKS_HPP
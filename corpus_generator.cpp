@@ -0,0 +1,221 @@
+/**
+ * @file corpus_generator.cpp
+ * @brief Implementation of the CorpusGenerator class.
+ */
+
+#include "corpus_generator.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+
+/**
+ * @brief SplitMix64: small, fast, and identical on every platform.
+ */
+class SplitMix64 {
+public:
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * @brief Returns a value in [0, bound). bound must be non-zero.
+     */
+    uint64_t below(uint64_t bound) { return next() % bound; }
+
+private:
+    uint64_t state;
+};
+
+/**
+ * @brief Samples ranks 0..n-1 with probability proportional to 1/(rank+1), using integer weights only.
+ */
+class ZipfSampler {
+public:
+    explicit ZipfSampler(size_t n) {
+        uint64_t total = 0;
+        cumulative.reserve(n);
+        for (size_t rank = 0; rank < n; ++rank) {
+            total += (uint64_t(1) << 32) / (rank + 1);
+            cumulative.push_back(total);
+        }
+    }
+
+    size_t sample(SplitMix64& rng) const {
+        const uint64_t point = rng.below(cumulative.back());
+        return static_cast<size_t>(std::upper_bound(cumulative.begin(), cumulative.end(), point) - cumulative.begin());
+    }
+
+private:
+    std::vector<uint64_t> cumulative;
+};
+
+const char* const SYLLABLES[] = {"ka", "lo", "mi", "ne", "ra", "su", "to", "vi", "da", "pe",
+                                 "go", "ju", "be", "fi", "ha", "ko", "ma", "no", "ri", "ze"};
+const size_t SYLLABLE_COUNT = sizeof(SYLLABLES) / sizeof(SYLLABLES[0]);
+
+/**
+ * @brief Spells a number with two-letter syllables. Distinct numbers give distinct words.
+ */
+std::string pseudoWord(size_t number) {
+    std::string word;
+    number += SYLLABLE_COUNT; // At least two syllables
+    while (number > 0) {
+        word += SYLLABLES[number % SYLLABLE_COUNT];
+        number /= SYLLABLE_COUNT;
+    }
+    return word;
+}
+
+std::string capitalized(std::string word) {
+    if (!word.empty() && word[0] >= 'a' && word[0] <= 'z') {
+        word[0] = static_cast<char>(word[0] - 'a' + 'A');
+    }
+    return word;
+}
+
+/**
+ * @brief Picks a body length: a uniformly chosen power-of-two range between min and max, then a uniform length in it.
+ */
+size_t pickWordCount(const CorpusOptions& options, SplitMix64& rng) {
+    const size_t low = std::max<size_t>(1, options.min_words);
+    const size_t high = std::max(low, options.max_words);
+    size_t octaves = 1;
+    while ((low << octaves) <= high) ++octaves;
+    const size_t octave = static_cast<size_t>(rng.below(octaves));
+    const size_t from = low << octave;
+    const size_t to = std::min(from << 1, high + 1);
+    return from + static_cast<size_t>(rng.below(std::max<size_t>(1, to - from)));
+}
+
+CorpusNote makeNote(const Corpus& corpus, const ZipfSampler& words, const ZipfSampler& tags, int id,
+                    SplitMix64& rng) {
+    const CorpusOptions& options = corpus.options;
+    CorpusNote note;
+    note.id = id;
+    note.folder = static_cast<size_t>(rng.below(corpus.folders.size()));
+
+    const size_t title_words = 2 + static_cast<size_t>(rng.below(5));
+    for (size_t i = 0; i < title_words; ++i) {
+        const std::string& word = corpus.words[words.sample(rng)];
+        note.title += i == 0 ? capitalized(word) : " " + word;
+    }
+
+    const size_t body_words = pickWordCount(options, rng);
+    note.content.reserve(body_words * 7);
+    for (size_t i = 0; i < body_words; ++i) {
+        const std::string& word = corpus.words[words.sample(rng)];
+        const bool sentence_start = i % 12 == 0;
+        if (i > 0) {
+            note.content += sentence_start ? (i % 60 == 0 ? ".\n\n" : ". ") : " ";
+        }
+        note.content += sentence_start ? capitalized(word) : word;
+    }
+    note.content += ".";
+
+    const size_t wanted = std::min(options.tags_per_note, corpus.tags.size());
+    for (size_t attempt = 0; note.tags.size() < wanted && attempt < wanted * 8; ++attempt) {
+        const std::string& tag = corpus.tags[tags.sample(rng)];
+        if (std::find(note.tags.begin(), note.tags.end(), tag) == note.tags.end()) {
+            note.tags.push_back(tag);
+        }
+    }
+
+    const uint64_t span = std::max<uint64_t>(1, options.date_span_days * 86400ull);
+    note.creation_date = options.first_date + static_cast<time_t>(rng.below(span));
+    note.last_modified_date = note.creation_date + static_cast<time_t>(rng.below(30 * 86400ull));
+    return note;
+}
+
+} // namespace
+
+size_t Corpus::textBytes() const {
+    size_t bytes = 0;
+    for (const auto& note : notes) {
+        bytes += note.title.size() + note.content.size();
+    }
+    return bytes;
+}
+
+CorpusGenerator::CorpusGenerator(const CorpusOptions& options) : options(options) {}
+
+Corpus CorpusGenerator::generate() const {
+    Corpus corpus;
+    corpus.options = options;
+    SplitMix64 rng(options.seed);
+
+    corpus.words.reserve(options.vocabulary_size);
+    for (size_t i = 0; i < std::max<size_t>(1, options.vocabulary_size); ++i) {
+        corpus.words.push_back(pseudoWord(i));
+    }
+    for (size_t i = 0; i < options.tag_count; ++i) {
+        corpus.tags.push_back("topic-" + pseudoWord(i));
+    }
+
+    corpus.folders.push_back(CorpusFolder());
+    size_t level_begin = 0;
+    for (size_t depth = 1; depth <= options.folder_depth; ++depth) {
+        const size_t level_end = corpus.folders.size();
+        for (size_t parent = level_begin; parent < level_end; ++parent) {
+            for (size_t child = 0; child < options.folders_per_level; ++child) {
+                CorpusFolder folder;
+                folder.name = capitalized(corpus.words[static_cast<size_t>(rng.below(corpus.words.size()))]) + "-" +
+                              std::to_string(child + 1);
+                const std::string& parent_path = corpus.folders[parent].path;
+                folder.path = parent_path.empty() ? folder.name : parent_path + "/" + folder.name;
+                folder.parent = static_cast<int>(parent);
+                folder.depth = depth;
+                corpus.folders.push_back(std::move(folder));
+            }
+        }
+        level_begin = level_end;
+    }
+
+    corpus.notes = generateNotes(corpus, options.note_count, 1, options.seed ^ 0x5EED);
+    return corpus;
+}
+
+std::vector<CorpusNote> CorpusGenerator::generateNotes(const Corpus& corpus, size_t count, int first_id,
+                                                       uint64_t seed) const {
+    SplitMix64 rng(seed);
+    const ZipfSampler words(corpus.words.size());
+    const ZipfSampler tags(std::max<size_t>(1, corpus.tags.size()));
+    std::vector<CorpusNote> notes;
+    notes.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        notes.push_back(makeNote(corpus, words, tags, first_id + static_cast<int>(i), rng));
+    }
+    return notes;
+}
+
+bool CorpusGenerator::writeToDirectory(const Corpus& corpus, const std::string& base_path) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    for (const auto& folder : corpus.folders) {
+        fs::create_directories(fs::path(base_path) / folder.path, ec);
+        if (ec) return false;
+    }
+    for (const auto& note : corpus.notes) {
+        std::ofstream out(fs::path(base_path) / corpus.folders[note.folder].path / (std::to_string(note.id) + ".txt"),
+                          std::ios::binary | std::ios::trunc);
+        out << "Title: " << note.title << "\n"
+            << "Created: " << static_cast<long long>(note.creation_date) << "\n"
+            << "Modified: " << static_cast<long long>(note.last_modified_date) << "\n"
+            << "Tags: ";
+        for (size_t i = 0; i < note.tags.size(); ++i) {
+            out << (i ? ", " : "") << note.tags[i];
+        }
+        out << "\n"
+            << "ID: " << note.id << "\n\n"
+            << note.content;
+        if (!out) return false;
+    }
+    return true;
+}
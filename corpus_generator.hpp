@@ -0,0 +1,120 @@
+/**
+ * @file corpus_generator.hpp
+ * @brief This file contains the synthetic note corpus generator used by the benchmarks.
+ */
+
+#ifndef CORPUS_GENERATOR_HPP
+#define CORPUS_GENERATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+/**
+ * @struct CorpusOptions
+ * @brief The shape of a generated corpus. The same options always produce the same corpus.
+ */
+struct CorpusOptions {
+    size_t note_count = 10000;
+    size_t min_words = 20;          ///< Note bodies are log-uniformly sized between min_words and max_words,
+    size_t max_words = 2000;        ///< so most notes are short and a few are long.
+    size_t folder_depth = 3;        ///< Levels of folders below the root.
+    size_t folders_per_level = 4;   ///< Subfolders of every folder above the deepest level.
+    size_t tag_count = 50;          ///< Distinct tags; popularity follows a Zipf distribution.
+    size_t tags_per_note = 3;
+    size_t vocabulary_size = 5000;  ///< Distinct words; frequency follows a Zipf distribution.
+    time_t first_date = 1577836800; ///< 2020-01-01 00:00:00 UTC
+    size_t date_span_days = 1460;
+    uint64_t seed = 42;
+};
+
+/**
+ * @struct CorpusFolder
+ * @brief A generated folder.
+ */
+struct CorpusFolder {
+    std::string name;
+    std::string path; ///< Relative to the corpus root, '/'-separated; empty for the root.
+    int parent = -1;  ///< Index of the parent in Corpus::folders, -1 for the root.
+    size_t depth = 0;
+};
+
+/**
+ * @struct CorpusNote
+ * @brief A generated note.
+ */
+struct CorpusNote {
+    int id = 0;
+    size_t folder = 0; ///< Index in Corpus::folders.
+    std::string title;
+    std::string content;
+    std::vector<std::string> tags;
+    time_t creation_date = 0;
+    time_t last_modified_date = 0;
+};
+
+/**
+ * @struct Corpus
+ * @brief A generated set of folders and notes, plus the word and tag lists used to build them.
+ */
+struct Corpus {
+    CorpusOptions options;
+    std::vector<CorpusFolder> folders; ///< Parents come before children; folders[0] is the root.
+    std::vector<CorpusNote> notes;     ///< In ID order, IDs 1..note_count.
+    std::vector<std::string> words;    ///< Most frequent first.
+    std::vector<std::string> tags;     ///< Most popular first.
+
+    /**
+     * @brief Gets the total size of all titles and bodies, in bytes.
+     */
+    size_t textBytes() const;
+};
+
+/**
+ * @class CorpusGenerator
+ * @brief Builds deterministic synthetic corpora for benchmarks.
+ *
+ * All randomness comes from a SplitMix64 generator seeded with
+ * CorpusOptions::seed and from integer arithmetic, never from <random>
+ * distributions, whose output differs between standard libraries. Two builds
+ * of the benchmark therefore measure the same notes.
+ */
+class CorpusGenerator {
+public:
+    /**
+     * @brief Constructs a generator.
+     * @param options The corpus shape.
+     */
+    explicit CorpusGenerator(const CorpusOptions& options);
+
+    /**
+     * @brief Generates the corpus.
+     */
+    Corpus generate() const;
+
+    /**
+     * @brief Generates notes in the style of a corpus but with new IDs and text, e.g. for creation benchmarks.
+     * @param corpus The corpus whose words, tags and folders are reused.
+     * @param count The number of notes.
+     * @param first_id The ID of the first note.
+     * @param seed The seed for this set of notes.
+     * @return The notes.
+     */
+    std::vector<CorpusNote> generateNotes(const Corpus& corpus, size_t count, int first_id, uint64_t seed) const;
+
+    /**
+     * @brief Writes a corpus as one text file per note, in the layout initializeFromFileSystem reads:
+     * a directory per folder, and "<id>.txt" files with a Title/Created/Modified/Tags/ID header block.
+     * @param corpus The corpus.
+     * @param base_path The directory to write into; created if missing.
+     * @return True on success, false if a file could not be written.
+     */
+    static bool writeToDirectory(const Corpus& corpus, const std::string& base_path);
+
+private:
+    CorpusOptions options;
+};
+
+#endif // CORPUS_GENERATOR_HPP
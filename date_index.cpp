@@ -0,0 +1,107 @@
+/**
+ * @file date_index.cpp
+ * @brief Implementation of the DateIndex class.
+ */
+
+#include "date_index.hpp"
+
+#include <cmath>
+#include <iterator>
+
+void DateIndex::build(std::vector<std::pair<time_t, int>> entries) {
+    clear();
+    base.reserve(entries.size());
+    time_by_note.reserve(entries.size());
+    for (const auto& entry : entries) {
+        if (time_by_note.emplace(entry.second, entry.first).second) {
+            base.push_back(Entry{entry.first, entry.second, false});
+        }
+    }
+    std::sort(base.begin(), base.end());
+}
+
+void DateIndex::set(int note_id, time_t time) {
+    auto it = time_by_note.find(note_id);
+    if (it != time_by_note.end()) {
+        if (it->second == time) {
+            return;
+        }
+        remove(note_id);
+    }
+    time_by_note[note_id] = time;
+    const Entry entry{time, note_id, false};
+    recent.insert(std::upper_bound(recent.begin(), recent.end(), entry), entry);
+    const size_t limit = std::max(MIN_RECENT_RUN, static_cast<size_t>(std::sqrt(static_cast<double>(base.size()))));
+    if (recent.size() > limit || removed_in_base > base.size() / 2 + MIN_RECENT_RUN) {
+        mergeRuns();
+    }
+}
+
+bool DateIndex::remove(int note_id) {
+    auto it = time_by_note.find(note_id);
+    if (it == time_by_note.end()) {
+        return false;
+    }
+    const Entry key{it->second, note_id, false};
+    time_by_note.erase(it);
+    // The recent run is searched first: after a time goes a -> b -> a, the base run still holds
+    // the removed entry for a while the live one is in the recent run.
+    auto in_recent = std::lower_bound(recent.begin(), recent.end(), key);
+    if (in_recent != recent.end() && !(key < *in_recent)) {
+        recent.erase(in_recent);
+        return true;
+    }
+    auto in_base = std::lower_bound(base.begin(), base.end(), key);
+    for (; in_base != base.end() && !(key < *in_base); ++in_base) {
+        if (!in_base->removed) {
+            in_base->removed = true;
+            ++removed_in_base;
+            break;
+        }
+    }
+    return true;
+}
+
+size_t DateIndex::estimateRange(time_t from, time_t to) const {
+    if (from > to) {
+        return 0;
+    }
+    auto b = range(base, from, to);
+    auto r = range(recent, from, to);
+    return static_cast<size_t>(std::distance(b.first, b.second) + std::distance(r.first, r.second));
+}
+
+void DateIndex::clear() {
+    base.clear();
+    recent.clear();
+    removed_in_base = 0;
+    time_by_note.clear();
+}
+
+std::pair<DateIndex::Iterator, DateIndex::Iterator> DateIndex::range(const std::vector<Entry>& run, time_t from,
+                                                                     time_t to) {
+    auto first = std::lower_bound(run.begin(), run.end(), from,
+                                  [](const Entry& entry, time_t time) { return entry.time < time; });
+    auto last = std::upper_bound(first, run.end(), to,
+                                 [](time_t time, const Entry& entry) { return time < entry.time; });
+    return {first, last};
+}
+
+void DateIndex::mergeRuns() {
+    std::vector<Entry> merged;
+    merged.reserve(base.size() - removed_in_base + recent.size());
+    auto b = base.begin();
+    auto r = recent.begin();
+    while (b != base.end() || r != recent.end()) {
+        if (b != base.end() && b->removed) {
+            ++b;
+        } else if (r == recent.end() || (b != base.end() && *b < *r)) {
+            merged.push_back(*b++);
+        } else {
+            merged.push_back(*r++);
+        }
+    }
+    base.swap(merged);
+    recent.clear();
+    removed_in_base = 0;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file date_index.hpp
+ * @brief This file contains the secondary index that orders notes by a timestamp.
+ */
+
+#ifndef DATE_INDEX_HPP
+#define DATE_INDEX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <ctime>
+#include <utility>
+#include <vector>
+#include "id_index.hpp"
+
+/**
+ * @class DateIndex
+ * @brief Note IDs ordered by one timestamp (creation or last modification), for date-range scans.
+ *
+ * The entries are kept in two sorted runs: a large base run and a small run
+ * of recent changes. An update removes the note's old entry and inserts the
+ * new one into the small run, which is merged into the base run once it
+ * outgrows about the square root of the base. An update therefore costs
+ * O(sqrt n) amortized, not the O(n) of keeping one sorted array. A removal
+ * from the base run only marks the entry, and the next merge drops it. Range
+ * scans binary-search both runs and merge the two slices, so they visit only
+ * the notes inside the range, already in date order.
+ *
+ * Ties on the timestamp are ordered by note ID.
+ */
+class DateIndex {
+public:
+    /**
+     * @brief Replaces the contents of the index in one pass.
+     * @param entries (timestamp, note ID) pairs, one per note, in any order.
+     */
+    void build(std::vector<std::pair<time_t, int>> entries);
+
+    /**
+     * @brief Sets the timestamp of a note, adding the note if it is not indexed.
+     * @param note_id The ID of the note.
+     * @param time The timestamp.
+     */
+    void set(int note_id, time_t time);
+
+    /**
+     * @brief Removes a note.
+     * @param note_id The ID of the note.
+     * @return True if the note was indexed.
+     */
+    bool remove(int note_id);
+
+    /**
+     * @brief Gets the number of indexed notes.
+     */
+    size_t size() const { return time_by_note.size(); }
+
+    /**
+     * @brief Estimates the number of notes whose timestamp is in [from, to], in O(log n).
+     * Entries removed from the base run and not merged away yet are counted too.
+     * @param from The first timestamp of the range.
+     * @param to The last timestamp of the range.
+     */
+    size_t estimateRange(time_t from, time_t to) const;
+
+    /**
+     * @brief Calls fn(note_id, time) for each note whose timestamp is in [from, to], oldest first.
+     * fn returns false to stop the scan.
+     */
+    template <typename Fn>
+    void forEachInRange(time_t from, time_t to, Fn&& fn) const {
+        if (from > to) {
+            return;
+        }
+        auto b = range(base, from, to);
+        auto r = range(recent, from, to);
+        while (b.first != b.second || r.first != r.second) {
+            const bool take_base = r.first == r.second || (b.first != b.second && *b.first < *r.first);
+            const Entry& entry = take_base ? *b.first++ : *r.first++;
+            if (!entry.removed && !fn(entry.note_id, entry.time)) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Calls fn(note_id, time) for each note whose timestamp is in [from, to], newest first.
+     * fn returns false to stop the scan, so "the N most recent" reads only N entries.
+     */
+    template <typename Fn>
+    void forEachInRangeNewestFirst(time_t from, time_t to, Fn&& fn) const {
+        if (from > to) {
+            return;
+        }
+        auto b = range(base, from, to);
+        auto r = range(recent, from, to);
+        while (b.first != b.second || r.first != r.second) {
+            const bool take_base = r.first == r.second || (b.first != b.second && *(r.second - 1) < *(b.second - 1));
+            const Entry& entry = take_base ? *--b.second : *--r.second;
+            if (!entry.removed && !fn(entry.note_id, entry.time)) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Removes every entry.
+     */
+    void clear();
+
+private:
+    struct Entry {
+        time_t time;
+        int note_id;
+        bool removed; // Only in the base run; fits in the padding after note_id
+
+        bool operator<(const Entry& other) const {
+            return time != other.time ? time < other.time : note_id < other.note_id;
+        }
+    };
+
+    using Iterator = std::vector<Entry>::const_iterator;
+
+    static constexpr size_t MIN_RECENT_RUN = 256;
+
+    static std::pair<Iterator, Iterator> range(const std::vector<Entry>& run, time_t from, time_t to);
+    void mergeRuns();
+
+    std::vector<Entry> base;   // Sorted
+    std::vector<Entry> recent; // Sorted; never holds removed entries
+    size_t removed_in_base = 0;
+    IdHashMap<time_t> time_by_note;
+};
+
+#endif // DATE_INDEX_HPP
@@ -0,0 +1,200 @@
+/**
+ * @file delta_codec.cpp
+ * @brief Implementation of the delta_codec functions.
+ */
+
+#include "delta_codec.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+namespace {
+
+const size_t BLOCK_SIZE = 16;
+const uint64_t HASH_BASE = 1099511628211ULL;
+const char OP_COPY = 0;
+const char OP_INSERT = 1;
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+bool getVarint(const std::string& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        unsigned char c = static_cast<unsigned char>(in[pos++]);
+        value |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if ((c & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+uint64_t hashBlock(const char* data) {
+    uint64_t h = 0;
+    for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+        h = h * HASH_BASE + static_cast<unsigned char>(data[i]);
+    }
+    return h;
+}
+
+/**
+ * @brief Accumulates instructions, merging adjacent literals and contiguous copies.
+ */
+class DeltaWriter {
+public:
+    explicit DeltaWriter(std::string& out) : out(out) {}
+
+    void copy(size_t offset, size_t length) {
+        if (length == 0) return;
+        flushLiteral();
+        if (copy_length > 0 && copy_offset + copy_length == offset) {
+            copy_length += length;
+            return;
+        }
+        flushCopy();
+        copy_offset = offset;
+        copy_length = length;
+    }
+
+    void literal(const char* data, size_t length) {
+        if (length == 0) return;
+        flushCopy();
+        pending.append(data, length);
+    }
+
+    void finish() {
+        flushCopy();
+        flushLiteral();
+    }
+
+private:
+    void flushCopy() {
+        if (copy_length == 0) return;
+        out += OP_COPY;
+        putVarint(out, copy_offset);
+        putVarint(out, copy_length);
+        copy_length = 0;
+    }
+
+    void flushLiteral() {
+        if (pending.empty()) return;
+        out += OP_INSERT;
+        putVarint(out, pending.size());
+        out += pending;
+        pending.clear();
+    }
+
+    std::string& out;
+    std::string pending;
+    size_t copy_offset = 0;
+    size_t copy_length = 0;
+};
+
+} // namespace
+
+namespace delta_codec {
+
+std::string encode(const std::string& base, const std::string& target) {
+    std::string out;
+    putVarint(out, target.size());
+    DeltaWriter writer(out);
+
+    size_t prefix = 0;
+    size_t max_common = std::min(base.size(), target.size());
+    while (prefix < max_common && base[prefix] == target[prefix]) ++prefix;
+    size_t suffix = 0;
+    while (suffix < max_common - prefix &&
+           base[base.size() - 1 - suffix] == target[target.size() - 1 - suffix]) {
+        ++suffix;
+    }
+
+    writer.copy(0, prefix);
+
+    const size_t base_end = base.size() - suffix;
+    const size_t target_end = target.size() - suffix;
+
+    // Index non-overlapping blocks of the changed region of the base.
+    std::unordered_map<uint64_t, size_t> blocks;
+    if (base_end - prefix >= BLOCK_SIZE && target_end - prefix >= BLOCK_SIZE) {
+        blocks.reserve((base_end - prefix) / BLOCK_SIZE);
+        for (size_t i = prefix; i + BLOCK_SIZE <= base_end; i += BLOCK_SIZE) {
+            blocks.emplace(hashBlock(base.data() + i), i);
+        }
+    }
+
+    size_t literal_start = prefix;
+    size_t pos = prefix;
+    if (!blocks.empty()) {
+        uint64_t top_power = 1; // HASH_BASE^(BLOCK_SIZE - 1), used to roll the leading byte out
+        for (size_t i = 1; i < BLOCK_SIZE; ++i) top_power *= HASH_BASE;
+
+        uint64_t hash = hashBlock(target.data() + pos);
+        while (pos + BLOCK_SIZE <= target_end) {
+            auto it = blocks.find(hash);
+            if (it != blocks.end() && base.compare(it->second, BLOCK_SIZE, target, pos, BLOCK_SIZE) == 0) {
+                size_t base_pos = it->second;
+                size_t length = BLOCK_SIZE;
+                while (pos + length < target_end && base_pos + length < base_end &&
+                       base[base_pos + length] == target[pos + length]) {
+                    ++length;
+                }
+                // Extend backwards into bytes that would otherwise become literals.
+                while (pos > literal_start && base_pos > prefix && base[base_pos - 1] == target[pos - 1]) {
+                    --pos;
+                    --base_pos;
+                    ++length;
+                }
+                writer.literal(target.data() + literal_start, pos - literal_start);
+                writer.copy(base_pos, length);
+                pos += length;
+                literal_start = pos;
+                if (pos + BLOCK_SIZE <= target_end) {
+                    hash = hashBlock(target.data() + pos);
+                }
+                continue;
+            }
+            if (pos + BLOCK_SIZE < target_end) {
+                hash = (hash - top_power * static_cast<unsigned char>(target[pos])) * HASH_BASE +
+                       static_cast<unsigned char>(target[pos + BLOCK_SIZE]);
+            }
+            ++pos;
+        }
+    }
+
+    writer.literal(target.data() + literal_start, target_end - literal_start);
+    writer.copy(base_end, suffix);
+    writer.finish();
+    return out;
+}
+
+bool apply(const std::string& base, const std::string& delta, std::string& target) {
+    size_t pos = 0;
+    uint64_t size = 0;
+    if (!getVarint(delta, pos, size)) return false;
+    target.clear();
+    target.reserve(size);
+    while (pos < delta.size()) {
+        char op = delta[pos++];
+        uint64_t a = 0, b = 0;
+        if (op == OP_COPY) {
+            if (!getVarint(delta, pos, a) || !getVarint(delta, pos, b) || a > base.size() || b > base.size() - a) {
+                return false;
+            }
+            target.append(base, a, b);
+        } else if (op == OP_INSERT) {
+            if (!getVarint(delta, pos, a) || a > delta.size() - pos) return false;
+            target.append(delta, pos, a);
+            pos += a;
+        } else {
+            return false;
+        }
+    }
+    return target.size() == size;
+}
+
+} // namespace delta_codec
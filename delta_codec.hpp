@@ -0,0 +1,43 @@
+/**
+ * @file delta_codec.hpp
+ * @brief This file contains the binary delta encoder used by the note version history.
+ */
+
+#ifndef DELTA_CODEC_HPP
+#define DELTA_CODEC_HPP
+
+#include <string>
+
+/**
+ * @namespace delta_codec
+ * @brief Encodes a text as a sequence of copy/insert instructions against a base text.
+ *
+ * A delta starts with the target length, followed by instructions:
+ * COPY(offset, length) takes bytes from the base, INSERT(length, bytes) adds
+ * literal bytes. Common prefixes and suffixes are found directly; the middle
+ * is matched with a rolling hash over fixed-size blocks of the base, so moved
+ * or repeated paragraphs are also encoded as copies. The size of a delta is
+ * proportional to the size of the edit, not to the size of the text.
+ */
+namespace delta_codec {
+
+/**
+ * @brief Computes the delta that turns base into target.
+ * @param base The previous text.
+ * @param target The new text.
+ * @return The encoded delta.
+ */
+std::string encode(const std::string& base, const std::string& target);
+
+/**
+ * @brief Applies a delta produced by encode().
+ * @param base The text the delta was computed against.
+ * @param delta The encoded delta.
+ * @param target Receives the reconstructed text.
+ * @return True if the delta is well-formed for this base, false otherwise.
+ */
+bool apply(const std::string& base, const std::string& delta, std::string& target);
+
+} // namespace delta_codec
+
+#endif // DELTA_CODEC_HPP
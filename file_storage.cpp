@@ -0,0 +1,258 @@
+/**
+ * @file file_storage.cpp
+ * @brief Implementation of the FileStorage class.
+ */
+
+#include "file_storage.hpp"
+#include "metrics.hpp"
+#include "startup_loader.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+FileStorage::FileStorage(const std::string& base_path, const std::string& trash_path, int trash_folder_id)
+    : base_path(base_path), trash_path(trash_path), trash_folder_id(trash_folder_id) {}
+
+void FileStorage::registerFolder(const StoredFolder& folder) {
+    folders[folder.id] = folder;
+}
+
+void FileStorage::registerNote(int note_id, int folder_id) {
+    note_folders[note_id] = folder_id;
+}
+
+bool FileStorage::open() {
+    std::error_code ec;
+    fs::create_directories(base_path, ec);
+    fs::create_directories(trash_path, ec);
+    return fs::is_directory(base_path, ec) && fs::is_directory(trash_path, ec);
+}
+
+bool FileStorage::replay(const std::function<void(const StoredFolder&)>&, const std::function<void(StoredNote&&)>&) {
+    return false;
+}
+
+// --- Paths ---
+
+std::string FileStorage::folderPath(int folder_id) const {
+    std::vector<const std::string*> names;
+    // A parent chain longer than the number of folders means a cycle; give up rather than loop.
+    while (folder_id != 0 && folder_id != trash_folder_id && names.size() <= folders.size()) {
+        auto it = folders.find(folder_id);
+        if (it == folders.end()) {
+            return std::string();
+        }
+        names.push_back(&it->second.name);
+        folder_id = it->second.parent_id;
+    }
+    if (folder_id != 0 && folder_id != trash_folder_id) {
+        return std::string();
+    }
+    fs::path path(folder_id == trash_folder_id ? trash_path : base_path);
+    for (auto name = names.rbegin(); name != names.rend(); ++name) {
+        path /= **name;
+    }
+    return path.string();
+}
+
+std::string FileStorage::notePath(int note_id, int folder_id) const {
+    const std::string folder = folderPath(folder_id);
+    return folder.empty() ? folder : (fs::path(folder) / (std::to_string(note_id) + ".txt")).string();
+}
+
+// --- Note Files ---
+
+bool FileStorage::writeNote(const StoredNote& note) {
+    const std::string path = notePath(note.id, note.folder_id);
+    if (path.empty()) {
+        return false;
+    }
+    std::string header = "Title: " + note.title + "\nCreated: " + std::to_string(static_cast<long long>(note.creation_date)) +
+                         "\nModified: " + std::to_string(static_cast<long long>(note.last_modified_date)) + "\nTags: ";
+    for (size_t i = 0; i < note.tags.size(); ++i) {
+        header += (i ? ", " : "") + note.tags[i];
+    }
+    header += "\nID: " + std::to_string(note.id) + "\n\n";
+
+    // Written next to the note and renamed over it; the directory walk ignores the ".tmp" file.
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out.write(note.content.data(), static_cast<std::streamsize>(note.content.size()));
+        out.close();
+        if (!out) {
+            std::error_code ec;
+            fs::remove(temporary, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temporary, path, ec);
+    if (ec) {
+        fs::remove(temporary, ec);
+        return false;
+    }
+    NOTES_COUNT("storage.bytes_written", header.size() + note.content.size());
+    return true;
+}
+
+bool FileStorage::readNote(int note_id, StoredNote& note) const {
+    auto it = note_folders.find(note_id);
+    if (it == note_folders.end()) {
+        return false;
+    }
+    const std::string path = notePath(note_id, it->second);
+    NoteHeader header;
+    if (path.empty() || !ParallelDirectoryWalker::readHeader(path, header)) {
+        return false;
+    }
+    note.id = note_id;
+    note.folder_id = it->second;
+    note.title = std::move(header.title);
+    note.content = ParallelDirectoryWalker::readBody(path, header.body_offset);
+    note.tags = std::move(header.tags);
+    note.creation_date = header.creation_date;
+    note.last_modified_date = header.last_modified_date;
+    NOTES_COUNT("storage.bytes_read", header.body_offset + note.content.size());
+    return true;
+}
+
+bool FileStorage::putNote(const StoredNote& note) {
+    TRACE_SCOPE("storage.put_note");
+    std::error_code ec;
+    fs::create_directories(folderPath(note.folder_id), ec);
+    if (!writeNote(note)) {
+        return false;
+    }
+    auto previous = note_folders.find(note.id);
+    if (previous != note_folders.end() && previous->second != note.folder_id) {
+        fs::remove(notePath(note.id, previous->second), ec);
+    }
+    note_folders[note.id] = note.folder_id;
+    return true;
+}
+
+bool FileStorage::removeNote(int note_id) {
+    auto it = note_folders.find(note_id);
+    if (it == note_folders.end()) {
+        return true;
+    }
+    std::error_code ec;
+    fs::remove(notePath(note_id, it->second), ec);
+    note_folders.erase(it);
+    return !ec;
+}
+
+bool FileStorage::moveNote(int note_id, int folder_id, bool) {
+    auto it = note_folders.find(note_id);
+    if (it == note_folders.end()) {
+        return false;
+    }
+    if (it->second == folder_id) {
+        return true;
+    }
+    const std::string destination = notePath(note_id, folder_id);
+    if (destination.empty()) {
+        return false;
+    }
+    std::error_code ec;
+    fs::create_directories(fs::path(destination).parent_path(), ec);
+    fs::rename(notePath(note_id, it->second), destination, ec);
+    if (ec) {
+        return false;
+    }
+    it->second = folder_id;
+    return true;
+}
+
+bool FileStorage::addTag(int note_id, const std::string& tag_name) {
+    StoredNote note;
+    if (!readNote(note_id, note)) {
+        return false;
+    }
+    if (std::find(note.tags.begin(), note.tags.end(), tag_name) != note.tags.end()) {
+        return true;
+    }
+    note.tags.push_back(tag_name);
+    return writeNote(note);
+}
+
+bool FileStorage::removeTag(int note_id, const std::string& tag_name) {
+    StoredNote note;
+    if (!readNote(note_id, note)) {
+        return false;
+    }
+    auto tag = std::find(note.tags.begin(), note.tags.end(), tag_name);
+    if (tag == note.tags.end()) {
+        return true;
+    }
+    note.tags.erase(tag);
+    return writeNote(note);
+}
+
+// --- Folders ---
+
+bool FileStorage::putFolder(const StoredFolder& folder) {
+    std::error_code ec;
+    auto it = folders.find(folder.id);
+    if (it == folders.end()) {
+        folders[folder.id] = folder;
+        const std::string path = folderPath(folder.id);
+        fs::create_directories(path, ec);
+        return !path.empty() && !ec;
+    }
+    // A rename or a move (into the trash included) is one directory rename: the paths of
+    // everything below it follow from the folder tree.
+    const std::string old_path = folderPath(folder.id);
+    it->second = folder;
+    const std::string new_path = folderPath(folder.id);
+    if (new_path.empty()) {
+        return false;
+    }
+    if (old_path == new_path) {
+        return true;
+    }
+    fs::create_directories(fs::path(new_path).parent_path(), ec);
+    if (old_path.empty() || !fs::exists(old_path, ec)) {
+        fs::create_directories(new_path, ec);
+        return !ec;
+    }
+    fs::rename(old_path, new_path, ec);
+    return !ec;
+}
+
+bool FileStorage::removeFolder(int folder_id) {
+    const std::string path = folderPath(folder_id);
+    std::error_code ec;
+    if (!path.empty()) {
+        fs::remove_all(path, ec);
+    }
+    // Forget the folder, its subfolders and their notes: their files went with the directory.
+    std::vector<int> removed{folder_id};
+    for (size_t i = 0; i < removed.size(); ++i) {
+        for (const auto& entry : folders) {
+            if (entry.second.parent_id == removed[i]) removed.push_back(entry.first);
+        }
+    }
+    for (int id : removed) {
+        folders.erase(id);
+    }
+    for (auto it = note_folders.begin(); it != note_folders.end();) {
+        if (std::find(removed.begin(), removed.end(), it->second) != removed.end()) {
+            it = note_folders.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return !ec;
+}
+
+bool FileStorage::sync() {
+    return true;
+}
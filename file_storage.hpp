@@ -0,0 +1,92 @@
+/**
+ * @file file_storage.hpp
+ * @brief This file contains the storage engine for the one-text-file-per-note layout.
+ */
+
+#ifndef FILE_STORAGE_HPP
+#define FILE_STORAGE_HPP
+
+#include "storage_backend.hpp"
+
+#include <string>
+#include <unordered_map>
+
+/**
+ * @class FileStorage
+ * @brief Writes mutations to the directory layout read by initializeFromFileSystem.
+ *
+ * Every folder is a directory under the active or the trash root, and every
+ * note is a "<id>.txt" file in its folder's directory: a header block
+ * (Title, Created, Modified, Tags, ID) followed by an empty line and the body.
+ * Files are replaced by writing a temporary file and renaming it over the old
+ * one, so a reader never sees half a note.
+ *
+ * The layout is loaded by the directory walk, not by replay(), so the backend
+ * starts empty: register the loaded folders and notes before the first
+ * mutation. Directory paths are derived from the registered folder tree, which
+ * is why renaming or moving a folder is a single directory rename.
+ */
+class FileStorage : public StorageBackend {
+public:
+    /**
+     * @brief Constructs a FileStorage. Nothing is touched until open().
+     * @param base_path The directory of the root folder.
+     * @param trash_path The directory of the trash folder.
+     * @param trash_folder_id The ID the trash folder is referred to by.
+     */
+    FileStorage(const std::string& base_path, const std::string& trash_path, int trash_folder_id);
+
+    /**
+     * @brief Records a folder that already exists on disk.
+     * @param folder The folder state. A parent ID of 0 means the root folder.
+     */
+    void registerFolder(const StoredFolder& folder);
+
+    /**
+     * @brief Records a note file that already exists on disk.
+     * @param note_id The ID of the note.
+     * @param folder_id The ID of its folder, 0 for the root folder.
+     */
+    void registerNote(int note_id, int folder_id);
+
+    /**
+     * @brief Creates the root and trash directories.
+     * @return True if both exist, false otherwise.
+     */
+    bool open() override;
+
+    /**
+     * @brief Not supported: the layout is loaded by the directory walk.
+     * @return Always false.
+     */
+    bool replay(const std::function<void(const StoredFolder&)>& on_folder,
+                const std::function<void(StoredNote&&)>& on_note) override;
+
+    bool putNote(const StoredNote& note) override;
+    bool removeNote(int note_id) override;
+    bool moveNote(int note_id, int folder_id, bool in_trash) override;
+    bool addTag(int note_id, const std::string& tag_name) override;
+    bool removeTag(int note_id, const std::string& tag_name) override;
+    bool putFolder(const StoredFolder& folder) override;
+    bool removeFolder(int folder_id) override;
+
+    /**
+     * @brief Every mutation is written when it is made, so there is nothing left to do.
+     * @return Always true.
+     */
+    bool sync() override;
+
+private:
+    std::string folderPath(int folder_id) const;
+    std::string notePath(int note_id, int folder_id) const;
+    bool writeNote(const StoredNote& note);
+    bool readNote(int note_id, StoredNote& note) const;
+
+    std::string base_path;
+    std::string trash_path;
+    int trash_folder_id;
+    std::unordered_map<int, StoredFolder> folders; // Folder ID -> its state, for the path of its directory
+    std::unordered_map<int, int> note_folders;     // Note ID -> the folder its file is in
+};
+
+#endif // FILE_STORAGE_HPP
@@ -0,0 +1,225 @@
+/**
+ * @file folder_tree_model.cpp
+ * @brief Implementation of the FolderTreeModel class.
+ */
+
+#include "folder_tree_model.hpp"
+
+#include <algorithm>
+
+FolderTreeModel::FolderTreeModel(QObject* parent) : QAbstractItemModel(parent) {}
+
+FolderTreeModel::~FolderTreeModel() {
+    detachAll();
+}
+
+void FolderTreeModel::detachAll() {
+    for (const auto& entry : rows) {
+        entry.first->removeObserver(this);
+    }
+    rows.clear();
+    fetched.clear();
+}
+
+bool FolderTreeModel::isRoot(const Folder* folder) const {
+    auto it = rows.find(const_cast<Folder*>(folder));
+    return it != rows.end() && it->second < roots.size() && roots[it->second].get() == folder;
+}
+
+void FolderTreeModel::observe(Folder* folder, size_t row) {
+    if (rows.emplace(folder, row).second) {
+        folder->addObserver(this);
+    }
+}
+
+void FolderTreeModel::renumberChildren(const Folder& folder, size_t from) {
+    const auto& subfolders = folder.getSubfolderList();
+    for (size_t row = from; row < subfolders.size(); ++row) {
+        auto it = rows.find(subfolders[row].get());
+        if (it != rows.end() && !isRoot(it->first)) {
+            it->second = row;
+        }
+    }
+}
+
+void FolderTreeModel::forgetSubtree(Folder* folder) {
+    if (rows.erase(folder) != 0) {
+        folder->removeObserver(this);
+    }
+    // Only fetched folders have exposed, observed children.
+    if (fetched.erase(folder) != 0) {
+        for (const auto& subfolder : folder->getSubfolderList()) {
+            forgetSubtree(subfolder.get());
+        }
+    }
+}
+
+void FolderTreeModel::setRootFolders(std::vector<std::shared_ptr<Folder>> folders) {
+    beginResetModel();
+    detachAll();
+    roots = std::move(folders);
+    roots.erase(std::remove(roots.begin(), roots.end(), nullptr), roots.end());
+    for (size_t row = 0; row < roots.size(); ++row) {
+        observe(roots[row].get(), row);
+    }
+    endResetModel();
+}
+
+Folder* FolderTreeModel::folderFromIndex(const QModelIndex& index) const {
+    return index.isValid() ? static_cast<Folder*>(index.internalPointer()) : nullptr;
+}
+
+std::shared_ptr<Folder> FolderTreeModel::folderAt(const QModelIndex& index) const {
+    Folder* folder = folderFromIndex(index);
+    return folder ? folder->shared_from_this() : nullptr;
+}
+
+QModelIndex FolderTreeModel::indexOfFolder(const Folder* folder) const {
+    auto it = rows.find(const_cast<Folder*>(folder));
+    if (it == rows.end()) {
+        return QModelIndex();
+    }
+    return createIndex(static_cast<int>(it->second), 0, it->first);
+}
+
+// --- QAbstractItemModel ---
+
+QModelIndex FolderTreeModel::index(int row, int column, const QModelIndex& parent) const {
+    if (column != 0 || row < 0 || row >= rowCount(parent)) {
+        return QModelIndex();
+    }
+    if (!parent.isValid()) {
+        return createIndex(row, 0, roots[static_cast<size_t>(row)].get());
+    }
+    return createIndex(row, 0, folderFromIndex(parent)->getSubfolderList()[static_cast<size_t>(row)].get());
+}
+
+QModelIndex FolderTreeModel::parent(const QModelIndex& child) const {
+    Folder* folder = folderFromIndex(child);
+    if (!folder || isRoot(folder)) {
+        return QModelIndex();
+    }
+    return indexOfFolder(folder->getParent().get());
+}
+
+int FolderTreeModel::rowCount(const QModelIndex& parent) const {
+    if (!parent.isValid()) {
+        return static_cast<int>(roots.size());
+    }
+    Folder* folder = folderFromIndex(parent);
+    return isFetched(folder) ? static_cast<int>(folder->getSubfolderList().size()) : 0;
+}
+
+int FolderTreeModel::columnCount(const QModelIndex&) const {
+    return 1;
+}
+
+QVariant FolderTreeModel::data(const QModelIndex& index, int role) const {
+    Folder* folder = folderFromIndex(index);
+    if (!folder) {
+        return QVariant();
+    }
+    switch (role) {
+        case Qt::DisplayRole: {
+            const std::string_view name = folder->getNameView();
+            return QStringLiteral("%1 (%2)")
+                .arg(QString::fromUtf8(name.data(), static_cast<int>(name.size())))
+                .arg(static_cast<qulonglong>(folder->getTotalNoteCountRecursive()));
+        }
+        case FolderIdRole:
+            return folder->getId();
+        case TotalNoteCountRole:
+            return static_cast<qulonglong>(folder->getTotalNoteCountRecursive());
+        default:
+            return QVariant();
+    }
+}
+
+bool FolderTreeModel::hasChildren(const QModelIndex& parent) const {
+    if (!parent.isValid()) {
+        return !roots.empty();
+    }
+    return !folderFromIndex(parent)->getSubfolderList().empty();
+}
+
+bool FolderTreeModel::canFetchMore(const QModelIndex& parent) const {
+    Folder* folder = folderFromIndex(parent);
+    return folder && !isFetched(folder) && !folder->getSubfolderList().empty();
+}
+
+void FolderTreeModel::fetchMore(const QModelIndex& parent) {
+    Folder* folder = folderFromIndex(parent);
+    if (!folder || isFetched(folder)) {
+        return;
+    }
+    const auto& subfolders = folder->getSubfolderList();
+    if (subfolders.empty()) {
+        fetched.insert(folder);
+        return;
+    }
+    beginInsertRows(parent, 0, static_cast<int>(subfolders.size()) - 1);
+    fetched.insert(folder);
+    for (size_t row = 0; row < subfolders.size(); ++row) {
+        observe(subfolders[row].get(), row);
+    }
+    endInsertRows();
+}
+
+// --- FolderObserver ---
+
+void FolderTreeModel::subfolderAboutToBeAdded(const Folder& folder, size_t row) {
+    if (!isFetched(&folder)) {
+        if (!folder.getSubfolderList().empty()) {
+            return; // Still collapsed; the new child shows up when the folder is fetched
+        }
+        fetched.insert(&folder); // An empty folder has nothing to fetch
+    }
+    QModelIndex parent = indexOfFolder(&folder);
+    if (!parent.isValid()) {
+        return;
+    }
+    beginInsertRows(parent, static_cast<int>(row), static_cast<int>(row));
+    inserting = true;
+}
+
+void FolderTreeModel::subfolderAdded(const Folder& folder, size_t row) {
+    if (!inserting) {
+        return;
+    }
+    observe(folder.getSubfolderList()[row].get(), row);
+    renumberChildren(folder, row + 1);
+    inserting = false;
+    endInsertRows();
+}
+
+void FolderTreeModel::subfolderAboutToBeRemoved(const Folder& folder, size_t row) {
+    Folder* subfolder = folder.getSubfolderList()[row].get();
+    if (!isFetched(&folder)) {
+        forgetSubtree(subfolder);
+        return;
+    }
+    QModelIndex parent = indexOfFolder(&folder);
+    if (!parent.isValid()) {
+        forgetSubtree(subfolder);
+        return;
+    }
+    beginRemoveRows(parent, static_cast<int>(row), static_cast<int>(row));
+    removing = true;
+    forgetSubtree(subfolder);
+}
+
+void FolderTreeModel::subfolderRemoved(const Folder& folder, size_t row) {
+    if (!removing) {
+        return;
+    }
+    renumberChildren(folder, row);
+    removing = false;
+    endRemoveRows();
+}
+
+void FolderTreeModel::folderChanged(const Folder& folder) {
+    QModelIndex changed = indexOfFolder(&folder);
+    if (changed.isValid()) {
+        emit dataChanged(changed, changed, {Qt::DisplayRole, TotalNoteCountRole});
+    }
+}
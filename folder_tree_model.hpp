@@ -0,0 +1,113 @@
+/**
+ * @file folder_tree_model.hpp
+ * @brief This file contains the declaration of the FolderTreeModel class.
+ */
+
+#ifndef FOLDER_TREE_MODEL_HPP
+#define FOLDER_TREE_MODEL_HPP
+
+#include <QAbstractItemModel>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "notes.hpp"
+
+/**
+ * @class FolderTreeModel
+ * @brief A tree model over the Folder hierarchy that exposes children only when a node is expanded.
+ *
+ * Rows are read straight from Folder::getSubfolderList(); an index carries a
+ * pointer to its Folder. A folder's children stay hidden (rowCount 0,
+ * canFetchMore true) until the view expands it and calls fetchMore, so
+ * opening the window touches only the top level however deep the tree is.
+ * The model observes every folder it shows, turning subfolder insertions and
+ * removals into row signals and renames or note-count changes into
+ * dataChanged. It also keeps the row of every folder it shows, renumbering
+ * the later siblings on an insertion or removal, so parent() and
+ * indexOfFolder() never search a sibling list. Counts come from
+ * Folder::getTotalNoteCountRecursive(), which is maintained incrementally.
+ */
+class FolderTreeModel : public QAbstractItemModel, public FolderObserver {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Extra item data roles.
+     */
+    enum Role {
+        FolderIdRole = Qt::UserRole + 1, ///< The folder ID, as an int.
+        TotalNoteCountRole               ///< The number of notes in the folder's subtree.
+    };
+
+    /**
+     * @brief Constructs an empty FolderTreeModel.
+     * @param parent The parent object.
+     */
+    explicit FolderTreeModel(QObject* parent = nullptr);
+
+    /**
+     * @brief Detaches the model from every observed folder.
+     */
+    ~FolderTreeModel() override;
+
+    /**
+     * @brief Sets the folders shown at the top level and collapses everything.
+     * @param folders The top-level folders, e.g. the root and trash folders.
+     */
+    void setRootFolders(std::vector<std::shared_ptr<Folder>> folders);
+
+    /**
+     * @brief Gets the folders shown at the top level.
+     * @return The top-level folders.
+     */
+    const std::vector<std::shared_ptr<Folder>>& rootFolders() const { return roots; }
+
+    /**
+     * @brief Gets the folder shown at an index.
+     * @param index A model index.
+     * @return The folder, or nullptr if the index is invalid.
+     */
+    std::shared_ptr<Folder> folderAt(const QModelIndex& index) const;
+
+    /**
+     * @brief Finds the index showing a folder.
+     * @param folder The folder.
+     * @return The index, or an invalid index if the folder is not currently exposed.
+     */
+    QModelIndex indexOfFolder(const Folder* folder) const;
+
+    // --- QAbstractItemModel ---
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    // --- FolderObserver ---
+    void subfolderAboutToBeAdded(const Folder& folder, size_t row) override;
+    void subfolderAdded(const Folder& folder, size_t row) override;
+    void subfolderAboutToBeRemoved(const Folder& folder, size_t row) override;
+    void subfolderRemoved(const Folder& folder, size_t row) override;
+    void folderChanged(const Folder& folder) override;
+
+private:
+    Folder* folderFromIndex(const QModelIndex& index) const;
+    bool isFetched(const Folder* folder) const { return fetched.count(folder) != 0; }
+    bool isRoot(const Folder* folder) const;
+    void observe(Folder* folder, size_t row);
+    void renumberChildren(const Folder& folder, size_t from);
+    void forgetSubtree(Folder* folder);
+    void detachAll();
+
+    std::vector<std::shared_ptr<Folder>> roots;
+    std::unordered_set<const Folder*> fetched; // Folders whose children are exposed
+    std::unordered_map<Folder*, size_t> rows;  // Every exposed, and so observed, folder -> its row
+    bool inserting = false;                    // A beginInsertRows is waiting for its end
+    bool removing = false;                     // A beginRemoveRows is waiting for its end
+};
+
+#endif // FOLDER_TREE_MODEL_HPP
@@ -0,0 +1,230 @@
+/**
+ * @file id_index.hpp
+ * @brief This file contains the open-addressing hash map used to index notes and folders by ID.
+ */
+
+#ifndef ID_INDEX_HPP
+#define ID_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @class IdHashMap
+ * @brief A hash map from integer IDs to values with linear probing and backward-shift deletion.
+ *
+ * All entries live in one contiguous array, so a lookup is a hash, a mask and
+ * usually a single cache miss. Deletion shifts the following entries of the
+ * probe run back instead of leaving tombstones, which keeps lookups fast under
+ * churn. The interface mirrors the parts of std::map used by NoteManager;
+ * iteration order is unspecified.
+ *
+ * @tparam V The mapped type.
+ */
+template <typename V>
+class IdHashMap {
+public:
+    using value_type = std::pair<int, V>;
+
+private:
+    struct Slot {
+        bool occupied = false;
+        value_type entry;
+    };
+
+    template <typename SlotPtr, typename Ref, typename Ptr>
+    class basic_iterator {
+        friend class IdHashMap;
+    public:
+        basic_iterator() = default;
+        basic_iterator(SlotPtr slot, SlotPtr end) : slot(slot), end(end) { skip(); }
+        template <typename S, typename R, typename P>
+        basic_iterator(const basic_iterator<S, R, P>& other) : slot(other.slot), end(other.end) {}
+
+        Ref operator*() const { return slot->entry; }
+        Ptr operator->() const { return &slot->entry; }
+        basic_iterator& operator++() {
+            ++slot;
+            skip();
+            return *this;
+        }
+        bool operator==(const basic_iterator& other) const { return slot == other.slot; }
+        bool operator!=(const basic_iterator& other) const { return slot != other.slot; }
+
+    private:
+        template <typename, typename, typename> friend class basic_iterator;
+        void skip() {
+            while (slot != end && !slot->occupied) ++slot;
+        }
+        SlotPtr slot = nullptr;
+        SlotPtr end = nullptr;
+    };
+
+public:
+    using iterator = basic_iterator<Slot*, value_type&, value_type*>;
+    using const_iterator = basic_iterator<const Slot*, const value_type&, const value_type*>;
+
+    IdHashMap() = default;
+
+    iterator begin() { return iterator(slots.data(), slots.data() + slots.size()); }
+    iterator end() { return iterator(slots.data() + slots.size(), slots.data() + slots.size()); }
+    const_iterator begin() const { return const_iterator(slots.data(), slots.data() + slots.size()); }
+    const_iterator end() const { return const_iterator(slots.data() + slots.size(), slots.data() + slots.size()); }
+
+    size_t size() const { return entry_count; }
+    bool empty() const { return entry_count == 0; }
+
+    /**
+     * @brief Removes every entry and releases the table.
+     */
+    void clear() {
+        slots.clear();
+        entry_count = 0;
+        shift = 64;
+    }
+
+    /**
+     * @brief Grows the table so that at least n entries fit without rehashing.
+     * @param n The expected number of entries.
+     */
+    void reserve(size_t n) {
+        size_t wanted = MIN_CAPACITY;
+        while (wanted * MAX_LOAD_NUM < n * MAX_LOAD_DEN) wanted *= 2;
+        if (wanted > slots.size()) rehash(wanted);
+    }
+
+    iterator find(int key) {
+        size_t index = locate(key);
+        return index == NOT_FOUND ? end() : iterator(slots.data() + index, slots.data() + slots.size());
+    }
+
+    const_iterator find(int key) const {
+        size_t index = locate(key);
+        return index == NOT_FOUND ? end() : const_iterator(slots.data() + index, slots.data() + slots.size());
+    }
+
+    size_t count(int key) const { return locate(key) == NOT_FOUND ? 0 : 1; }
+
+    /**
+     * @brief Gets the value for a key, inserting a default-constructed value if it is missing.
+     * @param key The ID.
+     * @return A reference to the mapped value.
+     */
+    V& operator[](int key) {
+        return insertSlot(key).entry.second;
+    }
+
+    /**
+     * @brief Inserts a value if the key is not present yet.
+     * @param key The ID.
+     * @param value The value to insert.
+     * @return The entry's iterator and whether the insertion took place.
+     */
+    std::pair<iterator, bool> emplace(int key, V value) {
+        size_t before = entry_count;
+        Slot& slot = insertSlot(key);
+        bool inserted = entry_count != before;
+        if (inserted) slot.entry.second = std::move(value);
+        return {iterator(&slot, slots.data() + slots.size()), inserted};
+    }
+
+    /**
+     * @brief Removes a key.
+     * @param key The ID to remove.
+     * @return The number of removed entries (0 or 1).
+     */
+    size_t erase(int key) {
+        size_t index = locate(key);
+        if (index == NOT_FOUND) return 0;
+        eraseAt(index);
+        return 1;
+    }
+
+    /**
+     * @brief Removes the entry at an iterator.
+     * @param it A valid iterator.
+     * Entries after it may be shifted back, so other iterators are invalidated.
+     */
+    void erase(const_iterator it) {
+        eraseAt(static_cast<size_t>(it.slot - slots.data()));
+    }
+
+private:
+    static constexpr size_t MIN_CAPACITY = 16;
+    static constexpr size_t MAX_LOAD_NUM = 7; // Maximum load factor 7/10
+    static constexpr size_t MAX_LOAD_DEN = 10;
+    static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+    /**
+     * @brief Fibonacci hashing: the top bits of the product spread the sequential IDs NoteManager hands out.
+     */
+    size_t home(int key) const {
+        return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(key)) * 0x9E3779B97F4A7C15ULL) >> shift);
+    }
+
+    size_t mask() const { return slots.size() - 1; }
+
+    size_t locate(int key) const {
+        if (slots.empty()) return NOT_FOUND;
+        for (size_t index = home(key);; index = (index + 1) & mask()) {
+            const Slot& slot = slots[index];
+            if (!slot.occupied) return NOT_FOUND;
+            if (slot.entry.first == key) return index;
+        }
+    }
+
+    Slot& insertSlot(int key) {
+        size_t existing = locate(key);
+        if (existing != NOT_FOUND) return slots[existing];
+        if ((entry_count + 1) * MAX_LOAD_DEN > slots.size() * MAX_LOAD_NUM) {
+            rehash(slots.empty() ? MIN_CAPACITY : slots.size() * 2);
+        }
+        size_t index = home(key);
+        while (slots[index].occupied) index = (index + 1) & mask();
+        Slot& slot = slots[index];
+        slot.occupied = true;
+        slot.entry.first = key;
+        slot.entry.second = V();
+        ++entry_count;
+        return slot;
+    }
+
+    void eraseAt(size_t index) {
+        // Backward-shift deletion: pull later entries of the probe run into the hole.
+        size_t hole = index;
+        for (size_t next = (hole + 1) & mask(); slots[next].occupied; next = (next + 1) & mask()) {
+            size_t ideal = home(slots[next].entry.first);
+            // Move the entry only if its home slot is not cyclically within (hole, next].
+            bool stays = hole <= next ? (hole < ideal && ideal <= next) : (hole < ideal || ideal <= next);
+            if (!stays) {
+                slots[hole].entry = std::move(slots[next].entry);
+                hole = next;
+            }
+        }
+        slots[hole].occupied = false;
+        slots[hole].entry.second = V();
+        --entry_count;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old(capacity);
+        old.swap(slots);
+        shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) --shift;
+        for (Slot& slot : old) {
+            if (!slot.occupied) continue;
+            size_t index = home(slot.entry.first);
+            while (slots[index].occupied) index = (index + 1) & mask();
+            slots[index].occupied = true;
+            slots[index].entry = std::move(slot.entry);
+        }
+    }
+
+    std::vector<Slot> slots;
+    size_t entry_count = 0;
+    unsigned shift = 64; // 64 - log2(capacity)
+};
+
+#endif // ID_INDEX_HPP
@@ -0,0 +1,640 @@
+/**
+ * @file journal_storage.cpp
+ * @brief Implementation of the JournalStorage class.
+ */
+
+#include "journal_storage.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char JOURNAL_MAGIC[4] = {'N', 'J', 'R', 'N'};
+const uint32_t JOURNAL_FORMAT_VERSION = 1;
+const uint64_t HEADER_SIZE = 8;                  // Magic + version
+const uint64_t FRAME_SIZE = 9;                   // Length + CRC + type
+const uint32_t MAX_RECORD_SIZE = 1u << 30;       // Anything larger is treated as corruption
+const uint64_t COMPACTION_MIN_BYTES = 1u << 20;  // Small journals are never compacted
+
+uint32_t crc32(uint8_t type, const std::string& payload) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    uint32_t crc = 0xFFFFFFFFu;
+    crc = table[(crc ^ type) & 0xFF] ^ (crc >> 8);
+    for (unsigned char c : payload) {
+        crc = table[(crc ^ c) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+uint32_t getU32(const char* data) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+void putString(std::string& out, const std::string& value) {
+    putVarint(out, value.size());
+    out += value;
+}
+
+void putTime(std::string& out, time_t value) {
+    uint64_t bits = static_cast<uint64_t>(static_cast<int64_t>(value));
+    for (int i = 0; i < 8; ++i) {
+        out += static_cast<char>((bits >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * @brief Bounds-checked decoder over a record payload.
+ */
+class PayloadReader {
+public:
+    explicit PayloadReader(const std::string& payload) : data(payload) {}
+
+    bool varint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < data.size(); shift += 7) {
+            unsigned char c = static_cast<unsigned char>(data[pos++]);
+            value |= static_cast<uint64_t>(c & 0x7F) << shift;
+            if ((c & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    bool integer(int& value) {
+        uint64_t raw = 0;
+        if (!varint(raw)) return false;
+        value = static_cast<int>(raw);
+        return true;
+    }
+
+    bool string(std::string& value) {
+        uint64_t size = 0;
+        if (!varint(size) || size > data.size() - pos) return false;
+        value.assign(data, pos, size);
+        pos += size;
+        return true;
+    }
+
+    bool time(time_t& value) {
+        if (data.size() - pos < 8) return false;
+        uint64_t bits = 0;
+        for (int i = 0; i < 8; ++i) {
+            bits |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos++])) << (8 * i);
+        }
+        value = static_cast<time_t>(static_cast<int64_t>(bits));
+        return true;
+    }
+
+    bool flag(bool& value) {
+        if (pos >= data.size()) return false;
+        value = data[pos++] != 0;
+        return true;
+    }
+
+    bool atEnd() const { return pos == data.size(); }
+
+private:
+    const std::string& data;
+    size_t pos = 0;
+};
+
+std::string encodeNote(const StoredNote& note) {
+    std::string out;
+    out.reserve(note.title.size() + note.content.size() + 32);
+    putVarint(out, static_cast<uint32_t>(note.id));
+    putVarint(out, static_cast<uint32_t>(note.folder_id));
+    putString(out, note.title);
+    putString(out, note.content);
+    putVarint(out, note.tags.size());
+    for (const auto& tag : note.tags) {
+        putString(out, tag);
+    }
+    putTime(out, note.creation_date);
+    putTime(out, note.last_modified_date);
+    out += static_cast<char>(note.in_trash ? 1 : 0);
+    return out;
+}
+
+bool decodeNote(const std::string& payload, StoredNote& note) {
+    PayloadReader in(payload);
+    uint64_t tag_count = 0;
+    if (!in.integer(note.id) || !in.integer(note.folder_id) || !in.string(note.title) || !in.string(note.content) ||
+        !in.varint(tag_count)) {
+        return false;
+    }
+    note.tags.clear();
+    for (uint64_t i = 0; i < tag_count; ++i) {
+        std::string tag;
+        if (!in.string(tag)) return false;
+        note.tags.push_back(std::move(tag));
+    }
+    return in.time(note.creation_date) && in.time(note.last_modified_date) && in.flag(note.in_trash) && in.atEnd();
+}
+
+std::string encodeFolder(const StoredFolder& folder) {
+    std::string out;
+    putVarint(out, static_cast<uint32_t>(folder.id));
+    putVarint(out, static_cast<uint32_t>(folder.parent_id));
+    putString(out, folder.name);
+    out += static_cast<char>(folder.in_trash ? 1 : 0);
+    return out;
+}
+
+bool decodeFolder(const std::string& payload, StoredFolder& folder) {
+    PayloadReader in(payload);
+    return in.integer(folder.id) && in.integer(folder.parent_id) && in.string(folder.name) &&
+           in.flag(folder.in_trash) && in.atEnd();
+}
+
+std::string frame(uint8_t type, const std::string& payload) {
+    std::string out;
+    out.reserve(FRAME_SIZE + payload.size());
+    putU32(out, static_cast<uint32_t>(payload.size()));
+    putU32(out, crc32(type, payload));
+    out += static_cast<char>(type);
+    out += payload;
+    return out;
+}
+
+std::string header() {
+    std::string out(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    putU32(out, JOURNAL_FORMAT_VERSION);
+    return out;
+}
+
+bool syncFile(std::FILE* f) {
+    if (std::fflush(f) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(f)) == 0;
+#else
+    return ::fsync(fileno(f)) == 0;
+#endif
+}
+
+/**
+ * @brief The outcome of reading one frame.
+ */
+enum class FrameStatus {
+    Valid,
+    Torn,   ///< The frame runs past the end of the file, or is damaged and nothing follows it
+    Corrupt ///< The frame is damaged and more data follows it
+};
+
+/**
+ * @brief Checks whether a complete frame with a matching checksum starts anywhere in the rest of the stream.
+ * Only used to tell a damaged length field from a torn tail, so its cost does not matter.
+ */
+bool validFrameFollows(std::istream& in) {
+    const std::string rest((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    for (size_t at = 0; at + FRAME_SIZE <= rest.size(); ++at) {
+        const uint32_t length = getU32(rest.data() + at);
+        if (length > rest.size() - at - FRAME_SIZE) continue;
+        const uint8_t type = static_cast<uint8_t>(rest[at + 8]);
+        if (crc32(type, rest.substr(at + FRAME_SIZE, length)) == getU32(rest.data() + at + 4)) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Reads the frame at the stream's position, which is `offset` bytes into a file of `file_size` bytes.
+ */
+FrameStatus readFrame(std::istream& in, uint64_t offset, uint64_t file_size, uint8_t& type, std::string& payload) {
+    char frame_header[FRAME_SIZE];
+    if (file_size - offset < FRAME_SIZE || !in.read(frame_header, sizeof(frame_header))) return FrameStatus::Torn;
+    uint32_t length = getU32(frame_header);
+    uint32_t checksum = getU32(frame_header + 4);
+    type = static_cast<uint8_t>(frame_header[8]);
+    if (length > MAX_RECORD_SIZE) return FrameStatus::Corrupt;
+    const uint64_t frame_end = offset + FRAME_SIZE + length;
+    if (frame_end > file_size) {
+        // An interrupted append leaves a prefix of its record and nothing after it. A damaged length
+        // field runs past the end as well, but the records it swallowed are still there to be found.
+        return validFrameFollows(in) ? FrameStatus::Corrupt : FrameStatus::Torn;
+    }
+    payload.resize(length);
+    if (length > 0 && !in.read(&payload[0], length)) return FrameStatus::Torn;
+    if (crc32(type, payload) == checksum) return FrameStatus::Valid;
+    return frame_end == file_size ? FrameStatus::Torn : FrameStatus::Corrupt;
+}
+
+} // namespace
+
+JournalStorage::JournalStorage(const std::string& file_path, SyncMode mode) : path(file_path), sync_mode(mode) {}
+
+JournalStorage::~JournalStorage() {
+    if (file) {
+        syncFile(file);
+        std::fclose(file);
+    }
+}
+
+bool JournalStorage::open() {
+    TRACE_SCOPE("storage.open");
+    error.clear();
+    notes.clear();
+    folders.clear();
+    live_bytes = 0;
+    recovered_bytes = 0;
+
+    std::error_code ec;
+    uint64_t on_disk = std::filesystem::exists(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+    if (ec) return false;
+
+    if (on_disk < HEADER_SIZE) {
+        // New journal, or a crash before the header was complete.
+        std::FILE* created = std::fopen(path.c_str(), "wb");
+        if (!created) return false;
+        std::string h = header();
+        bool ok = std::fwrite(h.data(), 1, h.size(), created) == h.size() && syncFile(created);
+        std::fclose(created);
+        if (!ok) return false;
+        NOTES_COUNT("storage.bytes_written", h.size());
+        file_size = HEADER_SIZE;
+    } else {
+        std::ifstream in(path, std::ios::binary);
+        char file_header[HEADER_SIZE];
+        if (!in.read(file_header, sizeof(file_header)) || std::string(file_header, HEADER_SIZE) != header()) {
+            return false; // Not a journal we understand; never overwrite it
+        }
+
+        uint64_t good_offset = HEADER_SIZE;
+        uint8_t type = 0;
+        std::string payload;
+        FrameStatus status = FrameStatus::Valid;
+        while (good_offset < on_disk &&
+               (status = readFrame(in, good_offset, on_disk, type, payload)) == FrameStatus::Valid) {
+            uint32_t size = static_cast<uint32_t>(FRAME_SIZE + payload.size());
+            if (!apply(static_cast<RecordType>(type), payload, good_offset, size)) {
+                // The checksum matched, so this is a record we cannot read rather than a torn write.
+                status = FrameStatus::Corrupt;
+                break;
+            }
+            good_offset += size;
+        }
+        in.close();
+        NOTES_COUNT("storage.bytes_read", good_offset);
+
+        if (status == FrameStatus::Corrupt) {
+            // Truncating here would drop every valid record after the damage; leave the file for recovery.
+            error = "Journal '" + path + "' is damaged at offset " + std::to_string(good_offset) + " with " +
+                    std::to_string(on_disk - good_offset) + " bytes after it; it was left untouched.";
+            notes.clear();
+            folders.clear();
+            live_bytes = 0;
+            return false;
+        }
+        if (good_offset < on_disk) {
+            recovered_bytes = on_disk - good_offset;
+            std::filesystem::resize_file(path, good_offset, ec);
+            if (ec) return false;
+        }
+        file_size = good_offset;
+    }
+
+    file = std::fopen(path.c_str(), "ab");
+    if (!file) return false;
+    maybeCompact();
+    return true;
+}
+
+bool JournalStorage::replay(const std::function<void(const StoredFolder&)>& on_folder,
+                            const std::function<void(StoredNote&&)>& on_note) {
+    for (const auto& entry : folders) {
+        on_folder(entry.second.first);
+    }
+    for (auto& entry : notes) {
+        StoredNote note = entry.second.note;
+        if (entry.second.content_loaded) {
+            note.content = std::move(entry.second.note.content);
+            entry.second.note.content.clear();
+            entry.second.content_loaded = false;
+        } else if (!readNoteContent(entry.second, note.content)) {
+            return false;
+        }
+        on_note(std::move(note));
+    }
+    return true;
+}
+
+bool JournalStorage::putNote(const StoredNote& note) {
+    TRACE_SCOPE("storage.put_note");
+    uint64_t offset = 0;
+    uint32_t size = 0;
+    std::string payload = encodeNote(note);
+    if (!append(RecordType::NoteUpsert, payload, &offset, &size)) return false;
+    NoteEntry& entry = notes[note.id];
+    if (entry.upsert_size != 0) live_bytes -= entry.upsert_size;
+    entry.note = note;
+    entry.note.content.clear(); // The caller owns the content; reread it from disk when needed
+    entry.upsert_offset = offset;
+    entry.upsert_size = size;
+    entry.content_loaded = false;
+    live_bytes += size;
+    maybeCompact();
+    return true;
+}
+
+bool JournalStorage::removeNote(int note_id) {
+    std::string payload;
+    putVarint(payload, static_cast<uint32_t>(note_id));
+    if (!append(RecordType::NoteDelete, payload)) return false;
+    apply(RecordType::NoteDelete, payload, 0, 0);
+    maybeCompact();
+    return true;
+}
+
+bool JournalStorage::moveNote(int note_id, int folder_id, bool in_trash) {
+    std::string payload;
+    putVarint(payload, static_cast<uint32_t>(note_id));
+    putVarint(payload, static_cast<uint32_t>(folder_id));
+    payload += static_cast<char>(in_trash ? 1 : 0);
+    if (!append(RecordType::NoteMove, payload)) return false;
+    apply(RecordType::NoteMove, payload, 0, 0);
+    maybeCompact();
+    return true;
+}
+
+bool JournalStorage::addTag(int note_id, const std::string& tag_name) {
+    std::string payload;
+    putVarint(payload, static_cast<uint32_t>(note_id));
+    putString(payload, tag_name);
+    if (!append(RecordType::TagAdd, payload)) return false;
+    apply(RecordType::TagAdd, payload, 0, 0);
+    maybeCompact();
+    return true;
+}
+
+bool JournalStorage::removeTag(int note_id, const std::string& tag_name) {
+    std::string payload;
+    putVarint(payload, static_cast<uint32_t>(note_id));
+    putString(payload, tag_name);
+    if (!append(RecordType::TagRemove, payload)) return false;
+    apply(RecordType::TagRemove, payload, 0, 0);
+    maybeCompact();
+    return true;
+}
+
+bool JournalStorage::putFolder(const StoredFolder& folder) {
+    uint64_t offset = 0;
+    uint32_t size = 0;
+    std::string payload = encodeFolder(folder);
+    if (!append(RecordType::FolderUpsert, payload, &offset, &size)) return false;
+    apply(RecordType::FolderUpsert, payload, offset, size);
+    maybeCompact();
+    return true;
+}
+
+bool JournalStorage::removeFolder(int folder_id) {
+    std::string payload;
+    putVarint(payload, static_cast<uint32_t>(folder_id));
+    if (!append(RecordType::FolderDelete, payload)) return false;
+    apply(RecordType::FolderDelete, payload, 0, 0);
+    maybeCompact();
+    return true;
+}
+
+bool JournalStorage::sync() {
+    NOTES_TIME_OPERATION("storage.sync");
+    return file && syncFile(file);
+}
+
+bool JournalStorage::append(RecordType type, const std::string& payload, uint64_t* offset, uint32_t* size) {
+    if (!file) return false;
+    std::string record = frame(static_cast<uint8_t>(type), payload);
+    if (std::fwrite(record.data(), 1, record.size(), file) != record.size()) return false;
+    NOTES_COUNT("storage.bytes_written", record.size());
+    if (sync_mode == SyncMode::EveryRecord && !syncFile(file)) return false;
+    if (offset) *offset = file_size;
+    if (size) *size = static_cast<uint32_t>(record.size());
+    file_size += record.size();
+    return true;
+}
+
+bool JournalStorage::apply(RecordType type, const std::string& payload, uint64_t offset, uint32_t size) {
+    PayloadReader in(payload);
+    int id = 0;
+    switch (type) {
+    case RecordType::NoteUpsert: {
+        StoredNote note;
+        if (!decodeNote(payload, note)) return false;
+        NoteEntry& entry = notes[note.id];
+        if (entry.upsert_size != 0) live_bytes -= entry.upsert_size;
+        entry.note = std::move(note);
+        entry.upsert_offset = offset;
+        entry.upsert_size = size;
+        entry.content_loaded = true;
+        live_bytes += size;
+        return true;
+    }
+    case RecordType::NoteDelete: {
+        if (!in.integer(id)) return false;
+        auto it = notes.find(id);
+        if (it != notes.end()) {
+            live_bytes -= it->second.upsert_size;
+            notes.erase(it);
+        }
+        return true;
+    }
+    case RecordType::NoteMove: {
+        int folder_id = 0;
+        bool in_trash = false;
+        if (!in.integer(id) || !in.integer(folder_id) || !in.flag(in_trash)) return false;
+        auto it = notes.find(id);
+        if (it != notes.end()) {
+            it->second.note.folder_id = folder_id;
+            it->second.note.in_trash = in_trash;
+        }
+        return true;
+    }
+    case RecordType::TagAdd:
+    case RecordType::TagRemove: {
+        std::string tag;
+        if (!in.integer(id) || !in.string(tag)) return false;
+        auto it = notes.find(id);
+        if (it != notes.end()) {
+            auto& tags = it->second.note.tags;
+            auto pos = std::find(tags.begin(), tags.end(), tag);
+            if (type == RecordType::TagAdd && pos == tags.end()) {
+                tags.push_back(tag);
+            } else if (type == RecordType::TagRemove && pos != tags.end()) {
+                tags.erase(pos);
+            }
+        }
+        return true;
+    }
+    case RecordType::FolderUpsert: {
+        StoredFolder folder;
+        if (!decodeFolder(payload, folder)) return false;
+        auto& entry = folders[folder.id];
+        live_bytes -= entry.second;
+        entry = {folder, size};
+        live_bytes += size;
+        return true;
+    }
+    case RecordType::FolderDelete: {
+        if (!in.integer(id)) return false;
+        auto it = folders.find(id);
+        if (it != folders.end()) {
+            live_bytes -= it->second.second;
+            folders.erase(it);
+        }
+        return true;
+    }
+    }
+    return false; // Unknown record type
+}
+
+bool JournalStorage::readNoteContent(const NoteEntry& entry, std::string& content) const {
+    TRACE_SCOPE("storage.read_note");
+    if (file) std::fflush(file);
+    std::ifstream in(path, std::ios::binary);
+    return readNoteContent(in, entry, content);
+}
+
+bool JournalStorage::readNoteContent(std::istream& in, const NoteEntry& entry, std::string& content) const {
+    if (!in.seekg(static_cast<std::streamoff>(entry.upsert_offset))) return false;
+    uint8_t type = 0;
+    std::string payload;
+    StoredNote stored;
+    if (readFrame(in, entry.upsert_offset, file_size, type, payload) != FrameStatus::Valid ||
+        type != static_cast<uint8_t>(RecordType::NoteUpsert) || !decodeNote(payload, stored)) {
+        return false;
+    }
+    NOTES_COUNT("storage.bytes_read", FRAME_SIZE + payload.size());
+    content = std::move(stored.content);
+    return true;
+}
+
+bool JournalStorage::writeSnapshot(std::FILE* out, std::map<int, NoteEntry>& relocated, uint64_t& written) {
+    auto write = [out, &written](const std::string& bytes) {
+        written += bytes.size();
+        return std::fwrite(bytes.data(), 1, bytes.size(), out) == bytes.size();
+    };
+
+    written = 0;
+    if (!write(header())) return false;
+    for (auto& entry : folders) {
+        std::string record = frame(static_cast<uint8_t>(RecordType::FolderUpsert), encodeFolder(entry.second.first));
+        entry.second.second = static_cast<uint32_t>(record.size());
+        if (!write(record)) return false;
+    }
+
+    // Copy the notes in journal order, so the old journal is read once, front to back.
+    std::vector<const std::pair<const int, NoteEntry>*> by_offset;
+    by_offset.reserve(notes.size());
+    for (const auto& entry : notes) {
+        by_offset.push_back(&entry);
+    }
+    std::sort(by_offset.begin(), by_offset.end(),
+              [](const auto* a, const auto* b) { return a->second.upsert_offset < b->second.upsert_offset; });
+    if (file) std::fflush(file);
+    std::ifstream in(path, std::ios::binary);
+    for (const auto* entry : by_offset) {
+        StoredNote note = entry->second.note;
+        if (!entry->second.content_loaded && !readNoteContent(in, entry->second, note.content)) return false;
+
+        NoteEntry moved = entry->second;
+        moved.upsert_offset = written;
+        std::string record = frame(static_cast<uint8_t>(RecordType::NoteUpsert), encodeNote(note));
+        moved.upsert_size = static_cast<uint32_t>(record.size());
+        if (!write(record)) return false;
+        relocated.emplace(entry->first, std::move(moved));
+    }
+    return true;
+}
+
+bool JournalStorage::compact() {
+    TRACE_SCOPE("storage.compact");
+    if (!file || compacting) return false;
+    compacting = true;
+
+    const std::string temp_path = path + ".compact";
+    std::map<int, NoteEntry> relocated;
+    uint64_t written = 0;
+    std::FILE* out = std::fopen(temp_path.c_str(), "wb");
+    bool ok = out && writeSnapshot(out, relocated, written) && syncFile(out);
+    if (out) std::fclose(out);
+    NOTES_COUNT("storage.bytes_written", written);
+
+    std::error_code ec;
+    if (ok) {
+        std::fclose(file);
+        std::filesystem::rename(temp_path, path, ec);
+        file = std::fopen(path.c_str(), "ab");
+        ok = !ec && file;
+    }
+    if (!ok) {
+        std::filesystem::remove(temp_path, ec);
+        if (!file) file = std::fopen(path.c_str(), "ab");
+        compacting = false;
+        return false;
+    }
+
+    notes = std::move(relocated);
+    file_size = written;
+    live_bytes = written - HEADER_SIZE;
+    compacting = false;
+    return true;
+}
+
+void JournalStorage::maybeCompact() {
+    uint64_t garbage = file_size - HEADER_SIZE - live_bytes;
+    if (!compacting && file_size > COMPACTION_MIN_BYTES && garbage > live_bytes) {
+        compact();
+    }
+}
+
+uint64_t JournalStorage::fileBytes() const {
+    return file_size;
+}
+
+uint64_t JournalStorage::liveBytes() const {
+    return live_bytes;
+}
+
+uint64_t JournalStorage::recoveredBytes() const {
+    return recovered_bytes;
+}
+
+const std::string& JournalStorage::getError() const {
+    return error;
+}
@@ -0,0 +1,137 @@
+/**
+ * @file journal_storage.hpp
+ * @brief This file contains the declaration of the append-only journal storage engine.
+ */
+
+#ifndef JOURNAL_STORAGE_HPP
+#define JOURNAL_STORAGE_HPP
+
+#include "storage_backend.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <istream>
+#include <map>
+#include <string>
+
+/**
+ * @class JournalStorage
+ * @brief Stores every mutation as a checksummed record appended to a single file.
+ *
+ * Each record is framed as [length:u32][crc32:u32][type:u8][payload]. On open()
+ * the journal is scanned once; a torn tail (the last record cut short or
+ * damaged by a crash in the middle of a write) is truncated at the last valid
+ * record. A damaged record with data after it is not a torn write: open()
+ * fails, leaves the file untouched and says where through getError().
+ * Superseded records are reclaimed by compact(), which copies the live state
+ * to a temporary file in one pass over the journal and atomically renames it
+ * over the journal. Compaction also runs automatically once superseded data
+ * outweighs live data.
+ */
+class JournalStorage : public StorageBackend {
+public:
+    /**
+     * @enum SyncMode
+     * @brief Controls when appended records are forced to stable storage.
+     */
+    enum class SyncMode {
+        EveryRecord, ///< fsync after each append
+        OnSync       ///< fsync only when sync() is called
+    };
+
+    /**
+     * @brief Constructs a JournalStorage over a file. The file is not touched until open().
+     * @param file_path The path of the journal file.
+     * @param mode The durability policy for appended records.
+     */
+    explicit JournalStorage(const std::string& file_path, SyncMode mode = SyncMode::OnSync);
+
+    /**
+     * @brief Destructor. Syncs and closes the journal.
+     */
+    ~JournalStorage() override;
+
+    bool open() override;
+    bool replay(const std::function<void(const StoredFolder&)>& on_folder,
+                const std::function<void(StoredNote&&)>& on_note) override;
+    bool putNote(const StoredNote& note) override;
+    bool removeNote(int note_id) override;
+    bool moveNote(int note_id, int folder_id, bool in_trash) override;
+    bool addTag(int note_id, const std::string& tag_name) override;
+    bool removeTag(int note_id, const std::string& tag_name) override;
+    bool putFolder(const StoredFolder& folder) override;
+    bool removeFolder(int folder_id) override;
+    bool sync() override;
+
+    /**
+     * @brief Rewrites the journal so that it only contains live records.
+     * @return True if the journal was compacted, false otherwise (the old journal is kept).
+     */
+    bool compact();
+
+    /**
+     * @brief Gets the current size of the journal file.
+     * @return The size in bytes.
+     */
+    uint64_t fileBytes() const;
+
+    /**
+     * @brief Gets the number of bytes held by records that are still live.
+     * @return The size in bytes.
+     */
+    uint64_t liveBytes() const;
+
+    /**
+     * @brief Gets the number of bytes discarded from a damaged tail during the last open().
+     * @return The size in bytes.
+     */
+    uint64_t recoveredBytes() const;
+
+    /**
+     * @brief Gets the reason the last open() failed on an existing journal.
+     * @return The error message, or an empty string.
+     */
+    const std::string& getError() const;
+
+private:
+    enum class RecordType : uint8_t {
+        NoteUpsert = 1,
+        NoteDelete = 2,
+        NoteMove = 3,
+        TagAdd = 4,
+        TagRemove = 5,
+        FolderUpsert = 6,
+        FolderDelete = 7
+    };
+
+    /**
+     * @struct NoteEntry
+     * @brief The live state of a note. The content stays in memory only until replay().
+     */
+    struct NoteEntry {
+        StoredNote note;
+        uint64_t upsert_offset = 0;
+        uint32_t upsert_size = 0;
+        bool content_loaded = false;
+    };
+
+    bool append(RecordType type, const std::string& payload, uint64_t* offset = nullptr, uint32_t* size = nullptr);
+    bool apply(RecordType type, const std::string& payload, uint64_t offset, uint32_t size);
+    bool readNoteContent(const NoteEntry& entry, std::string& content) const;
+    bool readNoteContent(std::istream& in, const NoteEntry& entry, std::string& content) const;
+    bool writeSnapshot(std::FILE* out, std::map<int, NoteEntry>& relocated, uint64_t& written);
+    void maybeCompact();
+
+    std::string path;
+    SyncMode sync_mode;
+    std::FILE* file = nullptr;
+    std::map<int, NoteEntry> notes;
+    std::map<int, std::pair<StoredFolder, uint32_t>> folders; // Folder state and record size
+    uint64_t file_size = 0;
+    uint64_t live_bytes = 0;
+    uint64_t recovered_bytes = 0;
+    bool compacting = false;
+    std::string error;
+};
+
+#endif // JOURNAL_STORAGE_HPP
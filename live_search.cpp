@@ -0,0 +1,160 @@
+/**
+ * @file live_search.cpp
+ * @brief Implementation of the LiveSearch class.
+ */
+
+#include "live_search.hpp"
+
+#include <algorithm>
+
+namespace {
+
+// How many notes a query examines between two checks for a newer query.
+const size_t CANCEL_CHECK_INTERVAL = 64;
+
+} // namespace
+
+LiveSearch::LiveSearch(NoteManager& manager, Callback on_results, size_t worker_count)
+    : manager(manager), on_results(std::move(on_results)) {
+    for (size_t i = 0; i < std::max<size_t>(worker_count, 1); ++i) {
+        workers.emplace_back(&LiveSearch::workerLoop, this);
+    }
+}
+
+LiveSearch::~LiveSearch() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+        queued.reset();
+    }
+    ++latest_generation; // Makes running queries stop
+    queue_ready.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+uint64_t LiveSearch::submit(const NoteManager::SearchCriteria& criteria) {
+    auto snapshot = manager.getSnapshot();
+    if (!snapshot) {
+        return 0;
+    }
+    auto query = std::make_unique<Query>();
+    query->criteria = criteria;
+    query->criteria.keyword = NoteManager::trim(criteria.keyword);
+    auto& tags = query->criteria.tags;
+    for (auto& tag : tags) {
+        tag = NoteManager::trim(tag);
+    }
+    tags.erase(std::remove(tags.begin(), tags.end(), std::string()), tags.end());
+    query->snapshot = std::move(snapshot);
+    query->generation = ++latest_generation;
+    const uint64_t generation = query->generation;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queued = std::move(query);
+    }
+    queue_ready.notify_one();
+    return generation;
+}
+
+void LiveSearch::cancel() {
+    ++latest_generation;
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    queued.reset();
+}
+
+bool LiveSearch::narrows(const NoteManager::SearchCriteria& previous, const NoteManager::SearchCriteria& next) {
+    if (previous.search_in_trash != next.search_in_trash || previous.start_date != next.start_date ||
+        previous.end_date != next.end_date || previous.date_field != next.date_field ||
+        previous.newest_first != next.newest_first) {
+        return false;
+    }
+    // A note containing the new keyword contains every part of it, the old keyword included.
+    if (!TrigramIndex::containsIgnoreCase(next.keyword, previous.keyword)) {
+        return false;
+    }
+    if (previous.tags.empty()) {
+        return true;
+    }
+    if (previous.match_any_tag != next.match_any_tag) {
+        return false;
+    }
+    auto inNext = [&](const std::string& tag) {
+        return std::find(next.tags.begin(), next.tags.end(), tag) != next.tags.end();
+    };
+    if (!std::all_of(previous.tags.begin(), previous.tags.end(), inNext)) {
+        return false;
+    }
+    // Adding a tag narrows "all of" but widens "any of".
+    return !previous.match_any_tag || std::all_of(next.tags.begin(), next.tags.end(), [&](const std::string& tag) {
+        return std::find(previous.tags.begin(), previous.tags.end(), tag) != previous.tags.end();
+    });
+}
+
+void LiveSearch::workerLoop() {
+    while (true) {
+        std::unique_ptr<Query> query;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_ready.wait(lock, [this] { return stopping || queued; });
+            if (stopping) {
+                return;
+            }
+            query = std::move(queued);
+        }
+        run(*query);
+    }
+}
+
+void LiveSearch::run(const Query& query) {
+    NOTES_TIME_OPERATION("search.live");
+    if (cancelled(query)) {
+        return;
+    }
+    std::shared_ptr<const Results> previous;
+    {
+        std::lock_guard<std::mutex> lock(last_mutex);
+        if (last_query && last_query->snapshot == query.snapshot && narrows(last_query->criteria, query.criteria)) {
+            previous = last_results;
+        }
+    }
+
+    // Results are found in ID order, or in the previous results' order when narrowing them.
+    const bool found_in_order = !query.criteria.newest_first || previous;
+    Results results;
+    size_t examined = 0;
+    bool stopped = false;
+    auto examine = [&](const std::shared_ptr<const NoteRecord>& note) {
+        if (stopped || (++examined % CANCEL_CHECK_INTERVAL == 0 && (stopped = cancelled(query)))) {
+            return;
+        }
+        if (NoteManager::matchesCriteria(*note, query.criteria)) {
+            results.push_back(note);
+            if (found_in_order && results.size() == FIRST_BATCH_SIZE) {
+                on_results(query.generation, results, false);
+            }
+        }
+    };
+    if (previous) {
+        std::for_each(previous->begin(), previous->end(), examine);
+        NOTES_COUNT("search.live.narrowed", 1);
+    } else {
+        query.snapshot->notes().forEach(examine);
+    }
+    if (stopped || cancelled(query)) {
+        NOTES_COUNT("search.live.cancelled", 1);
+        return;
+    }
+    if (!found_in_order) {
+        NoteManager::sortNewestFirst(results, query.criteria.date_field);
+    }
+
+    auto completed = std::make_shared<const Results>(std::move(results));
+    {
+        std::lock_guard<std::mutex> lock(last_mutex);
+        last_query = std::make_shared<const Query>(query);
+        last_results = completed;
+    }
+    on_results(query.generation, *completed, true);
+}
@@ -0,0 +1,128 @@
+/**
+ * @file live_search.hpp
+ * @brief This file contains the engine behind search-as-you-type.
+ */
+
+#ifndef LIVE_SEARCH_HPP
+#define LIVE_SEARCH_HPP
+
+#include "notes.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class LiveSearch
+ * @brief Runs the queries of a search box on worker threads, each new query cancelling the previous one.
+ *
+ * submit() takes the manager's current snapshot and queues the query; only
+ * the newest queued query is kept. Workers search the snapshot, so they never
+ * touch the live notes. A running query checks every few notes whether a newer
+ * one was submitted and, if so, stops without reporting; with more than one
+ * worker the newer query starts at once instead of waiting for that check.
+ *
+ * When a query only narrows the last completed one on the same snapshot (the
+ * new keyword contains the old one, and the other criteria are equal or, for
+ * "all of" tags, add tags), it filters the previous results instead of
+ * scanning every note. Typing a word letter by letter therefore rescans only
+ * the notes that still match.
+ *
+ * Results are reported through the callback, on the worker thread. In ID
+ * order the first FIRST_BATCH_SIZE matches are reported as soon as they are
+ * found, before the scan completes, so the first screen of results does not
+ * wait for the whole search.
+ *
+ * Requires snapshots (NoteManager::enableSnapshots()); submit() and cancel()
+ * are called from the thread that edits the notes.
+ */
+class LiveSearch {
+public:
+    using Results = std::vector<std::shared_ptr<const NoteRecord>>;
+
+    /**
+     * @brief Receives the results of a query, on a worker thread.
+     * The arguments are the query's generation (see submit()), its results so
+     * far, and whether they are complete. Results of a query that is no longer
+     * the latest may still arrive and should be dropped by generation.
+     */
+    using Callback = std::function<void(uint64_t generation, const Results& results, bool complete)>;
+
+    static constexpr size_t FIRST_BATCH_SIZE = 50;
+
+    /**
+     * @brief Starts the worker threads.
+     * @param manager The manager whose snapshots are searched; must outlive the engine.
+     * @param on_results Called with the results of each query that is not cancelled.
+     * @param worker_count The number of worker threads (at least one).
+     */
+    LiveSearch(NoteManager& manager, Callback on_results, size_t worker_count = 2);
+
+    /**
+     * @brief Cancels the running queries and joins the workers.
+     */
+    ~LiveSearch();
+
+    LiveSearch(const LiveSearch&) = delete;
+    LiveSearch& operator=(const LiveSearch&) = delete;
+
+    /**
+     * @brief Queues a query and cancels the one in flight.
+     * @param criteria The search criteria.
+     * @return The generation of the query, increasing with each call; 0 if snapshots are not enabled.
+     */
+    uint64_t submit(const NoteManager::SearchCriteria& criteria);
+
+    /**
+     * @brief Cancels the queued and running queries without starting a new one.
+     */
+    void cancel();
+
+    /**
+     * @brief Gets the generation of the latest query (or cancellation).
+     */
+    uint64_t latestGeneration() const { return latest_generation.load(); }
+
+private:
+    struct Query {
+        uint64_t generation = 0;
+        NoteManager::SearchCriteria criteria; // Keyword and tags trimmed
+        std::shared_ptr<const NoteSnapshot> snapshot;
+    };
+
+    /**
+     * @brief Checks whether every match of `next` is a match of `previous`.
+     */
+    static bool narrows(const NoteManager::SearchCriteria& previous, const NoteManager::SearchCriteria& next);
+
+    void workerLoop();
+
+    /**
+     * @brief Runs one query and reports it unless it is cancelled.
+     */
+    void run(const Query& query);
+
+    bool cancelled(const Query& query) const { return latest_generation.load(std::memory_order_relaxed) != query.generation; }
+
+    NoteManager& manager;
+    Callback on_results;
+    std::atomic<uint64_t> latest_generation{0};
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_ready;
+    std::unique_ptr<Query> queued; // Only the newest query waits; older ones are dropped
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    // The last completed query, for narrowing.
+    std::mutex last_mutex;
+    std::shared_ptr<const Query> last_query;
+    std::shared_ptr<const Results> last_results;
+};
+
+#endif // LIVE_SEARCH_HPP
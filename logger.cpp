@@ -0,0 +1,175 @@
+/**
+ * @file logger.cpp
+ * @brief Implementation of the Logger class.
+ */
+
+#include "notes.hpp"
+
+#include <cctype>
+#include <ctime>
+
+namespace {
+
+const size_t RING_CAPACITY = 4096;
+const size_t MAX_BATCH_BYTES = 64 * 1024;
+const std::chrono::milliseconds WRITE_INTERVAL(50);
+
+} // namespace
+
+Logger::Logger(const std::string& filename, Mode mode)
+    : log_file(filename, std::ios::app), mode(mode), ring(mode == Mode::Asynchronous ? RING_CAPACITY : 2) {
+    if (mode == Mode::Asynchronous) {
+        writer = std::thread(&Logger::writerLoop, this);
+    }
+    log(Level::INFO, "Logger initialized.");
+}
+
+Logger::~Logger() {
+    if (writer.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+        }
+        wake.notify_one();
+        writer.join(); // The writer drains the ring before it exits
+    }
+}
+
+void Logger::setLevel(Level level) {
+    min_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+Logger::Level Logger::parseLevel(const std::string& name, Level fallback) {
+    std::string lower;
+    for (char c : name) {
+        lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (lower == "debug") return Level::DEBUG;
+    if (lower == "info") return Level::INFO;
+    if (lower == "warning" || lower == "warn") return Level::WARNING;
+    if (lower == "error") return Level::ERROR;
+    return fallback;
+}
+
+void Logger::log(Level level, std::string message) {
+    if (!isEnabled(level)) {
+        return;
+    }
+    Record record{std::chrono::system_clock::now(), level, std::move(message)};
+
+    if (mode == Mode::Synchronous) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        std::string line;
+        appendRecord(line, record);
+        log_file << line;
+        log_file.flush();
+        return;
+    }
+
+    while (!ring.tryPush(std::move(record))) {
+        // The ring is full: hurry the writer along rather than dropping the record.
+        wake.notify_one();
+        std::this_thread::yield();
+    }
+    if (backlogIsHigh()) {
+        wake.notify_one(); // Start writing before producers fill the ring
+    }
+    if (level == Level::ERROR) {
+        flush();
+    }
+}
+
+void Logger::flush() {
+    if (mode == Mode::Synchronous) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        log_file.flush();
+        return;
+    }
+    const size_t target = ring.pushedCount();
+    std::unique_lock<std::mutex> lock(wake_mutex);
+    flush_requested.store(true, std::memory_order_release);
+    wake.notify_one();
+    written.wait(lock, [&] { return written_count.load(std::memory_order_acquire) >= target; });
+}
+
+void Logger::writerLoop() {
+    TRACE_THREAD_NAME("logger");
+    std::string batch;
+    Record record;
+    while (true) {
+        const bool stop = stopping.load(std::memory_order_acquire);
+        flush_requested.store(false, std::memory_order_relaxed);
+        while (ring.tryPop(record)) {
+            appendRecord(batch, record);
+            if (batch.size() >= MAX_BATCH_BYTES) {
+                log_file << batch;
+                batch.clear();
+            }
+        }
+        if (!batch.empty()) {
+            log_file << batch;
+            batch.clear();
+        }
+        log_file.flush();
+
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            written_count.store(ring.poppedCount(), std::memory_order_release);
+        }
+        written.notify_all();
+
+        if (ring.poppedCount() != ring.pushedCount()) {
+            std::this_thread::yield(); // A producer claimed a cell but has not published it yet
+            continue;
+        }
+        if (stop) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake.wait_for(lock, WRITE_INTERVAL, [this] {
+            return stopping.load(std::memory_order_acquire) || flush_requested.load(std::memory_order_acquire) ||
+                   backlogIsHigh();
+        });
+    }
+}
+
+bool Logger::backlogIsHigh() const {
+    return ring.pushedCount() - ring.poppedCount() >= ring.capacity() / 4;
+}
+
+void Logger::appendRecord(std::string& out, const Record& record) {
+    out += '[';
+    out += getTimestamp(record.time);
+    out += "] [";
+    out += levelToString(record.level);
+    out += "] ";
+    out += record.message;
+    out += '\n';
+}
+
+std::string Logger::getTimestamp(std::chrono::system_clock::time_point time) {
+    const time_t seconds = std::chrono::system_clock::to_time_t(time);
+    if (seconds != cached_second) {
+        std::tm tm = {};
+#ifdef _WIN32
+        localtime_s(&tm, &seconds);
+#else
+        localtime_r(&seconds, &tm);
+#endif
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm);
+        cached_timestamp = buffer;
+        cached_second = seconds;
+    }
+    return cached_timestamp;
+}
+
+std::string Logger::levelToString(Level level) const {
+    switch (level) {
+        case Level::DEBUG: return "DEBUG";
+        case Level::INFO: return "INFO";
+        case Level::WARNING: return "WARNING";
+        case Level::ERROR: return "ERROR";
+    }
+    return "INFO";
+}
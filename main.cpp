@@ -7,11 +7,19 @@
  */
 
 #include <QApplication>
+#include <QTimer>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
 #include <iostream>
+#include <limits>
 #include <vector>
 #include <string>
 #include <sstream>
+#include <unordered_set>
 #include "notes.hpp"
+#include "search_cursor.hpp"
 #include "ui.hpp"
 #include "tests.hpp"
 #include "filler_code.hpp"
@@ -42,8 +50,29 @@ void handleCommand(const std::string& command, NoteManager& manager);
  */
 std::vector<std::string> splitCommand(const std::string& command);
 
+/**
+ * @struct PendingSearch
+ * @brief The last CLI search, whose next page the "more" command prints.
+ */
+struct PendingSearch {
+    std::string query;
+    size_t shown = 0;                                  // Results printed so far
+    bool ranked_ready = false;                         // `ranked` has been computed
+    std::vector<NoteManager::RankedNote> ranked;       // Every whole-word match, best first; computed once
+    std::unordered_set<int> ranked_ids;                // Skipped by the substring matches that follow them
+    std::unique_ptr<SearchCursor> cursor;              // The substring matches, paged once `ranked` is printed
+};
+
+/**
+ * @brief Prints the next page of a CLI search.
+ * @param manager A reference to the NoteManager.
+ * @param search The search; updated to the position after the page.
+ */
+void printSearchPage(NoteManager& manager, PendingSearch& search);
+
 // --- New Function Prototypes ---
 void listAllTags(NoteManager& manager);
+void explainSearch(NoteManager& manager, const std::vector<std::string>& args);
 void exportNote(NoteManager& manager, int note_id, const std::string& format);
 void setReminderForNote(NoteManager& manager, int note_id, const std::string& datetime);
 void showLogs();
@@ -59,6 +88,18 @@ void runTests();
  * the command-line interface. Otherwise, it launches the Qt GUI application.
  */
 int main(int argc, char *argv[]) {
+    // With NOTES_TRACE_FILE set, trace the whole run (startup included) and write the trace on exit.
+    const char* trace_file = std::getenv("NOTES_TRACE_FILE");
+#ifdef NOTES_ENABLE_TRACING
+    if (trace_file && *trace_file) {
+        Tracer::global().start();
+        TRACE_THREAD_NAME("main");
+    }
+#else
+    trace_file = nullptr;
+#endif
+    const uint64_t trace_begin = Tracer::global().now();
+
     // Check for CLI mode argument
     for (int i = 1; i < argc; ++i) {
         // If the command-line argument is "--cli", run the CLI.
@@ -67,12 +108,18 @@ int main(int argc, char *argv[]) {
             NoteManager noteManager;
             // Run the command-line interface.
             runCli(noteManager);
+            // Write the trace, if one was requested.
+            if (trace_file && *trace_file) {
+                Tracer::global().writeChromeTrace(trace_file);
+            }
             // Return 0 to indicate successful execution.
             return 0;
         }
     }
 
     // Default to GUI mode
+    // Start the startup clock for the time-to-first-window report.
+    const auto startup_begin = std::chrono::steady_clock::now();
     // Create a QApplication instance.
     QApplication app(argc, argv);
     // Create a NoteManager instance.
@@ -83,8 +130,24 @@ int main(int argc, char *argv[]) {
     window.setWindowTitle("C++ Advanced Note Taker");
     // Show the main window.
     window.show();
+    // Report startup timings once the event loop has processed the first paint.
+    QTimer::singleShot(0, &window, [&noteManager, startup_begin, trace_begin]() {
+        if (Tracer::global().isRecording()) {
+            Tracer::global().record("startup.first_window", trace_begin, Tracer::global().now());
+        }
+        double first_window_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startup_begin).count();
+        const StartupReport& report = noteManager.getStartupReport();
+        noteManager.log("Time to first window: " + std::to_string(static_cast<long long>(first_window_ms)) +
+                        " ms; data load: " + std::to_string(static_cast<long long>(report.total_ms)) + " ms for " +
+                        std::to_string(report.note_count) + " notes" + (report.lazy ? " (bodies deferred)." : "."));
+    });
     // Execute the application event loop.
-    return app.exec();
+    const int exit_code = app.exec();
+    // Write the trace, if one was requested.
+    if (trace_file && *trace_file) {
+        Tracer::global().writeChromeTrace(trace_file);
+    }
+    return exit_code;
 }
 
 /**
@@ -139,7 +202,11 @@ void printHelp() {
               << "  mvnote <note_id> <folder_id>  - Moves a note to another folder.\n"
               << "  tag <note_id> <tag_name>      - Adds a tag to a note.\n"
               << "  untag <note_id> <tag_name>    - Removes a tag from a note.\n"
-              << "  search <keyword>              - Searches for notes by keyword.\n"
+              << "  search <words>                - Lists the 20 notes most relevant to the words, then those containing them inside words.\n"
+              << "  more                          - Lists the next 20 results of the last search.\n"
+              << "  recent [count]                - Lists the most recently modified notes (default 10).\n"
+              << "  explain [options] [keyword]   - Shows how a search is planned and timed. Options: tag=<name>,\n"
+              << "                                  any, from=<YYYY-MM-DD>, to=<YYYY-MM-DD>, created, trash, newest.\n"
               << "  trash ls                      - Lists items in the trash.\n"
               << "  trash restore <id>            - Restores an item from trash (use 'ls' to find ID).\n"
               << "  trash empty                   - Permanently empties the trash.\n"
@@ -148,8 +215,14 @@ void printHelp() {
               << "  remind <note_id> <datetime>   - Sets a reminder for a note (e.g., '2024-12-31 23:59').\n"
               << "  logs                          - Shows application logs.\n"
               << "  test                          - Runs application tests.\n"
+              << "  test mvcc                     - Stress-tests snapshot reads against concurrent writers.\n"
+              << "  test batch                    - Checks that invalid note batches are rejected unchanged.\n"
+              << "  test journal                  - Checks that journal recovery keeps records after damage.\n"
               << "  html <note_id> <file_path>    - Exports a note to an HTML file.\n"
               << "  filler                        - Executes filler code.\n"
+              << "  stats [reset]                 - Shows operation latencies and storage I/O, or resets them.\n"
+              << "  trace start                   - Starts recording trace spans (needs NOTES_ENABLE_TRACING).\n"
+              << "  trace stop <file_path>        - Stops recording and writes a Chrome trace JSON file.\n"
               << "  exit                          - Exits the application.\n"
               << "---------------------------------" << std::endl;
 }
@@ -188,6 +261,8 @@ void handleCommand(const std::string& input, NoteManager& manager) {
 
     // Get the command from the arguments.
     const std::string& cmd = args[0];
+    // The last search, kept between commands so "more" can continue it.
+    static PendingSearch pending_search;
 
     // Use a try-catch block to handle exceptions.
     try {
@@ -246,7 +321,7 @@ void handleCommand(const std::string& input, NoteManager& manager) {
             // Create a vector to store the tags of the note.
             std::vector<std::string> tags;
             // Iterate over the tags of the note and add them to the vector.
-            for(const auto& tag : note->getTags()){
+            for(const auto& tag : note->getTagList()){
                 tags.push_back(tag->getName());
             }
             // Edit the note with the new content and tags.
@@ -286,15 +361,32 @@ void handleCommand(const std::string& input, NoteManager& manager) {
         } 
         // If the command is "search" and there is a second argument, search for notes.
         else if (cmd == "search" && args.size() > 1) {
-            // Search for notes by the given keyword.
-            auto results = manager.searchNotesByKeyword(args[1]);
-            // Print the number of search results.
-            std::cout << "Found " << results.size() << " notes:" << std::endl;
-            // Iterate over the search results and display them.
-            for (const auto& note : results) {
-                note->display();
+            // Show the first page of the notes most relevant to the given words; "more" shows the next.
+            pending_search = PendingSearch();
+            for (size_t i = 1; i < args.size(); ++i) {
+                pending_search.query += (i > 1 ? " " : "") + args[i];
+            }
+            printSearchPage(manager, pending_search);
+        }
+        // If the command is "more", show the next page of the last search.
+        else if (cmd == "more") {
+            if (pending_search.query.empty()) {
+                std::cout << "No search to continue." << std::endl;
+            } else {
+                printSearchPage(manager, pending_search);
             }
         } 
+        // If the command is "recent", list the most recently modified notes, newest first.
+        else if (cmd == "recent") {
+            const size_t count = args.size() > 1 ? static_cast<size_t>(std::stoul(args[1])) : 10;
+            for (const auto& note : manager.getRecentlyModifiedNotes(count)) {
+                std::cout << "  ID: " << note->getId() << ", Title: " << note->getTitleView() << std::endl;
+            }
+        }
+        // If the command is "explain", run an advanced search and show its plan.
+        else if (cmd == "explain") {
+            explainSearch(manager, args);
+        }
         // If the command is "trash" and there is a second argument, perform a trash-related action.
         else if (cmd == "trash" && args.size() > 1) {
             // If the second argument is "ls", list the contents of the trash.
@@ -304,12 +396,12 @@ void handleCommand(const std::string& input, NoteManager& manager) {
                 // Print the trashed notes.
                 std::cout << "--- Trash Contents ---\nNotes:\n";
                 for(const auto& note : contents.first) {
-                    std::cout << "  ID: " << note->getId() << ", Title: " << note->getTitle() << std::endl;
+                    std::cout << "  ID: " << note->getId() << ", Title: " << note->getTitleView() << std::endl;
                 }
                 // Print the trashed folders.
                 std::cout << "Folders:\n";
                 for(const auto& folder : contents.second) {
-                    std::cout << "  ID: " << folder->getId() << ", Name: " << folder->getName() << std::endl;
+                    std::cout << "  ID: " << folder->getId() << ", Name: " << folder->getNameView() << std::endl;
                 }
                 std::cout << "----------------------" << std::endl;
             } 
@@ -356,6 +448,18 @@ void handleCommand(const std::string& input, NoteManager& manager) {
         else if (cmd == "logs") {
             showLogs();
         }
+        // If the command is "test mvcc", run the snapshot concurrency stress test.
+        else if (cmd == "test" && args.size() > 1 && args[1] == "mvcc") {
+            runSnapshotStressTest();
+        }
+        // If the command is "test batch", check NoteBatch validation.
+        else if (cmd == "test" && args.size() > 1 && args[1] == "batch") {
+            runBatchValidationTest(manager);
+        }
+        // If the command is "test journal", check journal recovery from damaged files.
+        else if (cmd == "test" && args.size() > 1 && args[1] == "journal") {
+            runJournalRecoveryTest();
+        }
         // If the command is "test", run tests.
         else if (cmd == "test") {
             runAllTests(manager);
@@ -372,6 +476,32 @@ void handleCommand(const std::string& input, NoteManager& manager) {
         else if (cmd == "filler") {
             Filler::executeFillerCode();
         }
+        // If the command is "stats", show or reset the operation metrics.
+        else if (cmd == "stats" && args.size() > 1 && args[1] == "reset") {
+            MetricsRegistry::global().reset();
+            std::cout << "Metrics reset." << std::endl;
+        }
+        else if (cmd == "stats") {
+            MetricsRegistry::global().writeReport(std::cout);
+        }
+        // If the command is "trace", start or stop span recording.
+        else if (cmd == "trace" && args.size() > 1 && args[1] == "start") {
+#ifdef NOTES_ENABLE_TRACING
+            Tracer::global().clear();
+            Tracer::global().start();
+            std::cout << "Tracing started." << std::endl;
+#else
+            std::cerr << "Tracing is not compiled in; rebuild with -DNOTES_ENABLE_TRACING." << std::endl;
+#endif
+        }
+        else if (cmd == "trace" && args.size() > 2 && args[1] == "stop") {
+            Tracer::global().stop();
+            if (Tracer::global().writeChromeTrace(args[2])) {
+                std::cout << Tracer::global().eventCount() << " spans written to " << args[2] << std::endl;
+            } else {
+                std::cerr << "Could not write " << args[2] << std::endl;
+            }
+        }
         // Otherwise, print an error message.
         else {
             std::cerr << "Unknown command: '" << cmd << "'. Type 'help' for a list of commands." << std::endl;
@@ -395,17 +525,111 @@ void handleCommand(const std::string& input, NoteManager& manager) {
  */
 void listAllTags(NoteManager& manager) {
     std::cout << "--- All Tags ---\n";
-    auto tags = manager.getAllTags();
+    const auto& tags = manager.getAllTags();
     if (tags.empty()) {
         std::cout << "No tags found.\n";
     } else {
         for (const auto& tag : tags) {
-            std::cout << "  - Tag: '" << tag->getName() << "' (ID: " << tag->getId() << ")" << std::endl;
+            std::cout << "  - Tag: '" << tag->getNameView() << "' (ID: " << tag->getId() << ")" << std::endl;
         }
     }
     std::cout << "----------------\n";
 }
 
+/**
+ * @brief Prints the next page of a CLI search.
+ * @param manager A reference to the NoteManager.
+ * @param search The search; updated to the position after the page.
+ */
+void printSearchPage(NoteManager& manager, PendingSearch& search) {
+    const size_t page_size = 20;
+    if (!search.ranked_ready) {
+        // Rank every whole-word match once; "more" pages through the stored list.
+        search.ranked = manager.searchNotesRanked(search.query, std::numeric_limits<size_t>::max());
+        for (const auto& result : search.ranked) {
+            search.ranked_ids.insert(result.note->getId());
+        }
+        search.ranked_ready = true;
+    }
+    size_t printed = 0;
+    for (; printed < page_size && search.shown < search.ranked.size(); ++printed, ++search.shown) {
+        const auto& result = search.ranked[search.shown];
+        std::ostringstream score;
+        score << std::fixed << std::setprecision(2) << result.score;
+        std::cout << "  " << search.shown + 1 << ". [" << score.str() << "] ID: " << result.note->getId()
+                  << ", Title: " << result.note->getTitleView() << std::endl;
+    }
+    // Then the notes that contain the words only inside longer words, e.g. "foobar" for "foo".
+    if (printed < page_size && !search.cursor) {
+        NoteManager::SearchCriteria criteria;
+        criteria.keyword = search.query;
+        search.cursor = std::make_unique<SearchCursor>(manager, criteria);
+    }
+    while (printed < page_size && search.cursor && !search.cursor->done()) {
+        for (const auto& note : search.cursor->next(page_size - printed)) {
+            if (search.ranked_ids.count(note->getId())) {
+                continue;
+            }
+            std::cout << "  " << ++search.shown << ". ID: " << note->getId() << ", Title: " << note->getTitleView()
+                      << std::endl;
+            ++printed;
+        }
+    }
+    const bool more = search.shown < search.ranked.size() || !search.cursor || !search.cursor->done();
+    if (search.shown == 0) {
+        std::cout << "No notes found." << std::endl;
+    } else if (more) {
+        std::cout << "Type 'more' for the next results." << std::endl;
+    } else {
+        std::cout << "End of results." << std::endl;
+    }
+}
+
+/**
+ * @brief Runs an advanced search described by CLI options and prints its plan.
+ * @param manager A reference to the NoteManager.
+ * @param args The command arguments; the words that are not options form the keyword.
+ */
+void explainSearch(NoteManager& manager, const std::vector<std::string>& args) {
+    NoteManager::SearchCriteria criteria;
+    auto parseDay = [](const std::string& text, bool end_of_day) {
+        std::tm tm{};
+        std::istringstream in(text);
+        in >> std::get_time(&tm, "%Y-%m-%d");
+        if (in.fail()) {
+            throw std::invalid_argument("expected a date as YYYY-MM-DD, got '" + text + "'");
+        }
+        if (end_of_day) {
+            tm.tm_hour = 23;
+            tm.tm_min = 59;
+            tm.tm_sec = 59;
+        }
+        tm.tm_isdst = -1;
+        return std::mktime(&tm);
+    };
+    for (size_t i = 1; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (arg.rfind("tag=", 0) == 0) {
+            criteria.tags.push_back(arg.substr(4));
+        } else if (arg.rfind("from=", 0) == 0) {
+            criteria.start_date = parseDay(arg.substr(5), false);
+        } else if (arg.rfind("to=", 0) == 0) {
+            criteria.end_date = parseDay(arg.substr(3), true);
+        } else if (arg == "any") {
+            criteria.match_any_tag = true;
+        } else if (arg == "created") {
+            criteria.date_field = NoteManager::SearchCriteria::DateField::Created;
+        } else if (arg == "trash") {
+            criteria.search_in_trash = true;
+        } else if (arg == "newest") {
+            criteria.newest_first = true;
+        } else {
+            criteria.keyword += (criteria.keyword.empty() ? "" : " ") + arg;
+        }
+    }
+    std::cout << manager.explainSearch(criteria).describe();
+}
+
 /**
  * @brief Exports a note to a specified format.
  * @param manager A reference to the NoteManager.
@@ -414,14 +638,26 @@ void listAllTags(NoteManager& manager) {
  */
 void exportNote(NoteManager& manager, int note_id, const std::string& format) {
     std::cout << "Initializing note export..." << std::endl;
-    auto note = manager.findNoteById(note_id);
-    if (!note) {
+    // With snapshots enabled the export reads an immutable copy, so it could run off the editing thread.
+    // Without them the body is streamed from the live note piece by piece, so large notes are not copied.
+    std::string title;
+    std::shared_ptr<const std::string> content;
+    std::shared_ptr<Note> note;
+    if (auto snapshot = manager.getSnapshot()) {
+        if (auto record = snapshot->findNote(note_id)) {
+            title = record->title;
+            content = record->content;
+        }
+    } else if ((note = manager.findNoteById(note_id))) {
+        title = note->getTitle();
+    }
+    if (!content && !note) {
         std::cerr << "Error: Note with ID " << note_id << " not found." << std::endl;
         return;
     }
 
     std::string filename = "note_" + std::to_string(note_id) + "." + format;
-    std::cout << "Preparing to export '" << note->getTitle() << "' to file: " << filename << std::endl;
+    std::cout << "Preparing to export '" << title << "' to file: " << filename << std::endl;
 
     if (format == "txt" || format == "md" || format == "html") {
         std::cout << "Simulating file write to '" << filename << "'..." << std::endl;
@@ -429,7 +665,13 @@ void exportNote(NoteManager& manager, int note_id, const std::string& format) {
         // std::ofstream outFile(filename);
         // outFile << note->getContent();
         // outFile.close();
-        std::cout << "Note content preview:\n---\n" << note->getContent() << "\n---\n";
+        std::cout << "Note content preview:\n---\n";
+        if (content) {
+            std::cout << *content;
+        } else {
+            note->forEachContentChunk([](std::string_view chunk) { std::cout << chunk; });
+        }
+        std::cout << "\n---\n";
         std::cout << "Successfully exported note " << note_id << " to " << filename << "." << std::endl;
     } else {
         std::cerr << "Error: Unsupported export format '" << format << "'. Supported formats: txt, md, html." << std::endl;
@@ -0,0 +1,194 @@
+/**
+ * @file metrics.cpp
+ * @brief Implementation of LatencyHistogram and MetricsRegistry.
+ */
+
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+
+namespace {
+
+unsigned highestBit(uint64_t value) {
+    unsigned bit = 0;
+    while (value >>= 1) ++bit;
+    return bit;
+}
+
+/**
+ * @brief Formats a duration with a unit that keeps three significant digits.
+ */
+std::string formatNanoseconds(double nanoseconds) {
+    static const char* const units[] = {"ns", "us", "ms", "s"};
+    size_t unit = 0;
+    while (nanoseconds >= 1000.0 && unit < 3) {
+        nanoseconds /= 1000.0;
+        ++unit;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), unit == 0 ? "%.0f %s" : "%.3g %s", nanoseconds, units[unit]);
+    return buffer;
+}
+
+} // namespace
+
+// --- LatencyHistogram ---
+
+LatencyHistogram::LatencyHistogram() {
+    for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    // Keep the top SUB_BUCKET_BITS + 1 bits: the octave picks the block, the rest the sub-bucket.
+    const unsigned shift = highestBit(value) - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKET_COUNT + static_cast<size_t>((value >> shift) - SUB_BUCKET_COUNT);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    const size_t block = index / SUB_BUCKET_COUNT;
+    const uint64_t sub = index % SUB_BUCKET_COUNT;
+    if (block == 0) {
+        return sub;
+    }
+    const unsigned shift = static_cast<unsigned>(block - 1);
+    return ((SUB_BUCKET_COUNT + sub) << shift) + ((uint64_t(1) << shift) - 1);
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    buckets[bucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    total_count.fetch_add(1, std::memory_order_relaxed);
+    total_sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    uint64_t seen = max_value.load(std::memory_order_relaxed);
+    while (nanoseconds > seen && !max_value.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+double LatencyHistogram::mean() const {
+    const uint64_t n = count();
+    return n == 0 ? 0.0 : static_cast<double>(total_sum.load(std::memory_order_relaxed)) / static_cast<double>(n);
+}
+
+uint64_t LatencyHistogram::percentile(double percent) const {
+    const uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(n))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), max());
+        }
+    }
+    return max(); // Counts moved on while we were reading
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+    total_count.store(0, std::memory_order_relaxed);
+    total_sum.store(0, std::memory_order_relaxed);
+    max_value.store(0, std::memory_order_relaxed);
+}
+
+// --- MetricsRegistry ---
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::~MetricsRegistry() {
+    stopPeriodicDump();
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const std::string& name) {
+    std::lock_guard<std::mutex> lock(metrics_mutex);
+    auto& slot = histograms[name];
+    if (!slot) slot = std::make_unique<LatencyHistogram>();
+    return *slot;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name) {
+    std::lock_guard<std::mutex> lock(metrics_mutex);
+    auto& slot = counters[name];
+    if (!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+void MetricsRegistry::writeReport(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(metrics_mutex);
+    out << std::left << std::setw(28) << "operation" << std::right << std::setw(10) << "count" << std::setw(11)
+        << "mean" << std::setw(11) << "p50" << std::setw(11) << "p90" << std::setw(11) << "p99" << std::setw(11)
+        << "max" << "\n";
+    for (const auto& entry : histograms) {
+        const LatencyHistogram& h = *entry.second;
+        if (h.count() == 0) continue;
+        out << std::left << std::setw(28) << entry.first << std::right << std::setw(10) << h.count() << std::setw(11)
+            << formatNanoseconds(h.mean()) << std::setw(11) << formatNanoseconds(static_cast<double>(h.percentile(50)))
+            << std::setw(11) << formatNanoseconds(static_cast<double>(h.percentile(90))) << std::setw(11)
+            << formatNanoseconds(static_cast<double>(h.percentile(99))) << std::setw(11)
+            << formatNanoseconds(static_cast<double>(h.max())) << "\n";
+    }
+    for (const auto& entry : counters) {
+        out << std::left << std::setw(28) << entry.first << std::right << std::setw(10) << entry.second->value() << "\n";
+    }
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(metrics_mutex);
+    for (auto& entry : histograms) entry.second->reset();
+    for (auto& entry : counters) entry.second->reset();
+}
+
+bool MetricsRegistry::dumpTo(const std::string& file_path) const {
+    std::ofstream out(file_path, std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    const std::time_t now = std::time(nullptr);
+    std::tm tm = {};
+#ifdef _WIN32
+    localtime_s(&tm, &now);
+#else
+    localtime_r(&now, &tm);
+#endif
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm);
+    out << "# Metrics at " << stamp << "\n";
+    writeReport(out);
+    return static_cast<bool>(out);
+}
+
+void MetricsRegistry::startPeriodicDump(const std::string& file_path, std::chrono::seconds interval) {
+    stopPeriodicDump();
+    dump_stopping = false;
+    dump_thread = std::thread([this, file_path, interval] {
+        TRACE_THREAD_NAME("metrics");
+        std::unique_lock<std::mutex> lock(dump_mutex);
+        while (!dump_wakeup.wait_for(lock, interval, [this] { return dump_stopping; })) {
+            dumpTo(file_path);
+        }
+        dumpTo(file_path);
+    });
+}
+
+void MetricsRegistry::stopPeriodicDump() {
+    if (!dump_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(dump_mutex);
+        dump_stopping = true;
+    }
+    dump_wakeup.notify_all();
+    dump_thread.join();
+}
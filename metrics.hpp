@@ -0,0 +1,207 @@
+/**
+ * @file metrics.hpp
+ * @brief Latency histograms, counters and the registry that reports them.
+ */
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "trace.hpp"
+
+/**
+ * @class LatencyHistogram
+ * @brief A fixed-size, log-linear histogram of durations in nanoseconds, in the style of HdrHistogram.
+ *
+ * Each power of two is split into 32 linear sub-buckets, so any recorded
+ * value is reported within about 3% over the whole 64-bit range while the
+ * histogram stays a flat array of counters. record() is wait-free apart from
+ * the running maximum and may be called from any thread.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    LatencyHistogram();
+
+    /**
+     * @brief Records one duration.
+     * @param nanoseconds The duration.
+     */
+    void record(uint64_t nanoseconds);
+
+    uint64_t count() const { return total_count.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_value.load(std::memory_order_relaxed); }
+    double mean() const;
+
+    /**
+     * @brief Gets the value below which a share of the recorded durations fall.
+     * @param percent The percentile, from 0 to 100.
+     * @return The highest value of the bucket holding that percentile, or 0 if nothing was recorded.
+     */
+    uint64_t percentile(double percent) const;
+
+    /**
+     * @brief Forgets every recorded value.
+     */
+    void reset();
+
+private:
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(size_t index);
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets;
+    std::atomic<uint64_t> total_count{0};
+    std::atomic<uint64_t> total_sum{0};
+    std::atomic<uint64_t> max_value{0};
+};
+
+/**
+ * @class Counter
+ * @brief A monotonically increasing count, such as bytes written. Thread-safe.
+ */
+class Counter {
+public:
+    void add(uint64_t amount = 1) { total.fetch_add(amount, std::memory_order_relaxed); }
+    uint64_t value() const { return total.load(std::memory_order_relaxed); }
+    void reset() { total.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> total{0};
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Owns the named histograms and counters of the process and writes them as a report.
+ *
+ * Metrics are created on first use and live as long as the registry, so call
+ * sites can keep references to them (NOTES_TIME_OPERATION caches one in a
+ * function-local static). Names are dotted, e.g. "search.notes" or
+ * "storage.bytes_written".
+ */
+class MetricsRegistry {
+public:
+    /**
+     * @brief Gets the process-wide registry.
+     */
+    static MetricsRegistry& global();
+
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * @brief Stops the periodic dump, if any.
+     */
+    ~MetricsRegistry();
+
+    /**
+     * @brief Gets or creates a histogram.
+     * @param name The metric name.
+     * @return The histogram; the reference stays valid for the registry's lifetime.
+     */
+    LatencyHistogram& histogram(const std::string& name);
+
+    /**
+     * @brief Gets or creates a counter.
+     * @param name The metric name.
+     * @return The counter; the reference stays valid for the registry's lifetime.
+     */
+    Counter& counter(const std::string& name);
+
+    /**
+     * @brief Writes a table of every histogram (count, mean, p50, p90, p99, max) and counter.
+     * @param out The stream to write to.
+     */
+    void writeReport(std::ostream& out) const;
+
+    /**
+     * @brief Resets every metric to zero. Metrics stay registered.
+     */
+    void reset();
+
+    /**
+     * @brief Rewrites a file with the current report at a fixed interval, from a background thread.
+     * Replaces a dump that is already running.
+     * @param file_path The file to write.
+     * @param interval The time between two dumps.
+     */
+    void startPeriodicDump(const std::string& file_path, std::chrono::seconds interval);
+
+    /**
+     * @brief Stops the periodic dump after writing a last report. Does nothing if none is running.
+     */
+    void stopPeriodicDump();
+
+private:
+    bool dumpTo(const std::string& file_path) const;
+
+    mutable std::mutex metrics_mutex;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> histograms;
+    std::map<std::string, std::unique_ptr<Counter>> counters;
+
+    std::mutex dump_mutex;
+    std::condition_variable dump_wakeup;
+    bool dump_stopping = false;
+    std::thread dump_thread;
+};
+
+/**
+ * @class ScopedLatency
+ * @brief Records the lifetime of the object in a histogram.
+ */
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& histogram)
+        : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedLatency() {
+        histogram.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define NOTES_METRICS_CONCAT_(a, b) a##b
+#define NOTES_METRICS_CONCAT(a, b) NOTES_METRICS_CONCAT_(a, b)
+
+/**
+ * @brief Times the rest of the enclosing scope into the global histogram `name`.
+ * The histogram is looked up once per call site. With NOTES_ENABLE_TRACING the
+ * scope is also traced as a span of the same name.
+ */
+#define NOTES_TIME_OPERATION(name)                                                                                  \
+    static LatencyHistogram& NOTES_METRICS_CONCAT(notes_histogram_, __LINE__) =                                     \
+        MetricsRegistry::global().histogram(name);                                                                  \
+    ScopedLatency NOTES_METRICS_CONCAT(notes_latency_, __LINE__)(NOTES_METRICS_CONCAT(notes_histogram_, __LINE__)); \
+    TRACE_SCOPE(name)
+
+/**
+ * @brief Adds `amount` to the global counter `name`. The counter is looked up once per call site.
+ */
+#define NOTES_COUNT(name, amount)                                                       \
+    do {                                                                                \
+        static Counter& notes_counter_ = MetricsRegistry::global().counter(name);     \
+        notes_counter_.add(static_cast<uint64_t>(amount));                            \
+    } while (0)
+
+#endif // METRICS_HPP
@@ -38,10 +38,22 @@ template <> constexpr inline auto SearchDialog::qt_create_metaobjectdata<qt_meta
 {
     namespace QMC = QtMocConstants;
     QtMocHelpers::StringRefStorage qt_stringData {
-        "SearchDialog"
+        "SearchDialog",
+        "resultsReady",
+        "",
+        "std::vector<int>",
+        "note_ids",
+        "complete",
+        "onQueryEdited"
     };
 
     QtMocHelpers::UintData qt_methods {
+        // Signal 'resultsReady'
+        QtMocHelpers::SignalData<void(const std::vector<int> &, bool)>(1, 2, QMC::AccessPublic, QMetaType::Void, {{
+            { 0x80000000 | 3, 4 }, { QMetaType::Bool, 5 },
+        }}),
+        // Slot 'onQueryEdited'
+        QtMocHelpers::SlotData<void()>(6, 2, QMC::AccessPrivate, QMetaType::Void),
     };
     QtMocHelpers::UintData qt_properties {
     };
@@ -63,10 +75,17 @@ Q_CONSTINIT const QMetaObject SearchDialog::staticMetaObject = { {
 void SearchDialog::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id, void **_a)
 {
     auto *_t = static_cast<SearchDialog *>(_o);
-    (void)_t;
-    (void)_c;
-    (void)_id;
-    (void)_a;
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        switch (_id) {
+        case 0: _t->resultsReady((*reinterpret_cast< std::add_pointer_t<std::vector<int>>>(_a[1])),(*reinterpret_cast< std::add_pointer_t<bool>>(_a[2]))); break;
+        case 1: _t->onQueryEdited(); break;
+        default: ;
+        }
+    }
+    if (_c == QMetaObject::IndexOfMethod) {
+        if (QtMocHelpers::indexOfMethod<void (SearchDialog::*)(const std::vector<int> & , bool )>(_a, &SearchDialog::resultsReady, 0))
+            return;
+    }
 }
 
 const QMetaObject *SearchDialog::metaObject() const
@@ -85,8 +104,26 @@ void *SearchDialog::qt_metacast(const char *_clname)
 int SearchDialog::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
 {
     _id = QDialog::qt_metacall(_c, _id, _a);
+    if (_id < 0)
+        return _id;
+    if (_c == QMetaObject::InvokeMetaMethod) {
+        if (_id < 2)
+            qt_static_metacall(this, _c, _id, _a);
+        _id -= 2;
+    }
+    if (_c == QMetaObject::RegisterMethodArgumentMetaType) {
+        if (_id < 2)
+            *reinterpret_cast<QMetaType *>(_a[0]) = QMetaType();
+        _id -= 2;
+    }
     return _id;
 }
+
+// SIGNAL 0
+void SearchDialog::resultsReady(const std::vector<int> & _t1, bool _t2)
+{
+    QMetaObject::activate<void>(this, &staticMetaObject, 0, nullptr, _t1, _t2);
+}
 namespace {
 struct qt_meta_tag_ZN20NotePropertiesDialogE_t {};
 } // unnamed namespace
@@ -160,12 +197,16 @@ template <> constexpr inline auto MainWindow::qt_create_metaobjectdata<qt_meta_t
         "onDeleteItem",
         "onSaveNote",
         "onFolderSelected",
-        "QTreeWidgetItem*",
-        "item",
-        "column",
+        "QModelIndex",
+        "index",
         "onNoteSelected",
-        "QListWidgetItem*",
+        "onEditorTextChanged",
+        "onAutosaveTimeout",
         "onAdvancedSearch",
+        "showLiveSearchResults",
+        "std::vector<int>",
+        "note_ids",
+        "complete",
         "onShowTrash",
         "onEmptyTrash",
         "onShowLogs",
@@ -201,49 +242,57 @@ template <> constexpr inline auto MainWindow::qt_create_metaobjectdata<qt_meta_t
         // Slot 'onSaveNote'
         QtMocHelpers::SlotData<void()>(6, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onFolderSelected'
-        QtMocHelpers::SlotData<void(QTreeWidgetItem *, int)>(7, 2, QMC::AccessPrivate, QMetaType::Void, {{
-            { 0x80000000 | 8, 9 }, { QMetaType::Int, 10 },
+        QtMocHelpers::SlotData<void(const QModelIndex &)>(7, 2, QMC::AccessPrivate, QMetaType::Void, {{
+            { 0x80000000 | 8, 9 },
         }}),
         // Slot 'onNoteSelected'
-        QtMocHelpers::SlotData<void(QListWidgetItem *)>(11, 2, QMC::AccessPrivate, QMetaType::Void, {{
-            { 0x80000000 | 12, 9 },
+        QtMocHelpers::SlotData<void(const QModelIndex &)>(10, 2, QMC::AccessPrivate, QMetaType::Void, {{
+            { 0x80000000 | 8, 9 },
         }}),
+        // Slot 'onEditorTextChanged'
+        QtMocHelpers::SlotData<void()>(11, 2, QMC::AccessPrivate, QMetaType::Void),
+        // Slot 'onAutosaveTimeout'
+        QtMocHelpers::SlotData<void()>(12, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onAdvancedSearch'
         QtMocHelpers::SlotData<void()>(13, 2, QMC::AccessPrivate, QMetaType::Void),
+        // Slot 'showLiveSearchResults'
+        QtMocHelpers::SlotData<void(const std::vector<int> &, bool)>(14, 2, QMC::AccessPrivate, QMetaType::Void, {{
+            { 0x80000000 | 15, 16 }, { QMetaType::Bool, 17 },
+        }}),
         // Slot 'onShowTrash'
-        QtMocHelpers::SlotData<void()>(14, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(18, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onEmptyTrash'
-        QtMocHelpers::SlotData<void()>(15, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(19, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onShowLogs'
-        QtMocHelpers::SlotData<void()>(16, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(20, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onMoveNote'
-        QtMocHelpers::SlotData<void()>(17, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(21, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onNoteProperties'
-        QtMocHelpers::SlotData<void()>(18, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(22, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onLightTheme'
-        QtMocHelpers::SlotData<void()>(19, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(23, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onDarkTheme'
-        QtMocHelpers::SlotData<void()>(20, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(24, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onSepiaTheme'
-        QtMocHelpers::SlotData<void()>(21, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(25, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onYellowTheme'
-        QtMocHelpers::SlotData<void()>(22, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(26, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'showHotkeys'
-        QtMocHelpers::SlotData<void()>(23, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(27, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'closeLogs'
-        QtMocHelpers::SlotData<void()>(24, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(28, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'openSettings'
-        QtMocHelpers::SlotData<void()>(25, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(29, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'onRenameItem'
-        QtMocHelpers::SlotData<void()>(26, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(30, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'switchToBoardView'
-        QtMocHelpers::SlotData<void()>(27, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(31, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'switchToMainView'
-        QtMocHelpers::SlotData<void()>(28, 2, QMC::AccessPrivate, QMetaType::Void),
+        QtMocHelpers::SlotData<void()>(32, 2, QMC::AccessPrivate, QMetaType::Void),
         // Slot 'applyTheme'
-        QtMocHelpers::SlotData<void(const QColor &, const QColor &, const QString &, const QString &, const QString &)>(29, 2, QMC::AccessPrivate, QMetaType::Void, {{
-            { QMetaType::QColor, 30 }, { QMetaType::QColor, 31 }, { QMetaType::QString, 32 }, { QMetaType::QString, 33 },
-            { QMetaType::QString, 34 },
+        QtMocHelpers::SlotData<void(const QColor &, const QColor &, const QString &, const QString &, const QString &)>(33, 2, QMC::AccessPrivate, QMetaType::Void, {{
+            { QMetaType::QColor, 34 }, { QMetaType::QColor, 35 }, { QMetaType::QString, 36 }, { QMetaType::QString, 37 },
+            { QMetaType::QString, 38 },
         }}),
     };
     QtMocHelpers::UintData qt_properties {
@@ -273,25 +322,28 @@ void MainWindow::qt_static_metacall(QObject *_o, QMetaObject::Call _c, int _id,
         case 2: _t->onNewTag(); break;
         case 3: _t->onDeleteItem(); break;
         case 4: _t->onSaveNote(); break;
-        case 5: _t->onFolderSelected((*reinterpret_cast< std::add_pointer_t<QTreeWidgetItem*>>(_a[1])),(*reinterpret_cast< std::add_pointer_t<int>>(_a[2]))); break;
-        case 6: _t->onNoteSelected((*reinterpret_cast< std::add_pointer_t<QListWidgetItem*>>(_a[1]))); break;
-        case 7: _t->onAdvancedSearch(); break;
-        case 8: _t->onShowTrash(); break;
-        case 9: _t->onEmptyTrash(); break;
-        case 10: _t->onShowLogs(); break;
-        case 11: _t->onMoveNote(); break;
-        case 12: _t->onNoteProperties(); break;
-        case 13: _t->onLightTheme(); break;
-        case 14: _t->onDarkTheme(); break;
-        case 15: _t->onSepiaTheme(); break;
-        case 16: _t->onYellowTheme(); break;
-        case 17: _t->showHotkeys(); break;
-        case 18: _t->closeLogs(); break;
-        case 19: _t->openSettings(); break;
-        case 20: _t->onRenameItem(); break;
-        case 21: _t->switchToBoardView(); break;
-        case 22: _t->switchToMainView(); break;
-        case 23: _t->applyTheme((*reinterpret_cast< std::add_pointer_t<QColor>>(_a[1])),(*reinterpret_cast< std::add_pointer_t<QColor>>(_a[2])),(*reinterpret_cast< std::add_pointer_t<QString>>(_a[3])),(*reinterpret_cast< std::add_pointer_t<QString>>(_a[4])),(*reinterpret_cast< std::add_pointer_t<QString>>(_a[5]))); break;
+        case 5: _t->onFolderSelected((*reinterpret_cast< std::add_pointer_t<QModelIndex>>(_a[1]))); break;
+        case 6: _t->onNoteSelected((*reinterpret_cast< std::add_pointer_t<QModelIndex>>(_a[1]))); break;
+        case 7: _t->onEditorTextChanged(); break;
+        case 8: _t->onAutosaveTimeout(); break;
+        case 9: _t->onAdvancedSearch(); break;
+        case 10: _t->showLiveSearchResults((*reinterpret_cast< std::add_pointer_t<std::vector<int>>>(_a[1])),(*reinterpret_cast< std::add_pointer_t<bool>>(_a[2]))); break;
+        case 11: _t->onShowTrash(); break;
+        case 12: _t->onEmptyTrash(); break;
+        case 13: _t->onShowLogs(); break;
+        case 14: _t->onMoveNote(); break;
+        case 15: _t->onNoteProperties(); break;
+        case 16: _t->onLightTheme(); break;
+        case 17: _t->onDarkTheme(); break;
+        case 18: _t->onSepiaTheme(); break;
+        case 19: _t->onYellowTheme(); break;
+        case 20: _t->showHotkeys(); break;
+        case 21: _t->closeLogs(); break;
+        case 22: _t->openSettings(); break;
+        case 23: _t->onRenameItem(); break;
+        case 24: _t->switchToBoardView(); break;
+        case 25: _t->switchToMainView(); break;
+        case 26: _t->applyTheme((*reinterpret_cast< std::add_pointer_t<QColor>>(_a[1])),(*reinterpret_cast< std::add_pointer_t<QColor>>(_a[2])),(*reinterpret_cast< std::add_pointer_t<QString>>(_a[3])),(*reinterpret_cast< std::add_pointer_t<QString>>(_a[4])),(*reinterpret_cast< std::add_pointer_t<QString>>(_a[5]))); break;
         default: ;
         }
     }
@@ -316,14 +368,14 @@ int MainWindow::qt_metacall(QMetaObject::Call _c, int _id, void **_a)
     if (_id < 0)
         return _id;
     if (_c == QMetaObject::InvokeMetaMethod) {
-        if (_id < 24)
+        if (_id < 27)
             qt_static_metacall(this, _c, _id, _a);
-        _id -= 24;
+        _id -= 27;
     }
     if (_c == QMetaObject::RegisterMethodArgumentMetaType) {
-        if (_id < 24)
+        if (_id < 27)
             *reinterpret_cast<QMetaType *>(_a[0]) = QMetaType();
-        _id -= 24;
+        _id -= 27;
     }
     return _id;
 }
@@ -0,0 +1,115 @@
+/**
+ * @file mpsc_ring.hpp
+ * @brief This file contains the bounded lock-free queue that carries log records to the writer thread.
+ */
+
+#ifndef MPSC_RING_HPP
+#define MPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @class MpscRing
+ * @brief A bounded multi-producer, single-consumer ring buffer that never takes a lock.
+ *
+ * Each cell carries a sequence number that tells producers whether it is free
+ * for the current lap and tells the consumer whether it has been published.
+ * A producer claims a position with one compare-and-swap and publishes it
+ * with a release store; the consumer is the only thread that advances the
+ * read position, so popping needs no read-modify-write at all.
+ *
+ * @tparam T The element type. It must be default-constructible and movable.
+ */
+template <typename T>
+class MpscRing {
+public:
+    /**
+     * @brief Constructs a ring.
+     * @param capacity The number of cells; rounded up to a power of two.
+     */
+    explicit MpscRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        mask = size - 1;
+        cells.reset(new Cell[size]);
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /**
+     * @brief Appends an element. Safe to call from any number of threads.
+     * @param value The element; it is moved from only if the push succeeds.
+     * @return False if the ring is full.
+     */
+    bool tryPush(T&& value) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &cells[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                return false; // The consumer has not freed this cell yet
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest published element. Must only be called from the consumer thread.
+     * @param value Receives the element.
+     * @return False if no element is ready.
+     */
+    bool tryPop(T& value) {
+        const size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        Cell& cell = cells[pos & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        value = std::move(cell.value);
+        cell.sequence.store(pos + mask + 1, std::memory_order_release);
+        dequeue_pos.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Gets the number of positions claimed by producers so far.
+     * @return The total push count, including pushes that are still being published.
+     */
+    size_t pushedCount() const { return enqueue_pos.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Gets the number of elements the consumer has removed so far.
+     * @return The total pop count.
+     */
+    size_t poppedCount() const { return dequeue_pos.load(std::memory_order_acquire); }
+
+    size_t capacity() const { return mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> enqueue_pos{0}; // Contended by producers
+    alignas(64) std::atomic<size_t> dequeue_pos{0}; // Written by the consumer only
+};
+
+#endif // MPSC_RING_HPP
@@ -0,0 +1,61 @@
+/**
+ * @file note_batch.cpp
+ * @brief Implementation of the NoteBatch class. The batch is applied by NoteManager::commitBatch.
+ */
+
+#include "note_batch.hpp"
+
+NoteBatch::NoteBatch(NoteManager& manager) : manager(manager) {}
+
+int NoteBatch::createNote(const std::string& title, const std::string& content,
+                          const std::vector<std::string>& tags, int folder_id) {
+    Operation operation(Operation::Type::CreateNote);
+    // The note takes its ID now so later operations can refer to it; an abandoned batch only skips the ID.
+    operation.created = manager.makeObject<Note>(title, content);
+    operation.note_id = operation.created->getId();
+    operation.folder_id = folder_id;
+    operation.tags = tags;
+    operations.push_back(std::move(operation));
+    return operations.back().note_id;
+}
+
+void NoteBatch::editNote(int note_id, const std::string& new_title, const std::string& new_content) {
+    Operation operation(Operation::Type::EditNote);
+    operation.note_id = note_id;
+    operation.title = new_title;
+    operation.content = new_content;
+    operations.push_back(std::move(operation));
+}
+
+void NoteBatch::moveNote(int note_id, int new_folder_id) {
+    Operation operation(Operation::Type::MoveNote);
+    operation.note_id = note_id;
+    operation.folder_id = new_folder_id;
+    operations.push_back(std::move(operation));
+}
+
+void NoteBatch::addTagToNote(int note_id, const std::string& tag_name) {
+    Operation operation(Operation::Type::AddTag);
+    operation.note_id = note_id;
+    operation.tags.push_back(tag_name);
+    operations.push_back(std::move(operation));
+}
+
+void NoteBatch::deleteNote(int note_id, bool permanent) {
+    Operation operation(Operation::Type::DeleteNote);
+    operation.note_id = note_id;
+    operation.permanent = permanent;
+    operations.push_back(std::move(operation));
+}
+
+bool NoteBatch::commit() {
+    error.clear();
+    const bool applied = manager.commitBatch(*this);
+    operations.clear();
+    return applied;
+}
+
+void NoteBatch::clear() {
+    operations.clear();
+    error.clear();
+}
@@ -0,0 +1,130 @@
+/**
+ * @file note_batch.hpp
+ * @brief This file contains the declaration of the NoteBatch class.
+ */
+
+#ifndef NOTE_BATCH_HPP
+#define NOTE_BATCH_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "notes.hpp"
+
+/**
+ * @class NoteBatch
+ * @brief Collects note operations and applies them to a NoteManager as one transaction.
+ *
+ * Nothing is changed until commit(). commit() first checks every operation
+ * against the notes as they will be at that point of the batch; if one would
+ * fail, nothing is applied. Otherwise the operations run back to back with
+ * the indexes, the storage and the folder observers held back, followed by
+ * one index update per touched note, one storage write per touched note plus
+ * a single sync, and one reset/folderChanged notification per touched folder.
+ * If applying an operation throws, the touched notes and folders are put back
+ * as they were before the exception propagates; tags created on the way stay.
+ *
+ * @code
+ * NoteBatch batch(manager);
+ * int id = batch.createNote("Title", "Body", {"draft"});
+ * batch.addTagToNote(id, "imported");
+ * if (!batch.commit()) std::cerr << batch.getError() << std::endl;
+ * @endcode
+ */
+class NoteBatch {
+    friend class NoteManager;
+
+public:
+    /**
+     * @brief Constructs an empty batch for a manager.
+     * @param manager The manager the batch is committed to; must outlive the batch.
+     */
+    explicit NoteBatch(NoteManager& manager);
+
+    /**
+     * @brief Queues the creation of a note.
+     * @param title The title of the note.
+     * @param content The content of the note.
+     * @param tags The tags to attach; missing tags are created on commit.
+     * @param folder_id The destination folder, or 0 for the manager's current folder.
+     * @return The ID the note will have. Later operations of the batch may use it.
+     */
+    int createNote(const std::string& title, const std::string& content,
+                   const std::vector<std::string>& tags = {}, int folder_id = 0);
+
+    /**
+     * @brief Queues an edit of a note's title and content.
+     * @param note_id The ID of the note.
+     * @param new_title The new title.
+     * @param new_content The new content.
+     */
+    void editNote(int note_id, const std::string& new_title, const std::string& new_content);
+
+    /**
+     * @brief Queues moving a note to another folder.
+     * @param note_id The ID of the note.
+     * @param new_folder_id The ID of the destination folder.
+     */
+    void moveNote(int note_id, int new_folder_id);
+
+    /**
+     * @brief Queues adding a tag to a note; the tag is created on commit if needed.
+     * @param note_id The ID of the note.
+     * @param tag_name The name of the tag.
+     */
+    void addTagToNote(int note_id, const std::string& tag_name);
+
+    /**
+     * @brief Queues deleting a note.
+     * @param note_id The ID of the note.
+     * @param permanent If true, the note is removed; otherwise it is moved to the trash.
+     */
+    void deleteNote(int note_id, bool permanent = false);
+
+    /**
+     * @brief Gets the number of queued operations.
+     */
+    size_t size() const { return operations.size(); }
+
+    /**
+     * @brief Applies every queued operation, or none of them.
+     * The batch is emptied either way.
+     * @return True if the batch was applied, false if an operation was rejected.
+     */
+    bool commit();
+
+    /**
+     * @brief Drops the queued operations without applying them.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the reason the last commit() was rejected.
+     * @return The error message, or an empty string if the last commit succeeded.
+     */
+    const std::string& getError() const { return error; }
+
+private:
+    /**
+     * @struct Operation
+     * @brief One queued operation; the fields used depend on the type.
+     */
+    struct Operation {
+        enum class Type { CreateNote, EditNote, MoveNote, AddTag, DeleteNote };
+        explicit Operation(Type type) : type(type) {}
+        Type type;
+        int note_id = 0;
+        int folder_id = 0;
+        std::string title;
+        std::string content;
+        std::vector<std::string> tags;
+        bool permanent = false;
+        std::shared_ptr<Note> created; // CreateNote only: the note, not yet in any folder or index
+    };
+
+    NoteManager& manager;
+    std::vector<Operation> operations;
+    std::string error;
+};
+
+#endif // NOTE_BATCH_HPP
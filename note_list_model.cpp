@@ -0,0 +1,132 @@
+/**
+ * @file note_list_model.cpp
+ * @brief Implementation of the NoteListModel class.
+ */
+
+#include "note_list_model.hpp"
+
+#include <QDateTime>
+
+NoteListModel::NoteListModel(QObject* parent) : QAbstractListModel(parent) {}
+
+NoteListModel::~NoteListModel() {
+    detach();
+}
+
+void NoteListModel::detach() {
+    if (current_folder) {
+        current_folder->removeObserver(this);
+        current_folder.reset();
+    }
+}
+
+void NoteListModel::setFolder(const std::shared_ptr<Folder>& folder) {
+    beginResetModel();
+    detach();
+    fixed_notes.clear();
+    current_folder = folder;
+    if (current_folder) {
+        current_folder->addObserver(this);
+    }
+    row_count = static_cast<int>(rows().size());
+    endResetModel();
+}
+
+void NoteListModel::setNotes(std::vector<std::shared_ptr<Note>> notes) {
+    beginResetModel();
+    detach();
+    fixed_notes = std::move(notes);
+    row_count = static_cast<int>(fixed_notes.size());
+    endResetModel();
+}
+
+void NoteListModel::appendNotes(const std::vector<std::shared_ptr<Note>>& notes) {
+    if (current_folder || notes.empty()) {
+        return;
+    }
+    const int first = static_cast<int>(fixed_notes.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(notes.size()) - 1);
+    fixed_notes.insert(fixed_notes.end(), notes.begin(), notes.end());
+    row_count = static_cast<int>(fixed_notes.size());
+    endInsertRows();
+}
+
+const std::vector<std::shared_ptr<Note>>& NoteListModel::rows() const {
+    return current_folder ? current_folder->getNoteList() : fixed_notes;
+}
+
+std::shared_ptr<Note> NoteListModel::noteAt(const QModelIndex& index) const {
+    const auto& notes = rows();
+    if (!index.isValid() || index.row() < 0 || static_cast<size_t>(index.row()) >= notes.size()) {
+        return nullptr;
+    }
+    return notes[static_cast<size_t>(index.row())];
+}
+
+QModelIndex NoteListModel::indexOfNote(int note_id) const {
+    const auto& notes = rows();
+    for (size_t row = 0; row < notes.size(); ++row) {
+        if (notes[row]->getId() == note_id) {
+            return index(static_cast<int>(row));
+        }
+    }
+    return QModelIndex();
+}
+
+int NoteListModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : row_count;
+}
+
+QVariant NoteListModel::data(const QModelIndex& index, int role) const {
+    auto note = noteAt(index);
+    if (!note) {
+        return QVariant();
+    }
+    switch (role) {
+        case Qt::DisplayRole: {
+            const std::string_view title = note->getTitleView();
+            return QString::fromUtf8(title.data(), static_cast<int>(title.size()));
+        }
+        case Qt::ToolTipRole:
+            return tr("Modified: %1").arg(
+                QDateTime::fromSecsSinceEpoch(note->getLastModifiedDate()).toString("yyyy-MM-dd hh:mm"));
+        case NoteIdRole:
+            return note->getId();
+        default:
+            return QVariant();
+    }
+}
+
+// --- FolderObserver ---
+
+void NoteListModel::noteAboutToBeAdded(const Folder&, size_t row) {
+    beginInsertRows(QModelIndex(), static_cast<int>(row), static_cast<int>(row));
+}
+
+void NoteListModel::noteAdded(const Folder&, size_t) {
+    ++row_count;
+    endInsertRows();
+}
+
+void NoteListModel::noteAboutToBeRemoved(const Folder&, size_t row) {
+    beginRemoveRows(QModelIndex(), static_cast<int>(row), static_cast<int>(row));
+}
+
+void NoteListModel::noteRemoved(const Folder&, size_t) {
+    --row_count;
+    endRemoveRows();
+}
+
+void NoteListModel::noteChanged(const Folder&, size_t row) {
+    const QModelIndex changed = index(static_cast<int>(row));
+    emit dataChanged(changed, changed, {Qt::DisplayRole, Qt::ToolTipRole});
+}
+
+void NoteListModel::notesAboutToBeReset(const Folder&) {
+    beginResetModel();
+}
+
+void NoteListModel::notesReset(const Folder&) {
+    row_count = static_cast<int>(rows().size());
+    endResetModel();
+}
@@ -0,0 +1,117 @@
+/**
+ * @file note_list_model.hpp
+ * @brief This file contains the declaration of the NoteListModel class.
+ */
+
+#ifndef NOTE_LIST_MODEL_HPP
+#define NOTE_LIST_MODEL_HPP
+
+#include <QAbstractListModel>
+#include <memory>
+#include <vector>
+#include "notes.hpp"
+
+/**
+ * @class NoteListModel
+ * @brief A list model that shows the notes of one folder, or a fixed list of search results.
+ *
+ * In folder mode the model reads rows straight from Folder::getNoteList() and
+ * observes the folder, so note insertions, removals and edits become single
+ * row signals instead of a full reload; a committed NoteBatch arrives as one
+ * model reset. Nothing is created per row: a view only asks for the rows it
+ * paints.
+ */
+class NoteListModel : public QAbstractListModel, public FolderObserver {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Extra item data roles.
+     */
+    enum Role {
+        NoteIdRole = Qt::UserRole + 1 ///< The note ID, as an int.
+    };
+
+    /**
+     * @brief Constructs an empty NoteListModel.
+     * @param parent The parent object.
+     */
+    explicit NoteListModel(QObject* parent = nullptr);
+
+    /**
+     * @brief Detaches the model from the observed folder.
+     */
+    ~NoteListModel() override;
+
+    /**
+     * @brief Shows the notes of a folder and follows its changes.
+     * @param folder The folder to show, or nullptr for an empty list.
+     */
+    void setFolder(const std::shared_ptr<Folder>& folder);
+
+    /**
+     * @brief Shows a fixed list of notes, such as search results. The list is not updated afterwards.
+     * @param notes The notes to show.
+     */
+    void setNotes(std::vector<std::shared_ptr<Note>> notes);
+
+    /**
+     * @brief Adds notes at the end of a fixed list, such as the next page of search results.
+     * Does nothing while the model shows a folder.
+     * @param notes The notes to add.
+     */
+    void appendNotes(const std::vector<std::shared_ptr<Note>>& notes);
+
+    /**
+     * @brief Gets the folder shown by the model.
+     * @return The folder, or nullptr when showing a fixed list.
+     */
+    std::shared_ptr<Folder> folder() const { return current_folder; }
+
+    /**
+     * @brief Gets the fixed list shown by the model.
+     * @return The notes, or an empty list while the model shows a folder.
+     */
+    const std::vector<std::shared_ptr<Note>>& fixedNotes() const { return fixed_notes; }
+
+    /**
+     * @brief Gets the note shown at an index.
+     * @param index A model index.
+     * @return The note, or nullptr if the index is invalid.
+     */
+    std::shared_ptr<Note> noteAt(const QModelIndex& index) const;
+
+    /**
+     * @brief Finds the index showing a note.
+     * @param note_id The ID of the note.
+     * @return The index, or an invalid index if the note is not shown.
+     */
+    QModelIndex indexOfNote(int note_id) const;
+
+    // --- QAbstractListModel ---
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    // --- FolderObserver ---
+    void noteAboutToBeAdded(const Folder& folder, size_t row) override;
+    void noteAdded(const Folder& folder, size_t row) override;
+    void noteAboutToBeRemoved(const Folder& folder, size_t row) override;
+    void noteRemoved(const Folder& folder, size_t row) override;
+    void noteChanged(const Folder& folder, size_t row) override;
+    void notesAboutToBeReset(const Folder& folder) override;
+    void notesReset(const Folder& folder) override;
+
+private:
+    /**
+     * @brief Gets the notes currently shown, from the folder or the fixed list.
+     */
+    const std::vector<std::shared_ptr<Note>>& rows() const;
+
+    void detach();
+
+    std::shared_ptr<Folder> current_folder;
+    std::vector<std::shared_ptr<Note>> fixed_notes;
+    int row_count = 0; // Updated between begin/end row notifications, as views expect
+};
+
+#endif // NOTE_LIST_MODEL_HPP
@@ -0,0 +1,113 @@
+/**
+ * @file note_snapshot.cpp
+ * @brief Implementation of NoteSnapshot and SnapshotStore.
+ */
+
+#include "note_snapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+bool NoteRecord::hasTag(const std::string& tag_name) const {
+    return std::find(tags.begin(), tags.end(), tag_name) != tags.end();
+}
+
+// --- NoteSnapshot ---
+
+std::vector<std::shared_ptr<const NoteRecord>> NoteSnapshot::notesInFolder(int folder_id) const {
+    std::vector<std::shared_ptr<const NoteRecord>> result;
+    note_table.forEach([&](const std::shared_ptr<const NoteRecord>& note) {
+        if (note->folder_id == folder_id) {
+            result.push_back(note);
+        }
+    });
+    return result;
+}
+
+std::pair<std::vector<std::shared_ptr<const NoteRecord>>, std::vector<std::shared_ptr<const FolderRecord>>>
+NoteSnapshot::trashContents() const {
+    std::pair<std::vector<std::shared_ptr<const NoteRecord>>, std::vector<std::shared_ptr<const FolderRecord>>> result;
+    note_table.forEach([&](const std::shared_ptr<const NoteRecord>& note) {
+        if (note->in_trash) {
+            result.first.push_back(note);
+        }
+    });
+    folder_table.forEach([&](const std::shared_ptr<const FolderRecord>& folder) {
+        if (folder->in_trash) {
+            result.second.push_back(folder);
+        }
+    });
+    return result;
+}
+
+// --- SnapshotStore::Writer ---
+
+std::shared_ptr<const NoteRecord> SnapshotStore::Writer::findNote(int id) const {
+    return store.staged_notes.find(id);
+}
+
+std::shared_ptr<const FolderRecord> SnapshotStore::Writer::findFolder(int id) const {
+    return store.staged_folders.find(id);
+}
+
+void SnapshotStore::Writer::putNote(NoteRecord record) {
+    const int id = record.id;
+    store.staged_notes.put(id, std::make_shared<const NoteRecord>(std::move(record)), store.staged_version);
+    store.dirty = true;
+}
+
+bool SnapshotStore::Writer::removeNote(int id) {
+    const bool removed = store.staged_notes.erase(id, store.staged_version);
+    store.dirty = store.dirty || removed;
+    return removed;
+}
+
+void SnapshotStore::Writer::putFolder(FolderRecord record) {
+    const int id = record.id;
+    store.staged_folders.put(id, std::make_shared<const FolderRecord>(std::move(record)), store.staged_version);
+    store.dirty = true;
+}
+
+bool SnapshotStore::Writer::removeFolder(int id) {
+    const bool removed = store.staged_folders.erase(id, store.staged_version);
+    store.dirty = store.dirty || removed;
+    return removed;
+}
+
+void SnapshotStore::Writer::clear() {
+    store.staged_notes = ChunkedTable<NoteRecord>();
+    store.staged_folders = ChunkedTable<FolderRecord>();
+    store.dirty = true;
+}
+
+// --- SnapshotStore ---
+
+SnapshotStore::SnapshotStore() : published(std::make_shared<const NoteSnapshot>()) {}
+
+std::shared_ptr<const NoteSnapshot> SnapshotStore::current() const {
+    return std::atomic_load(&published);
+}
+
+uint64_t SnapshotStore::publish() {
+    if (!dirty) {
+        return staged_version - 1;
+    }
+    auto snapshot = std::make_shared<NoteSnapshot>();
+    snapshot->version_number = staged_version;
+    snapshot->note_table = staged_notes;
+    snapshot->folder_table = staged_folders;
+    std::atomic_store(&published, std::shared_ptr<const NoteSnapshot>(std::move(snapshot)));
+    // Freeze every chunk the new version references; later writes clone them.
+    ++staged_version;
+    dirty = false;
+    return staged_version - 1;
+}
+
+void SnapshotStore::discardStaged() {
+    // Chunks written under staged_version are referenced only by the staged tables,
+    // so dropping them restores the last published state.
+    auto snapshot = std::atomic_load(&published);
+    staged_notes = snapshot->note_table;
+    staged_folders = snapshot->folder_table;
+    dirty = false;
+}
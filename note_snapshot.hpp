@@ -0,0 +1,275 @@
+/**
+ * @file note_snapshot.hpp
+ * @brief Immutable, versioned snapshots of the note/folder graph for lock-free readers.
+ */
+
+#ifndef NOTE_SNAPSHOT_HPP
+#define NOTE_SNAPSHOT_HPP
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct NoteRecord
+ * @brief An immutable copy of a note as seen by snapshot readers.
+ */
+struct NoteRecord {
+    int id = 0;
+    int folder_id = 0; ///< ID of the containing folder, 0 if the note is not in a folder.
+    std::string title;
+    std::shared_ptr<const std::string> content; ///< Shared between versions while the body is unchanged.
+    std::vector<std::string> tags;
+    time_t creation_date = 0;
+    time_t last_modified_date = 0;
+    bool in_trash = false;
+    uint64_t content_revision = 0; ///< Note::getContentRevision() when `content` was copied.
+
+    /**
+     * @brief Checks if the note carries a tag.
+     * @param tag_name The tag name.
+     * @return True if the tag is in `tags`.
+     */
+    bool hasTag(const std::string& tag_name) const;
+};
+
+/**
+ * @struct FolderRecord
+ * @brief An immutable copy of a folder as seen by snapshot readers.
+ */
+struct FolderRecord {
+    int id = 0;
+    int parent_id = 0; ///< ID of the parent folder, 0 for a top-level folder.
+    std::string name;
+    bool in_trash = false;
+};
+
+/**
+ * @class ChunkedTable
+ * @brief A persistent ID-to-record table made of fixed-size chunks shared between versions.
+ *
+ * IDs are split into a chunk index (id / CHUNK_SIZE) and a slot. Copying a
+ * table copies only the chunk pointers, and a write clones just the chunk it
+ * touches, so publishing a version costs one pointer per CHUNK_SIZE IDs plus
+ * the chunks written since the previous version. A chunk is written in place
+ * only while its generation matches the unpublished one; once a version is
+ * published every chunk it references is frozen.
+ */
+template <typename T>
+class ChunkedTable {
+public:
+    static constexpr size_t CHUNK_BITS = 8;
+    static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+
+    /**
+     * @brief Finds a record.
+     * @param id The record ID.
+     * @return The record, or nullptr if there is none.
+     */
+    std::shared_ptr<const T> find(int id) const {
+        if (id < 0) return nullptr;
+        const size_t index = static_cast<size_t>(id) >> CHUNK_BITS;
+        if (index >= chunks.size() || !chunks[index]) return nullptr;
+        return chunks[index]->slots[static_cast<size_t>(id) & (CHUNK_SIZE - 1)];
+    }
+
+    /**
+     * @brief Gets the number of records.
+     */
+    size_t size() const { return entry_count; }
+
+    /**
+     * @brief Calls fn(const std::shared_ptr<const T>&) for every record, in ID order.
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& chunk : chunks) {
+            if (!chunk) continue;
+            for (const auto& slot : chunk->slots) {
+                if (slot) fn(slot);
+            }
+        }
+    }
+
+private:
+    friend class SnapshotStore;
+
+    struct Chunk {
+        uint64_t generation = 0;
+        size_t used = 0;
+        std::array<std::shared_ptr<const T>, CHUNK_SIZE> slots;
+    };
+
+    /**
+     * @brief Gets a chunk that may be written under the given generation, cloning a frozen one.
+     */
+    Chunk& writableChunk(size_t index, uint64_t generation) {
+        if (index >= chunks.size()) {
+            chunks.resize(index + 1);
+        }
+        auto& chunk = chunks[index];
+        if (!chunk) {
+            chunk = std::make_shared<Chunk>();
+            chunk->generation = generation;
+        } else if (chunk->generation != generation) {
+            auto copy = std::make_shared<Chunk>(*chunk);
+            copy->generation = generation;
+            chunk = std::move(copy);
+        }
+        return *chunk;
+    }
+
+    void put(int id, std::shared_ptr<const T> value, uint64_t generation) {
+        if (id < 0 || !value) return;
+        Chunk& chunk = writableChunk(static_cast<size_t>(id) >> CHUNK_BITS, generation);
+        auto& slot = chunk.slots[static_cast<size_t>(id) & (CHUNK_SIZE - 1)];
+        if (!slot) {
+            ++chunk.used;
+            ++entry_count;
+        }
+        slot = std::move(value);
+    }
+
+    bool erase(int id, uint64_t generation) {
+        if (!find(id)) return false;
+        const size_t index = static_cast<size_t>(id) >> CHUNK_BITS;
+        Chunk& chunk = writableChunk(index, generation);
+        chunk.slots[static_cast<size_t>(id) & (CHUNK_SIZE - 1)].reset();
+        --entry_count;
+        if (--chunk.used == 0) {
+            chunks[index].reset();
+        }
+        return true;
+    }
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    size_t entry_count = 0;
+};
+
+/**
+ * @class NoteSnapshot
+ * @brief One published version of the note/folder graph. Never modified after publication.
+ *
+ * A snapshot can be read from any thread without locking, for as long as the
+ * reader holds the shared_ptr, while writers go on publishing newer versions.
+ */
+class NoteSnapshot {
+public:
+    /**
+     * @brief Gets the version number. Later publications have larger numbers.
+     */
+    uint64_t version() const { return version_number; }
+
+    const ChunkedTable<NoteRecord>& notes() const { return note_table; }
+    const ChunkedTable<FolderRecord>& folders() const { return folder_table; }
+
+    std::shared_ptr<const NoteRecord> findNote(int id) const { return note_table.find(id); }
+    std::shared_ptr<const FolderRecord> findFolder(int id) const { return folder_table.find(id); }
+
+    /**
+     * @brief Gets the notes directly inside a folder, in ID order.
+     * @param folder_id The folder ID.
+     * @return The notes of the folder.
+     */
+    std::vector<std::shared_ptr<const NoteRecord>> notesInFolder(int folder_id) const;
+
+    /**
+     * @brief Gets the notes and folders marked as trashed, in ID order.
+     * @return A pair of the trashed notes and the trashed folders.
+     */
+    std::pair<std::vector<std::shared_ptr<const NoteRecord>>, std::vector<std::shared_ptr<const FolderRecord>>>
+    trashContents() const;
+
+private:
+    friend class SnapshotStore;
+
+    uint64_t version_number = 0;
+    ChunkedTable<NoteRecord> note_table;
+    ChunkedTable<FolderRecord> folder_table;
+};
+
+/**
+ * @class SnapshotStore
+ * @brief Stages changes to the graph and publishes them atomically as NoteSnapshot versions.
+ *
+ * Writers go through update(), which serializes them, applies every change
+ * made by the callback and then swaps in the new version with a single atomic
+ * store. Readers call current() and never block writers or each other. If the
+ * callback throws, its changes are discarded and the current version stays.
+ */
+class SnapshotStore {
+public:
+    /**
+     * @class Writer
+     * @brief The handle passed to update() callbacks. Reads see the changes staged so far.
+     */
+    class Writer {
+    public:
+        std::shared_ptr<const NoteRecord> findNote(int id) const;
+        std::shared_ptr<const FolderRecord> findFolder(int id) const;
+        void putNote(NoteRecord record);
+        bool removeNote(int id);
+        void putFolder(FolderRecord record);
+        bool removeFolder(int id);
+
+        /**
+         * @brief Removes every note and folder.
+         */
+        void clear();
+
+    private:
+        friend class SnapshotStore;
+        explicit Writer(SnapshotStore& store) : store(store) {}
+        SnapshotStore& store;
+    };
+
+    /**
+     * @brief Constructs a store whose current version is an empty version 0.
+     */
+    SnapshotStore();
+
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    /**
+     * @brief Gets the latest published version. Safe to call from any thread.
+     * @return The snapshot; never nullptr.
+     */
+    std::shared_ptr<const NoteSnapshot> current() const;
+
+    /**
+     * @brief Runs fn(Writer&) under the writer lock and publishes its changes as one version.
+     * @param fn The callback making the changes.
+     * @return The version number current after the update; unchanged if fn changed nothing.
+     */
+    template <typename Fn>
+    uint64_t update(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        Writer writer(*this);
+        try {
+            fn(writer);
+        } catch (...) {
+            discardStaged();
+            throw;
+        }
+        return publish();
+    }
+
+private:
+    uint64_t publish();
+    void discardStaged();
+
+    std::mutex write_mutex;
+    ChunkedTable<NoteRecord> staged_notes;     // Guarded by write_mutex
+    ChunkedTable<FolderRecord> staged_folders; // Guarded by write_mutex
+    uint64_t staged_version = 1;               // Generation of chunks written since the last publish
+    bool dirty = false;
+    std::shared_ptr<const NoteSnapshot> published; // Accessed only through std::atomic_load/atomic_store
+};
+
+#endif // NOTE_SNAPSHOT_HPP
@@ -0,0 +1,1609 @@
+/**
+ * @file notes.cpp
+ * @brief Implementation of the NoteManager search paths and index maintenance.
+ */
+
+#include "notes.hpp"
+
+#include "background_storage.hpp"
+#include "file_storage.hpp"
+#include "journal_storage.hpp"
+#include "delta_codec.hpp"
+#include "note_batch.hpp"
+#include "text_count.hpp"
+
+#include <cassert>
+#include <functional>
+#include <limits>
+
+namespace {
+
+/**
+ * @brief Converts a filesystem timestamp to time_t (C++17 has no clock_cast).
+ */
+time_t toTimeT(std::filesystem::file_time_type file_time) {
+    auto system_time = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+        file_time - std::filesystem::file_time_type::clock::now() + std::chrono::system_clock::now());
+    return std::chrono::system_clock::to_time_t(system_time);
+}
+
+/**
+ * @brief Gets the pieces of a note body in order, without copying or flattening it.
+ */
+std::vector<std::string_view> contentChunks(const Note& note) {
+    std::vector<std::string_view> chunks;
+    note.forEachContentChunk([&chunks](std::string_view chunk) { chunks.push_back(chunk); });
+    return chunks;
+}
+
+/**
+ * @brief Copies a note body into a new string, piece by piece.
+ */
+std::string copyContent(const Note& note) {
+    std::string content;
+    content.reserve(note.getContentSize());
+    note.forEachContentChunk([&content](std::string_view chunk) { content.append(chunk.data(), chunk.size()); });
+    return content;
+}
+
+std::vector<std::string> tagNames(const Note& note) {
+    std::vector<std::string> names;
+    names.reserve(note.getTagList().size());
+    for (const auto& tag : note.getTagList()) {
+        names.emplace_back(tag->getNameView());
+    }
+    return names;
+}
+
+StoredNote toStoredNote(const Note& note, int folder_id) {
+    StoredNote stored;
+    stored.id = note.getId();
+    stored.folder_id = folder_id;
+    stored.title = note.getTitleView();
+    stored.content = copyContent(note);
+    stored.tags = tagNames(note);
+    stored.creation_date = note.getCreationDate();
+    stored.last_modified_date = note.getLastModifiedDate();
+    stored.in_trash = note.isInTrash();
+    return stored;
+}
+
+/**
+ * @brief Stages the current state of a note in a snapshot update, keeping the
+ * previous version's content buffer when the body did not change.
+ */
+void stageNote(SnapshotStore::Writer& writer, const Note& note) {
+    NoteRecord record;
+    record.id = note.getId();
+    auto folder = note.getParentFolder();
+    record.folder_id = folder ? folder->getId() : 0;
+    record.title = note.getTitleView();
+    record.creation_date = note.getCreationDate();
+    record.last_modified_date = note.getLastModifiedDate();
+    record.content_revision = note.getContentRevision();
+    // Tag and move updates restage the note too: decide from metadata whether the body changed, without reading it.
+    // The revision covers edits in place; the size and date also catch a wholesale setContent().
+    auto previous = writer.findNote(record.id);
+    if (previous && previous->content && previous->content_revision == record.content_revision &&
+        previous->last_modified_date == record.last_modified_date &&
+        previous->content->size() == note.getContentSize()) {
+        record.content = previous->content;
+    } else {
+        record.content = std::make_shared<const std::string>(copyContent(note));
+    }
+    record.tags = tagNames(note);
+    record.in_trash = note.isInTrash();
+    writer.putNote(std::move(record));
+}
+
+void stageFolder(SnapshotStore::Writer& writer, const Folder& folder) {
+    FolderRecord record;
+    record.id = folder.getId();
+    auto parent = folder.getParent();
+    record.parent_id = parent ? parent->getId() : 0;
+    record.name = folder.getNameView();
+    record.in_trash = folder.isInTrash();
+    writer.putFolder(std::move(record));
+}
+
+/**
+ * @brief Restores ID order after iterating a hash index, which has no defined order.
+ */
+void sortById(std::vector<std::shared_ptr<Note>>& notes) {
+    std::sort(notes.begin(), notes.end(),
+              [](const std::shared_ptr<Note>& a, const std::shared_ptr<Note>& b) { return a->getId() < b->getId(); });
+}
+
+/**
+ * @brief Checks whether a folder is the given ancestor or lies below it, by following parent links.
+ */
+bool isWithin(std::shared_ptr<const Folder> folder, const Folder* ancestor) {
+    for (; folder; folder = folder->getParent()) {
+        if (folder.get() == ancestor) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Looks for a fragment in a note body piece by piece, so large bodies are scanned without being copied.
+ */
+bool contentContainsIgnoreCase(const Note& note, const std::string& fragment) {
+    if (fragment.empty()) {
+        return true;
+    }
+    bool found = false;
+    std::string seam_tail; // The last fragment.size() - 1 bytes seen, for matches that straddle two pieces
+    note.forEachContentChunk([&](std::string_view chunk) {
+        if (found || chunk.empty()) {
+            return;
+        }
+        if (!seam_tail.empty()) {
+            std::string seam = seam_tail;
+            seam.append(chunk.data(), std::min(chunk.size(), fragment.size() - 1));
+            found = TrigramIndex::containsIgnoreCase(seam, fragment);
+        }
+        found = found || TrigramIndex::containsIgnoreCase(chunk, fragment);
+        seam_tail.append(chunk.data(), chunk.size());
+        if (seam_tail.size() >= fragment.size()) {
+            seam_tail.erase(0, seam_tail.size() - (fragment.size() - 1));
+        }
+    });
+    return found;
+}
+
+/**
+ * @brief Checks whether a note's title or body contains a fragment, ignoring case.
+ */
+bool noteContainsIgnoreCase(const Note& note, const std::string& fragment) {
+    return TrigramIndex::containsIgnoreCase(note.getTitleView(), fragment) || contentContainsIgnoreCase(note, fragment);
+}
+
+/**
+ * @brief Formats a search bound for QueryPlan descriptions.
+ */
+std::string formatSearchDate(time_t time) {
+    char buffer[32];
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &time);
+#else
+    localtime_r(&time, &local);
+#endif
+    return std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M", &local) ? buffer : std::to_string(time);
+}
+
+} // namespace
+
+// --- Note ---
+
+void Note::deferContent(const std::string& file_path, uint64_t offset) {
+    ++content_revision;
+    content.clear();
+    large_content.reset();
+    deferred_content_path = file_path;
+    deferred_content_offset = offset;
+}
+
+void Note::ensureContentLoaded() const {
+    if (deferred_content_path.empty()) {
+        return;
+    }
+    NOTES_TIME_OPERATION("load.note_body");
+    content = ParallelDirectoryWalker::readBody(deferred_content_path, deferred_content_offset);
+    deferred_content_path.clear();
+    // Notes are always heap objects created through make_shared<Note>, never const objects.
+    const_cast<Note*>(this)->updateMetadata();
+}
+
+void Note::updateMetadata() {
+    const TextCounts counts = countText(content.data(), content.size());
+    word_count = static_cast<int>(counts.words);
+    char_count = static_cast<int>(counts.chars);
+}
+
+std::string_view Note::getContentView() const {
+    assert(!large_content && "getContentView() on a piece-table body: use forEachContentChunk() or flattenContent()");
+    ensureContentLoaded();
+    return content;
+}
+
+void Note::flattenContent() {
+    if (!large_content) {
+        return;
+    }
+    NOTES_TIME_OPERATION("note.flatten");
+    content = large_content->toString();
+    large_content.reset();
+}
+
+bool Note::contentEquals(std::string_view text) const {
+    if (getContentSize() != text.size()) {
+        return false;
+    }
+    bool equal = true;
+    size_t offset = 0;
+    forEachContentChunk([&](std::string_view chunk) {
+        equal = equal && text.compare(offset, chunk.size(), chunk) == 0;
+        offset += chunk.size();
+    });
+    return equal;
+}
+
+size_t Note::getContentSize() const {
+    if (large_content) {
+        return large_content->size();
+    }
+    ensureContentLoaded();
+    return content.size();
+}
+
+void Note::replaceRange(size_t begin, size_t end, const std::string& text) {
+    if (large_content) {
+        if (large_content.use_count() > 1) {
+            large_content = std::make_shared<PieceTable>(*large_content); // A copy of this note shares it
+        }
+    } else {
+        ensureContentLoaded();
+        if (content.size() >= LARGE_CONTENT_THRESHOLD) {
+            large_content = std::make_shared<PieceTable>(std::move(content));
+            content.clear();
+        }
+    }
+    const size_t size = getContentSize();
+    const auto byteAt = [this](size_t i) { return large_content ? large_content->at(i) : content[i]; };
+    const auto countWindow = [this](size_t from, size_t to) {
+        if (large_content) {
+            const std::string window = large_content->substr(from, to - from);
+            return countText(window.data(), window.size());
+        }
+        return countText(content.data() + from, to - from);
+    };
+
+    begin = std::min(begin, size);
+    end = std::max(begin, std::min(end, size));
+    // Word boundaries can only move inside the words touching the edit, so recount just that window.
+    size_t window_begin = begin;
+    while (window_begin > 0 && !isTextSpace(byteAt(window_begin - 1))) --window_begin;
+    size_t window_end = end;
+    while (window_end < size && !isTextSpace(byteAt(window_end))) ++window_end;
+    const TextCounts before = countWindow(window_begin, window_end);
+
+    if (large_content) {
+        large_content->replace(begin, end - begin, text);
+    } else {
+        content.replace(begin, end - begin, text);
+    }
+    const TextCounts after = countWindow(window_begin, window_end - (end - begin) + text.size());
+
+    word_count += static_cast<int>(after.words) - static_cast<int>(before.words);
+    char_count += static_cast<int>(after.chars) - static_cast<int>(before.chars);
+    last_modified_date = std::time(nullptr);
+    ++content_revision;
+}
+
+void Note::addVersion(const NoteVersion& version) {
+    if (!history.empty() && (history.size() - 1) % NoteVersion::KEYFRAME_INTERVAL != 0) {
+        std::shared_ptr<NoteVersion::Data>& previous = history.back().data;
+        // A copy of this note (the batch undo copy, say) shares the Data. If that copy already
+        // appended its own version, the payload is a delta against it and must stay as it is.
+        if (!previous->newer) {
+            std::string rebuilt;
+            const std::string* newer_text = &version.data->payload;
+            if (version.data->newer) {
+                rebuilt = version.getContent();
+                newer_text = &rebuilt;
+            }
+            std::string delta = delta_codec::encode(*newer_text, previous->payload);
+            if (delta.size() < previous->payload.size()) {
+                if (previous.use_count() > 1) {
+                    // Leave the copies their full text and give this history its own entry.
+                    previous = std::make_shared<NoteVersion::Data>();
+                }
+                previous->payload = std::move(delta);
+                previous->newer = version.data;
+            }
+        }
+    }
+    history.push_back(version);
+}
+
+std::shared_ptr<Folder> Note::getParentFolder() const {
+    return parent_folder.lock();
+}
+
+// --- Folder ---
+
+void Folder::addNote(std::shared_ptr<Note> note) {
+    if (!note) return;
+    const size_t row = notes.size();
+    if (!rows_suspended) {
+        for (FolderObserver* observer : observers) observer->noteAboutToBeAdded(*this, row);
+    }
+    note->parent_folder = weak_from_this();
+    notes.push_back(std::move(note));
+    if (!rows_suspended) {
+        for (FolderObserver* observer : observers) observer->noteAdded(*this, row);
+    }
+    adjustTotalNoteCount(1);
+}
+
+std::shared_ptr<Note> Folder::removeNote(int note_id) {
+    auto it = std::find_if(notes.begin(), notes.end(),
+                           [note_id](const std::shared_ptr<Note>& note) { return note->getId() == note_id; });
+    if (it == notes.end()) {
+        return nullptr;
+    }
+    const size_t row = static_cast<size_t>(it - notes.begin());
+    if (!rows_suspended) {
+        for (FolderObserver* observer : observers) observer->noteAboutToBeRemoved(*this, row);
+    }
+    std::shared_ptr<Note> note = *it;
+    notes.erase(it); // Keeps the display order of the remaining notes
+    if (!rows_suspended) {
+        for (FolderObserver* observer : observers) observer->noteRemoved(*this, row);
+    }
+    if (note->parent_folder.lock().get() == this) {
+        note->parent_folder.reset();
+    }
+    adjustTotalNoteCount(-1);
+    return note;
+}
+
+void Folder::addSubfolder(std::shared_ptr<Folder> subfolder) {
+    if (!subfolder) return;
+    const size_t row = subfolders.size();
+    for (FolderObserver* observer : observers) observer->subfolderAboutToBeAdded(*this, row);
+    subfolder->parent_folder = weak_from_this();
+    subfolders.push_back(subfolder);
+    for (FolderObserver* observer : observers) observer->subfolderAdded(*this, row);
+    adjustTotalNoteCount(static_cast<long long>(subfolder->total_note_count));
+}
+
+std::shared_ptr<Folder> Folder::removeSubfolder(int folder_id) {
+    auto it = std::find_if(subfolders.begin(), subfolders.end(),
+                           [folder_id](const std::shared_ptr<Folder>& folder) { return folder->getId() == folder_id; });
+    if (it == subfolders.end()) {
+        return nullptr;
+    }
+    const size_t row = static_cast<size_t>(it - subfolders.begin());
+    for (FolderObserver* observer : observers) observer->subfolderAboutToBeRemoved(*this, row);
+    std::shared_ptr<Folder> subfolder = *it;
+    subfolders.erase(it);
+    for (FolderObserver* observer : observers) observer->subfolderRemoved(*this, row);
+    if (subfolder->parent_folder.lock().get() == this) {
+        subfolder->parent_folder.reset();
+    }
+    adjustTotalNoteCount(-static_cast<long long>(subfolder->total_note_count));
+    return subfolder;
+}
+
+size_t Folder::getTotalNoteCountRecursive() const {
+    return total_note_count;
+}
+
+void Folder::adjustTotalNoteCount(long long delta) {
+    if (delta == 0) return;
+    // Ancestors are owned by their own parents (or NoteManager), so raw pointers stay valid here.
+    for (Folder* folder = this; folder; folder = folder->parent_folder.lock().get()) {
+        folder->total_note_count = static_cast<size_t>(static_cast<long long>(folder->total_note_count) + delta);
+        if (!folder->changes_suspended) {
+            folder->reportChanged();
+        }
+    }
+}
+
+void Folder::reportChanged() const {
+    for (FolderObserver* observer : observers) observer->folderChanged(*this);
+}
+
+void Folder::suspendNotifications(bool rows) {
+    if (rows && !rows_suspended) {
+        for (FolderObserver* observer : observers) observer->notesAboutToBeReset(*this);
+        rows_suspended = true;
+    }
+    changes_suspended = true;
+}
+
+void Folder::resumeNotifications() {
+    const bool rows = rows_suspended;
+    rows_suspended = false;
+    changes_suspended = false;
+    if (rows) {
+        for (FolderObserver* observer : observers) observer->notesReset(*this);
+    }
+    reportChanged();
+}
+
+void Folder::addObserver(FolderObserver* observer) {
+    if (observer && std::find(observers.begin(), observers.end(), observer) == observers.end()) {
+        observers.push_back(observer);
+    }
+}
+
+void Folder::removeObserver(FolderObserver* observer) {
+    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+}
+
+void Folder::reportNoteChanged(int note_id) const {
+    if (observers.empty()) {
+        return;
+    }
+    for (size_t row = 0; row < notes.size(); ++row) {
+        if (notes[row]->getId() == note_id) {
+            for (FolderObserver* observer : observers) observer->noteChanged(*this, row);
+            return;
+        }
+    }
+}
+
+// --- NoteVersion ---
+
+NoteVersion::NoteVersion(const std::string& content)
+    : version_date(std::time(nullptr)), data(std::make_shared<Data>()) {
+    data->payload = content;
+}
+
+time_t NoteVersion::getDate() const {
+    return version_date;
+}
+
+std::string NoteVersion::getContent() const {
+    // Walk towards the newest full text, then apply the deltas on the way back.
+    std::vector<const Data*> chain;
+    for (const Data* d = data.get(); d; d = d->newer.get()) {
+        chain.push_back(d);
+    }
+    std::string text = chain.back()->payload;
+    std::string previous;
+    for (size_t i = chain.size() - 1; i-- > 0;) {
+        if (!delta_codec::apply(text, chain[i]->payload, previous)) {
+            return "";
+        }
+        text.swap(previous);
+    }
+    return text;
+}
+
+std::string_view NoteVersion::getContentView(std::string& buffer) const {
+    if (!data->newer) {
+        return data->payload;
+    }
+    buffer = getContent();
+    return buffer;
+}
+
+bool NoteVersion::isKeyframe() const {
+    return !data->newer;
+}
+
+size_t NoteVersion::getStorageSize() const {
+    return data->payload.size();
+}
+
+// --- NoteManager ---
+
+NoteManager::~NoteManager() {
+    MetricsRegistry::global().stopPeriodicDump();
+    saveSearchIndex();
+    flushStorage();
+}
+
+std::string NoteManager::getSetting(const std::string& key, const std::string& default_value) const {
+    return config->get(key, default_value);
+}
+
+// --- ID Lookups ---
+
+std::shared_ptr<Note> NoteManager::findNoteById(int id) {
+    auto it = all_notes_by_id.find(id);
+    return it != all_notes_by_id.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<const Note> NoteManager::findNoteById(int id) const {
+    auto it = all_notes_by_id.find(id);
+    return it != all_notes_by_id.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<Folder> NoteManager::findFolderById(int id) {
+    auto it = all_folders_by_id.find(id);
+    return it != all_folders_by_id.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<Folder> NoteManager::getTrashFolder() const {
+    return trash_folder;
+}
+
+std::shared_ptr<Folder> NoteManager::findParentFolderOfNote(int note_id) {
+    auto note = findNoteById(note_id);
+    return note ? note->getParentFolder() : nullptr;
+}
+
+std::shared_ptr<Folder> NoteManager::findFolderByIdRecursive(std::shared_ptr<Folder> current, int id) {
+    auto folder = findFolderById(id);
+    return folder && isWithin(folder, current.get()) ? folder : nullptr;
+}
+
+std::shared_ptr<Note> NoteManager::findNoteByIdRecursive(std::shared_ptr<Folder> current, int id) {
+    auto note = findNoteById(id);
+    return note && isWithin(note->getParentFolder(), current.get()) ? note : nullptr;
+}
+
+std::shared_ptr<const Note> NoteManager::findNoteByIdRecursive(std::shared_ptr<const Folder> current, int id) const {
+    auto note = findNoteById(id);
+    return note && isWithin(note->getParentFolder(), current.get()) ? note : nullptr;
+}
+
+// --- Index Maintenance ---
+
+void NoteManager::notifyNoteChanged(const std::shared_ptr<Note>& note) {
+    if (!note) {
+        return;
+    }
+    NOTES_TIME_OPERATION("note.changed");
+    const std::string_view title = note->getTitleView();
+    const std::vector<std::string_view> content = contentChunks(*note);
+    keyword_index.addDocument(note->getId(), title, content);
+    substring_index.addDocument(note->getId(), title, content);
+    tag_dictionary.setNoteTags(note->getId(), tagNames(*note));
+    notes_by_modified.set(note->getId(), note->getLastModifiedDate());
+    notes_by_created.set(note->getId(), note->getCreationDate());
+    if (snapshots_enabled) {
+        snapshots.update([&](SnapshotStore::Writer& writer) { stageNote(writer, *note); });
+    }
+
+    auto folder = note->getParentFolder();
+    if (folder) {
+        folder->reportNoteChanged(note->getId());
+    }
+    if (storage) {
+        storage->putNote(toStoredNote(*note, folder && folder != root_folder ? folder->getId() : 0));
+    }
+}
+
+void NoteManager::notifyNoteRemoved(int note_id) {
+    NOTES_TIME_OPERATION("note.removed");
+    keyword_index.removeDocument(note_id);
+    substring_index.removeDocument(note_id);
+    tag_dictionary.removeNote(note_id);
+    notes_by_modified.remove(note_id);
+    notes_by_created.remove(note_id);
+    if (snapshots_enabled) {
+        snapshots.update([note_id](SnapshotStore::Writer& writer) { writer.removeNote(note_id); });
+    }
+
+    if (storage) {
+        storage->removeNote(note_id);
+    }
+}
+
+void NoteManager::notifyNoteMoved(const std::shared_ptr<Note>& note, const std::shared_ptr<Folder>& folder) {
+    if (!note) {
+        return;
+    }
+    NOTES_TIME_OPERATION("note.moved");
+    if (snapshots_enabled) {
+        snapshots.update([&](SnapshotStore::Writer& writer) { stageNote(writer, *note); });
+    }
+    if (storage) {
+        storage->moveNote(note->getId(), folder && folder != root_folder ? folder->getId() : 0, note->isInTrash());
+    }
+}
+
+void NoteManager::notifyNoteTagged(int note_id, const std::string& tag_name, bool added) {
+    NOTES_TIME_OPERATION("note.tagged");
+    if (added) {
+        tag_dictionary.tagNote(note_id, tag_name);
+    } else {
+        tag_dictionary.untagNote(note_id, tag_name);
+    }
+    if (snapshots_enabled) {
+        if (auto note = findNoteById(note_id)) {
+            snapshots.update([&](SnapshotStore::Writer& writer) { stageNote(writer, *note); });
+        }
+    }
+
+    if (!storage) {
+        return;
+    }
+    if (added) {
+        storage->addTag(note_id, tag_name);
+    } else {
+        storage->removeTag(note_id, tag_name);
+    }
+}
+
+void NoteManager::notifyTagDeleted(const std::string& tag_name) {
+    const std::vector<uint32_t> note_ids = tag_dictionary.clearTag(tag_name);
+    if (snapshots_enabled && !note_ids.empty()) {
+        snapshots.update([&](SnapshotStore::Writer& writer) {
+            for (uint32_t note_id : note_ids) {
+                if (auto note = findNoteById(static_cast<int>(note_id))) {
+                    stageNote(writer, *note);
+                }
+            }
+        });
+    }
+    for (uint32_t note_id : note_ids) {
+        if (storage) {
+            storage->removeTag(static_cast<int>(note_id), tag_name);
+        }
+    }
+}
+
+void NoteManager::notifyFolderChanged(const std::shared_ptr<Folder>& folder) {
+    if (!folder) {
+        return;
+    }
+    NOTES_TIME_OPERATION("folder.changed");
+    folder->reportChanged();
+    if (snapshots_enabled) {
+        snapshots.update([&](SnapshotStore::Writer& writer) { stageFolder(writer, *folder); });
+    }
+    // The root and trash folders are the storage roots, not stored folders.
+    if (!storage || folder == root_folder || folder == trash_folder) {
+        return;
+    }
+    storage->putFolder(toStoredFolder(*folder));
+}
+
+StoredFolder NoteManager::toStoredFolder(const Folder& folder) const {
+    StoredFolder stored;
+    stored.id = folder.getId();
+    auto parent = folder.getParent();
+    stored.parent_id = parent && parent != root_folder ? parent->getId() : 0;
+    stored.name = folder.getNameView();
+    stored.in_trash = folder.isInTrash();
+    return stored;
+}
+
+void NoteManager::notifyFolderRemoved(int folder_id) {
+    if (snapshots_enabled) {
+        snapshots.update([folder_id](SnapshotStore::Writer& writer) { writer.removeFolder(folder_id); });
+    }
+    if (storage) {
+        storage->removeFolder(folder_id);
+    }
+}
+
+void NoteManager::loadSearchIndex(const std::string& base_path) {
+    NOTES_TIME_OPERATION("load.search_index");
+    search_index_path = (std::filesystem::path(base_path) / ".search_index").string();
+
+    time_t index_time = 0;
+    if (keyword_index.load(search_index_path)) {
+        std::error_code ec;
+        auto write_time = std::filesystem::last_write_time(search_index_path, ec);
+        if (!ec) {
+            index_time = toTimeT(write_time);
+        }
+    } else {
+        log("Search index missing or unreadable, rebuilding.");
+    }
+
+    for (int id : keyword_index.documentIds()) {
+        if (all_notes_by_id.find(id) == all_notes_by_id.end()) {
+            keyword_index.removeDocument(id);
+        }
+    }
+    size_t reindexed = 0;
+    substring_index.clear();
+    substring_index_ready = false;
+    for (const auto& entry : all_notes_by_id) {
+        const auto& note = entry.second;
+        if (!keyword_index.containsDocument(note->getId()) || note->getLastModifiedDate() >= index_time) {
+            keyword_index.addDocument(note->getId(), note->getTitleView(), contentChunks(*note));
+            ++reindexed;
+        }
+    }
+    log("Search index ready: " + std::to_string(keyword_index.documentCount()) + " notes, " +
+        std::to_string(reindexed) + " re-indexed.");
+
+    // Intern the known tags first so dictionary IDs follow tag creation order.
+    tag_dictionary.clear();
+    for (const auto& tag : all_tags) {
+        tag_dictionary.intern(tag->getName());
+    }
+    for (const auto& entry : all_notes_by_id) {
+        tag_dictionary.setNoteTags(entry.first, tagNames(*entry.second));
+    }
+    std::vector<std::pair<time_t, int>> modified;
+    std::vector<std::pair<time_t, int>> created;
+    modified.reserve(all_notes_by_id.size());
+    created.reserve(all_notes_by_id.size());
+    for (const auto& entry : all_notes_by_id) {
+        modified.emplace_back(entry.second->getLastModifiedDate(), entry.first);
+        created.emplace_back(entry.second->getCreationDate(), entry.first);
+    }
+    notes_by_modified.build(std::move(modified));
+    notes_by_created.build(std::move(created));
+    if (snapshots_enabled || config->get("concurrent_reads", "false") == "true") {
+        enableSnapshots();
+    }
+    const std::string metrics_file = config->get("metrics_file", "");
+    if (!metrics_file.empty()) {
+        const int interval = std::max(1, std::atoi(config->get("metrics_interval", "60").c_str()));
+        MetricsRegistry::global().startPeriodicDump(metrics_file, std::chrono::seconds(interval));
+    }
+    attachFileStorage();
+
+    startup_report.note_count = all_notes_by_id.size();
+    startup_report.folder_count = all_folders_by_id.size();
+    startup_report.total_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startup_begin).count();
+    log("Startup finished in " + std::to_string(static_cast<long long>(startup_report.total_ms)) + " ms.");
+}
+
+bool NoteManager::saveSearchIndex() const {
+    NOTES_TIME_OPERATION("save.search_index");
+    if (search_index_path.empty()) {
+        return false;
+    }
+    return keyword_index.save(search_index_path);
+}
+
+void NoteManager::ensureSubstringIndex() {
+    if (substring_index_ready) {
+        return;
+    }
+    for (const auto& entry : all_notes_by_id) {
+        substring_index.addDocument(entry.first, entry.second->getTitleView(), contentChunks(*entry.second));
+    }
+    substring_index_ready = true;
+}
+
+// --- Batches ---
+
+bool NoteManager::commitBatch(NoteBatch& batch) {
+    NOTES_TIME_OPERATION("batch.commit");
+    using Type = NoteBatch::Operation::Type;
+    const auto& operations = batch.operations;
+    auto reject = [&](size_t index, const std::string& message) {
+        batch.error = "Operation " + std::to_string(index + 1) + ": " + message;
+        NOTES_LOG(*logger, Logger::Level::WARNING, "Batch rejected. " + batch.error);
+        return false;
+    };
+
+    // Check every operation against the state the batch will have reached, changing nothing.
+    std::vector<std::shared_ptr<Folder>> destinations(operations.size());
+    std::set<int> created;
+    std::set<int> deleted;
+    for (size_t i = 0; i < operations.size(); ++i) {
+        const auto& operation = operations[i];
+        const std::string id = std::to_string(operation.note_id);
+        for (const auto& tag_name : operation.tags) {
+            if (trim(tag_name).empty()) return reject(i, "empty tag name for note " + id + ".");
+        }
+        if (operation.type == Type::CreateNote) {
+            destinations[i] = operation.folder_id == 0 ? (current_folder ? current_folder : root_folder)
+                                                       : findFolderById(operation.folder_id);
+            if (!destinations[i]) return reject(i, "folder " + std::to_string(operation.folder_id) + " not found.");
+            created.insert(operation.note_id);
+            continue;
+        }
+        if (deleted.count(operation.note_id) != 0) return reject(i, "note " + id + " was deleted earlier in the batch.");
+        if (created.count(operation.note_id) == 0 && !findNoteById(operation.note_id)) {
+            return reject(i, "note " + id + " not found.");
+        }
+        if (operation.type == Type::MoveNote) {
+            destinations[i] = findFolderById(operation.folder_id);
+            if (!destinations[i]) return reject(i, "folder " + std::to_string(operation.folder_id) + " not found.");
+        } else if (operation.type == Type::DeleteNote) {
+            deleted.insert(operation.note_id);
+        }
+    }
+    if (operations.empty()) {
+        return true;
+    }
+
+    // Apply. Each folder whose notes change sends one reset instead of a signal per row,
+    // and every folder on the way to the root one folderChanged.
+    std::vector<std::shared_ptr<Folder>> suspended;
+    std::set<const Folder*> suspended_set;
+    // Undo information: the rows of each folder the batch changes, taken before its first change.
+    std::map<const Folder*, std::pair<std::shared_ptr<Folder>, std::vector<std::shared_ptr<Note>>>> original_rows;
+    auto suspend = [&](const std::shared_ptr<Folder>& folder) {
+        if (folder && original_rows.count(folder.get()) == 0) {
+            original_rows.emplace(folder.get(), std::make_pair(folder, folder->notes));
+        }
+        for (auto current = folder; current; current = current->getParent()) {
+            if (suspended_set.insert(current.get()).second) {
+                suspended.push_back(current);
+            }
+            current->suspendNotifications(current == folder);
+        }
+    };
+    auto resumeAll = [&]() {
+        for (const auto& folder : suspended) {
+            folder->resumeNotifications();
+        }
+    };
+
+    std::map<int, std::shared_ptr<Folder>> original_folders; // Every touched note; null for new notes
+    std::map<int, std::shared_ptr<Note>> original_notes;     // Copies of the touched existing notes, for undo and old files
+    std::map<int, std::shared_ptr<Note>> removed;
+    const bool versioning = config->get("enable_versioning", "true") == "true";
+    try {
+        for (size_t i = 0; i < operations.size(); ++i) {
+            const auto& operation = operations[i];
+            auto note = operation.created ? operation.created : findNoteById(operation.note_id);
+            if (!operation.created && original_folders.count(note->getId()) == 0) {
+                original_folders[note->getId()] = note->getParentFolder();
+                original_notes[note->getId()] = std::make_shared<Note>(*note);
+            }
+            switch (operation.type) {
+                case Type::CreateNote:
+                    original_folders[note->getId()] = nullptr;
+                    for (const auto& tag_name : operation.tags) {
+                        if (!note->hasTag(trim(tag_name))) note->addTag(findOrCreateTag(trim(tag_name)));
+                    }
+                    suspend(destinations[i]);
+                    destinations[i]->addNote(note);
+                    all_notes_by_id[note->getId()] = note;
+                    break;
+                case Type::EditNote:
+                    suspend(note->getParentFolder());
+                    if (versioning && !note->contentEquals(operation.content)) {
+                        note->addVersion(NoteVersion(copyContent(*note)));
+                    }
+                    note->setTitle(operation.title);
+                    note->setContent(operation.content);
+                    ++note->content_revision;
+                    break;
+                case Type::MoveNote: {
+                    auto from = note->getParentFolder();
+                    if (from == destinations[i]) break;
+                    suspend(from);
+                    suspend(destinations[i]);
+                    if (from) from->removeNote(note->getId());
+                    destinations[i]->addNote(note);
+                    break;
+                }
+                case Type::AddTag:
+                    if (!note->hasTag(trim(operation.tags.front()))) {
+                        note->addTag(findOrCreateTag(trim(operation.tags.front())));
+                    }
+                    suspend(note->getParentFolder());
+                    break;
+                case Type::DeleteNote: {
+                    auto from = note->getParentFolder();
+                    suspend(from);
+                    if (from) from->removeNote(note->getId());
+                    if (operation.permanent) {
+                        all_notes_by_id.erase(note->getId());
+                        removed[note->getId()] = note;
+                    } else {
+                        note->setInTrash(true);
+                        suspend(trash_folder);
+                        trash_folder->addNote(note);
+                    }
+                    break;
+                }
+            }
+        }
+    } catch (...) {
+        // Put every touched folder and note back as it was. Only tags the batch created are kept.
+        for (auto& entry : original_rows) {
+            Folder& folder = *entry.second.first;
+            const long long delta =
+                static_cast<long long>(entry.second.second.size()) - static_cast<long long>(folder.notes.size());
+            folder.notes = std::move(entry.second.second);
+            folder.adjustTotalNoteCount(delta);
+        }
+        for (const auto& entry : original_notes) {
+            auto it = removed.find(entry.first);
+            auto note = it != removed.end() ? it->second : findNoteById(entry.first);
+            *note = *entry.second;
+            all_notes_by_id[entry.first] = note;
+        }
+        for (const auto& operation : operations) {
+            if (operation.created) {
+                all_notes_by_id.erase(operation.note_id);
+                operation.created->parent_folder.reset();
+            }
+        }
+        resumeAll();
+        throw;
+    }
+
+    // One index update per touched note.
+    std::vector<std::shared_ptr<Note>> written;
+    for (const auto& entry : original_folders) {
+        if (removed.count(entry.first) == 0) {
+            written.push_back(findNoteById(entry.first));
+        }
+    }
+    for (const auto& entry : removed) {
+        keyword_index.removeDocument(entry.first);
+        substring_index.removeDocument(entry.first);
+        tag_dictionary.removeNote(entry.first);
+        notes_by_modified.remove(entry.first);
+        notes_by_created.remove(entry.first);
+    }
+    for (const auto& note : written) {
+        const std::string_view title = note->getTitleView();
+        const std::vector<std::string_view> content = contentChunks(*note);
+        keyword_index.addDocument(note->getId(), title, content);
+        substring_index.addDocument(note->getId(), title, content);
+        tag_dictionary.setNoteTags(note->getId(), tagNames(*note));
+        notes_by_modified.set(note->getId(), note->getLastModifiedDate());
+        notes_by_created.set(note->getId(), note->getCreationDate());
+    }
+    if (snapshots_enabled) {
+        snapshots.update([&](SnapshotStore::Writer& writer) {
+            for (const auto& entry : removed) writer.removeNote(entry.first);
+            for (const auto& note : written) stageNote(writer, *note);
+        });
+    }
+
+    // One write per touched note, then a single flush.
+    if (storage) {
+        for (const auto& entry : removed) {
+            if (original_folders[entry.first]) storage->removeNote(entry.first);
+        }
+        for (const auto& note : written) {
+            auto folder = note->getParentFolder();
+            storage->putNote(toStoredNote(*note, folder && folder != root_folder ? folder->getId() : 0));
+        }
+        storage->sync();
+    } else {
+        // A file written before the batch goes away if its note was removed, moved or renamed.
+        for (const auto& entry : original_notes) {
+            auto note = findNoteById(entry.first);
+            const auto& original_folder = original_folders[entry.first];
+            if (!note || note->getParentFolder() != original_folder || note->getTitleView() != entry.second->getTitleView()) {
+                deleteNoteFile(entry.second, original_folder);
+            }
+        }
+        for (const auto& note : written) {
+            saveNoteToFile(note, note->getParentFolder());
+        }
+    }
+
+    resumeAll();
+    log("Batch committed: " + std::to_string(operations.size()) + " operations, " + std::to_string(written.size()) +
+        " notes written, " + std::to_string(removed.size()) + " removed.");
+    return true;
+}
+
+// --- Autosave ---
+
+bool NoteManager::saveNoteContent(int note_id, const std::string& new_content, bool record_version) {
+    NOTES_TIME_OPERATION("note.autosave");
+    auto note = findNoteById(note_id);
+    if (!note) {
+        return false;
+    }
+    if (note->contentEquals(new_content)) {
+        return true;
+    }
+    if (record_version && config->get("enable_versioning", "true") == "true") {
+        note->addVersion(NoteVersion(copyContent(*note)));
+    }
+    // Autosaves usually differ from the saved text in one place: replace only that span so the
+    // word and character counts are updated from the edit instead of a rescan of the whole note.
+    // The common prefix and suffix are found piece by piece, so a piece-table body stays one.
+    const std::vector<std::string_view> chunks = contentChunks(*note);
+    const size_t old_size = note->getContentSize();
+    const size_t shorter = std::min(old_size, new_content.size());
+    size_t prefix = 0;
+    for (auto chunk = chunks.begin(); chunk != chunks.end() && prefix < shorter; ++chunk) {
+        size_t i = 0;
+        while (i < chunk->size() && prefix < shorter && (*chunk)[i] == new_content[prefix]) {
+            ++i;
+            ++prefix;
+        }
+        if (i < chunk->size()) break;
+    }
+    size_t suffix = 0;
+    for (auto chunk = chunks.rbegin(); chunk != chunks.rend() && suffix < shorter - prefix; ++chunk) {
+        size_t i = chunk->size();
+        while (i > 0 && suffix < shorter - prefix && (*chunk)[i - 1] == new_content[new_content.size() - 1 - suffix]) {
+            --i;
+            ++suffix;
+        }
+        if (i > 0) break;
+    }
+    note->replaceRange(prefix, old_size - suffix, new_content.substr(prefix, new_content.size() - suffix - prefix));
+    if (!storage) {
+        saveNoteToFile(note, note->getParentFolder());
+    }
+    notifyNoteChanged(note);
+    return true;
+}
+
+// --- Storage Backend ---
+
+std::shared_ptr<Tag> NoteManager::findOrCreateTag(const std::string& name) {
+    auto tag = findTagByName(name);
+    if (!tag) {
+        createTag(name);
+        tag = findTagByName(name);
+    }
+    return tag;
+}
+
+bool NoteManager::loadFromStorage(const std::string& base_path) {
+    NOTES_TIME_OPERATION("load.journal");
+    // First step of initializeFromFileSystem: the startup clock starts here.
+    startup_begin = std::chrono::steady_clock::now();
+    startup_report = StartupReport();
+    logger->setLevel(Logger::parseLevel(config->get("log_level", "info")));
+    if (config->get("storage_backend", "files") != "journal") {
+        return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(base_path, ec);
+    auto mode = config->get("journal_sync", "batch") == "always" ? JournalStorage::SyncMode::EveryRecord
+                                                                  : JournalStorage::SyncMode::OnSync;
+    auto journal = std::make_unique<JournalStorage>((std::filesystem::path(base_path) / "notes.journal").string(), mode);
+    if (!journal->open()) {
+        NOTES_LOG(*logger, Logger::Level::ERROR,
+                  journal->getError().empty() ? "Could not open note journal in '" + base_path + "'."
+                                              : journal->getError());
+        return false;
+    }
+    if (journal->recoveredBytes() > 0) {
+        NOTES_LOG(*logger, Logger::Level::WARNING, "Discarded " + std::to_string(journal->recoveredBytes()) +
+                                                   " bytes of incomplete journal records.");
+    }
+
+    std::vector<std::pair<std::shared_ptr<Folder>, int>> loaded_folders; // Folder and stored parent ID
+    bool folders_linked = false;
+    int max_folder_id = 0;
+    int max_note_id = 0;
+    auto resolveFolder = [this](int id) {
+        auto it = all_folders_by_id.find(id);
+        return id != 0 && it != all_folders_by_id.end() ? it->second : root_folder;
+    };
+    auto linkFolders = [&]() {
+        if (folders_linked) return;
+        for (const auto& entry : loaded_folders) {
+            auto parent = resolveFolder(entry.second);
+            entry.first->setParent(parent);
+            parent->addSubfolder(entry.first);
+        }
+        folders_linked = true;
+    };
+
+    bool ok = journal->replay(
+        [&](const StoredFolder& stored) {
+            auto folder = makeObject<Folder>(stored.name);
+            folder->id = stored.id;
+            folder->is_in_trash = stored.in_trash;
+            all_folders_by_id[folder->id] = folder;
+            loaded_folders.emplace_back(folder, stored.parent_id);
+            max_folder_id = std::max(max_folder_id, stored.id);
+        },
+        [&](StoredNote&& stored) {
+            linkFolders(); // Every folder has been reported by now
+            auto note = makeObject<Note>(stored.title, stored.content);
+            note->id = stored.id;
+            note->creation_date = stored.creation_date;
+            note->last_modified_date = stored.last_modified_date;
+            note->is_in_trash = stored.in_trash;
+            for (const auto& tag_name : stored.tags) {
+                note->addTag(findOrCreateTag(tag_name));
+            }
+            resolveFolder(stored.folder_id)->addNote(note);
+            all_notes_by_id[note->id] = note;
+            max_note_id = std::max(max_note_id, stored.id);
+        });
+    if (!ok) {
+        NOTES_LOG(*logger, Logger::Level::ERROR, "Note journal replay failed.");
+        return false;
+    }
+    linkFolders();
+
+    Note::next_id = std::max(Note::next_id, max_note_id + 1);
+    Folder::next_id = std::max(Folder::next_id, max_folder_id + 1);
+    if (config->get("background_writes", "true") == "true") {
+        storage = std::make_unique<BackgroundStorage>(std::move(journal)); // Keeps journal writes off the UI thread
+    } else {
+        storage = std::move(journal);
+    }
+    startup_report.metadata_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startup_begin).count();
+    log("Loaded " + std::to_string(all_notes_by_id.size()) + " notes from the note journal.");
+    return true;
+}
+
+bool NoteManager::loadLazilyFromDirectories(const std::string& base_path, const std::string& trash_path) {
+    if (config->get("lazy_loading", "false") != "true") {
+        return false;
+    }
+    NOTES_TIME_OPERATION("load.directories");
+
+    ParallelDirectoryWalker walker;
+    std::vector<ScannedFolder> active = walker.scan(base_path);
+    std::vector<ScannedFolder> trashed = walker.scan(trash_path);
+    startup_report.metadata_ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startup_begin).count();
+    startup_report.lazy = true;
+
+    int max_note_id = 0;
+    auto build = [&](const std::vector<ScannedFolder>& scanned, const std::shared_ptr<Folder>& base, bool in_trash) {
+        std::map<std::string, std::shared_ptr<Folder>> folders_by_path{{"", base}};
+        for (const auto& entry : scanned) {
+            std::shared_ptr<Folder> folder = base;
+            if (entry.depth > 0) {
+                auto parent_it = folders_by_path.find(std::filesystem::path(entry.relative_path).parent_path().generic_string());
+                auto parent = parent_it != folders_by_path.end() ? parent_it->second : base;
+                folder = makeObject<Folder>(entry.name);
+                folder->is_in_trash = in_trash;
+                folder->setParent(parent);
+                parent->addSubfolder(folder);
+                all_folders_by_id[folder->getId()] = folder;
+                folders_by_path[entry.relative_path] = folder;
+            }
+            for (const auto& header : entry.notes) {
+                auto note = makeObject<Note>(header.title, "");
+                note->id = header.id;
+                note->creation_date = header.creation_date;
+                note->last_modified_date = header.last_modified_date;
+                note->is_in_trash = in_trash;
+                for (const auto& tag_name : header.tags) {
+                    note->addTag(findOrCreateTag(tag_name));
+                }
+                note->deferContent(header.file_path, header.body_offset);
+                folder->addNote(note);
+                all_notes_by_id[note->id] = note;
+                max_note_id = std::max(max_note_id, header.id);
+            }
+        }
+    };
+    build(active, root_folder, false);
+    build(trashed, trash_folder, true);
+    Note::next_id = std::max(Note::next_id, max_note_id + 1);
+
+    log("Loaded metadata for " + std::to_string(all_notes_by_id.size()) + " notes in " +
+        std::to_string(static_cast<long long>(startup_report.metadata_ms)) + " ms; bodies load on demand.");
+    return true;
+}
+
+const StartupReport& NoteManager::getStartupReport() const {
+    return startup_report;
+}
+
+ObjectArena::Stats NoteManager::getObjectArenaStats() const {
+    return object_arena ? object_arena->stats() : ObjectArena::Stats{};
+}
+
+void NoteManager::attachFileStorage() {
+    if (storage || startup_report.lazy || config->get("background_writes", "true") != "true") {
+        return;
+    }
+    auto files = std::make_unique<FileStorage>(getPathForFolder(root_folder), getPathForFolder(trash_folder),
+                                               trash_folder->getId());
+    for (const auto& entry : all_folders_by_id) {
+        if (entry.second != root_folder && entry.second != trash_folder) {
+            files->registerFolder(toStoredFolder(*entry.second));
+        }
+    }
+    for (const auto& entry : all_notes_by_id) {
+        auto folder = entry.second->getParentFolder();
+        files->registerNote(entry.first, folder && folder != root_folder ? folder->getId() : 0);
+    }
+    if (!files->open()) {
+        NOTES_LOG(*logger, Logger::Level::WARNING, "Could not open the note directories; note files are written synchronously.");
+        return;
+    }
+    storage = std::make_unique<BackgroundStorage>(std::move(files)); // Keeps note file writes off the UI thread
+}
+
+bool NoteManager::flushStorage() {
+    if (!storage) {
+        return true; // Note files written on the calling thread are already on disk
+    }
+    if (auto background = dynamic_cast<BackgroundStorage*>(storage.get())) {
+        return background->flush();
+    }
+    return storage->sync();
+}
+
+// --- Search Operations ---
+
+std::vector<std::shared_ptr<Note>> NoteManager::findNotesContaining(const std::string& fragment) {
+    NOTES_TIME_OPERATION("search.substring");
+    auto verify = [&fragment](const std::shared_ptr<Note>& note) { return noteContainsIgnoreCase(*note, fragment); };
+
+    std::vector<std::shared_ptr<Note>> results;
+    std::vector<int> candidate_ids;
+    ensureSubstringIndex();
+    if (substring_index.candidates(fragment, candidate_ids)) {
+        for (int id : candidate_ids) {
+            auto it = all_notes_by_id.find(id);
+            if (it != all_notes_by_id.end() && verify(it->second)) {
+                results.push_back(it->second);
+            }
+        }
+    } else {
+        for (const auto& entry : all_notes_by_id) {
+            if (verify(entry.second)) {
+                results.push_back(entry.second);
+            }
+        }
+        sortById(results);
+    }
+    return results;
+}
+
+std::vector<std::shared_ptr<Note>> NoteManager::searchNotesByKeyword(const std::string& keyword) {
+    NOTES_TIME_OPERATION("search.keyword");
+    std::vector<std::shared_ptr<Note>> results;
+    for (const auto& note : findNotesContaining(trim(keyword))) {
+        if (!note->isInTrash()) {
+            results.push_back(note);
+        }
+    }
+    return results;
+}
+
+std::vector<NoteManager::RankedNote> NoteManager::searchNotesRanked(const std::string& query, size_t limit,
+                                                                    bool include_trash) {
+    NOTES_TIME_OPERATION("search.ranked");
+    std::vector<RankedNote> results;
+    auto accept = [&](int id) {
+        auto note = findNoteById(id);
+        return note && (include_trash || !note->isInTrash());
+    };
+    for (const auto& scored : keyword_index.rankTopK(query, limit, accept)) {
+        results.push_back({findNoteById(scored.note_id), scored.score});
+    }
+    return results;
+}
+
+std::vector<std::shared_ptr<Note>> NoteManager::searchNotesByTag(const std::string& tag_name) {
+    NOTES_TIME_OPERATION("search.tag");
+    std::vector<std::shared_ptr<Note>> results;
+    if (const RoaringBitmap* note_ids = tag_dictionary.notesWith(tag_name)) {
+        note_ids->forEach([&](uint32_t id) {
+            auto note = findNoteById(static_cast<int>(id));
+            if (note && !note->isInTrash()) {
+                results.push_back(note);
+            }
+        });
+    }
+    return results;
+}
+
+const std::vector<std::shared_ptr<Tag>>& NoteManager::getAllTags() const {
+    return all_tags;
+}
+
+std::vector<std::shared_ptr<Note>> NoteManager::searchNotes(const SearchCriteria& criteria) {
+    NOTES_TIME_OPERATION("search.notes");
+    return runSearch(criteria, nullptr);
+}
+
+QueryPlan NoteManager::explainSearch(const SearchCriteria& criteria) {
+    QueryPlan plan;
+    runSearch(criteria, &plan);
+    return plan;
+}
+
+NoteManager::PreparedSearch NoteManager::prepareSearch(const SearchCriteria& criteria) {
+    using Kind = QueryStep::Kind;
+    PreparedSearch search;
+    const size_t total_notes = all_notes_by_id.size();
+
+    // Estimate every predicate from index statistics. Tag bitmaps and date ranges
+    // are exact (or nearly); for a keyword the rarest of its trigrams gives an
+    // upper bound, unknown below three characters.
+    search.keyword = trim(criteria.keyword);
+    search.by_creation = criteria.date_field == SearchCriteria::DateField::Created;
+    search.newest_first = criteria.newest_first;
+    search.from = criteria.start_date != 0 ? criteria.start_date : std::numeric_limits<time_t>::min();
+    search.to = criteria.end_date != 0 ? criteria.end_date : std::numeric_limits<time_t>::max();
+    const DateIndex& dates = search.by_creation ? notes_by_created : notes_by_modified;
+
+    std::vector<QueryStep> filters;
+    if (!criteria.tags.empty()) {
+        search.tagged = criteria.match_any_tag ? tag_dictionary.notesWithAny(criteria.tags)
+                                               : tag_dictionary.notesWithAll(criteria.tags);
+        const size_t count = search.tagged.cardinality();
+        filters.emplace_back(Kind::Tags, count, count);
+    }
+    if (criteria.start_date != 0 || criteria.end_date != 0) {
+        const size_t count = dates.estimateRange(search.from, search.to);
+        filters.emplace_back(Kind::DateRange, count, count);
+    }
+    if (!criteria.search_in_trash) {
+        const size_t trashed = trash_folder ? trash_folder->getTotalNoteCountRecursive() : 0;
+        const size_t count = total_notes > trashed ? total_notes - trashed : 0;
+        filters.emplace_back(Kind::NotInTrash, count, SIZE_MAX);
+    }
+    QueryStep keyword_step(Kind::Keyword, 0, SIZE_MAX);
+    if (!search.keyword.empty()) {
+        ensureSubstringIndex();
+        keyword_step.upper_bound = substring_index.estimateMatches(search.keyword);
+        keyword_step.estimated_rows = std::min(keyword_step.upper_bound, total_notes);
+    }
+
+    // Drive from the predicate that yields the fewest candidates. A keyword
+    // drives with its trigram candidates, but its text is verified last, once
+    // the cheaper filters have thinned the candidates out.
+    QueryStep driver(Kind::AllNotes, total_notes, total_notes);
+    size_t driver_index = SIZE_MAX;
+    for (size_t i = 0; i < filters.size(); ++i) {
+        if (filters[i].kind != Kind::NotInTrash && filters[i].estimated_rows < driver.estimated_rows) {
+            driver = filters[i];
+            driver_index = i;
+        }
+    }
+    if (!search.keyword.empty() && keyword_step.upper_bound < driver.estimated_rows) {
+        driver = QueryStep(Kind::Keyword, keyword_step.upper_bound, keyword_step.upper_bound);
+        driver_index = SIZE_MAX;
+    }
+    if (driver_index != SIZE_MAX) {
+        filters.erase(filters.begin() + static_cast<std::ptrdiff_t>(driver_index));
+    }
+    std::stable_sort(filters.begin(), filters.end(),
+                     [](const QueryStep& a, const QueryStep& b) { return a.estimated_rows < b.estimated_rows; });
+
+    search.steps.reserve(filters.size() + 2);
+    search.steps.push_back(driver);
+    search.steps.insert(search.steps.end(), filters.begin(), filters.end());
+    if (!search.keyword.empty()) {
+        search.steps.push_back(keyword_step);
+    }
+    search.short_circuit = std::any_of(search.steps.begin(), search.steps.end(),
+                                       [](const QueryStep& step) { return step.upper_bound == 0; });
+    return search;
+}
+
+std::vector<int> NoteManager::searchCandidates(const PreparedSearch& search, std::string* ordering,
+                                               std::vector<time_t>* dates) {
+    using Kind = QueryStep::Kind;
+    const DateIndex& date_index = search.by_creation ? notes_by_created : notes_by_modified;
+    std::vector<int> ids;
+    bool in_order = false; // The driver already produced the requested order
+    if (dates) {
+        dates->clear();
+    }
+    auto collectByDate = [&](int id, time_t date) {
+        ids.push_back(id);
+        if (dates && search.newest_first) {
+            dates->push_back(date);
+        }
+        return true;
+    };
+    switch (search.steps.front().kind) {
+    case Kind::Tags:
+        ids.reserve(search.tagged.cardinality());
+        search.tagged.forEach([&](uint32_t id) { ids.push_back(static_cast<int>(id)); });
+        in_order = !search.newest_first;
+        break;
+    case Kind::Keyword:
+        substring_index.candidates(search.keyword, ids);
+        in_order = !search.newest_first;
+        break;
+    case Kind::DateRange:
+    case Kind::AllNotes:
+        if (search.newest_first) {
+            date_index.forEachInRangeNewestFirst(search.from, search.to, collectByDate);
+            in_order = true;
+        } else if (search.steps.front().kind == Kind::DateRange) {
+            date_index.forEachInRange(search.from, search.to, collectByDate);
+        } else {
+            ids.reserve(all_notes_by_id.size());
+            for (const auto& entry : all_notes_by_id) {
+                ids.push_back(entry.first);
+            }
+        }
+        break;
+    case Kind::NotInTrash:
+        break;
+    }
+
+    if (!in_order && search.newest_first) {
+        // Same order as the newest-first index scan: equal dates put the higher ID first.
+        std::vector<std::pair<time_t, int>> dated;
+        dated.reserve(ids.size());
+        for (int id : ids) {
+            if (auto note = findNoteById(id)) {
+                dated.emplace_back(searchDate(search, *note), id);
+            }
+        }
+        std::sort(dated.begin(), dated.end(), std::greater<std::pair<time_t, int>>());
+        ids.clear();
+        for (const auto& entry : dated) {
+            ids.push_back(entry.second);
+            if (dates) {
+                dates->push_back(entry.first);
+            }
+        }
+    } else if (!in_order) {
+        std::sort(ids.begin(), ids.end());
+    }
+    if (ordering) {
+        *ordering = search.newest_first ? std::string(search.by_creation ? "created" : "modified") + ", newest first"
+                                        : "by ID";
+        *ordering += in_order ? " (index order)" : " (sorted)";
+    }
+    return ids;
+}
+
+bool NoteManager::passesSearchStep(const PreparedSearch& search, const QueryStep& step, const Note& note) const {
+    switch (step.kind) {
+    case QueryStep::Kind::Tags:
+        return search.tagged.contains(static_cast<uint32_t>(note.getId()));
+    case QueryStep::Kind::DateRange: {
+        const time_t date = searchDate(search, note);
+        return date >= search.from && date <= search.to;
+    }
+    case QueryStep::Kind::NotInTrash:
+        return !note.isInTrash();
+    case QueryStep::Kind::Keyword:
+        return noteContainsIgnoreCase(note, search.keyword);
+    case QueryStep::Kind::AllNotes:
+        break;
+    }
+    return true;
+}
+
+std::vector<std::shared_ptr<Note>> NoteManager::runSearch(const SearchCriteria& criteria, QueryPlan* explain) {
+    using Clock = std::chrono::steady_clock;
+    using Kind = QueryStep::Kind;
+    auto elapsedNs = [](Clock::time_point since) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - since).count());
+    };
+    const Clock::time_point begin = Clock::now();
+    PreparedSearch search = prepareSearch(criteria);
+    std::vector<QueryStep>& steps = search.steps;
+    const uint64_t plan_ns = elapsedNs(begin);
+
+    // Run the steps: the driver produces the candidates in result order, each filter keeps the ones that pass.
+    std::vector<std::shared_ptr<Note>> results;
+    std::string ordering;
+    if (!search.short_circuit) {
+        QueryStep& first = steps.front();
+        const Clock::time_point step_begin = Clock::now();
+        const std::vector<int> ids = searchCandidates(search, &ordering);
+        results.reserve(ids.size());
+        for (int id : ids) {
+            if (auto note = findNoteById(id)) {
+                results.push_back(std::move(note));
+            }
+        }
+        first.rows_in = results.size();
+        first.rows_out = results.size();
+        first.time_ns = elapsedNs(step_begin);
+
+        for (size_t i = 1; i < steps.size(); ++i) {
+            QueryStep& step = steps[i];
+            const Clock::time_point filter_begin = Clock::now();
+            step.rows_in = results.size();
+            results.erase(std::remove_if(results.begin(), results.end(),
+                                         [&](const std::shared_ptr<Note>& note) {
+                                             return !passesSearchStep(search, step, *note);
+                                         }),
+                          results.end());
+            step.rows_out = results.size();
+            step.time_ns = elapsedNs(filter_begin);
+        }
+    }
+
+    if (explain) {
+        for (QueryStep& step : steps) {
+            switch (step.kind) {
+            case Kind::AllNotes:
+                step.description = "all notes";
+                break;
+            case Kind::Tags: {
+                step.description = criteria.match_any_tag ? "tagged any of " : "tagged all of ";
+                for (size_t i = 0; i < criteria.tags.size(); ++i) {
+                    step.description += (i ? ", " : "") + criteria.tags[i];
+                }
+                break;
+            }
+            case Kind::DateRange:
+                step.description = std::string(search.by_creation ? "created " : "modified ") +
+                                   (criteria.start_date != 0 ? formatSearchDate(search.from) : "*") + " .. " +
+                                   (criteria.end_date != 0 ? formatSearchDate(search.to) : "*");
+                break;
+            case Kind::Keyword:
+                step.description =
+                    "\"" + search.keyword + "\"" + (&step == &steps.front() ? " trigram candidates" : " in text");
+                break;
+            case Kind::NotInTrash:
+                step.description = "not in trash";
+                break;
+            }
+        }
+        explain->steps = std::move(steps);
+        explain->total_notes = all_notes_by_id.size();
+        explain->result_count = results.size();
+        explain->short_circuited = search.short_circuit;
+        explain->ordering = ordering;
+        explain->plan_ns = plan_ns;
+        explain->total_ns = elapsedNs(begin);
+    }
+    if (search.short_circuit) {
+        NOTES_COUNT("search.short_circuit", 1);
+    }
+    return results;
+}
+
+std::vector<std::shared_ptr<Note>> NoteManager::getRecentlyModifiedNotes(size_t limit, bool include_trash) {
+    NOTES_TIME_OPERATION("search.recent");
+    std::vector<std::shared_ptr<Note>> results;
+    if (limit == 0) {
+        return results;
+    }
+    notes_by_modified.forEachInRangeNewestFirst(
+        std::numeric_limits<time_t>::min(), std::numeric_limits<time_t>::max(), [&](int id, time_t) {
+            auto note = findNoteById(id);
+            if (note && (include_trash || !note->isInTrash())) {
+                results.push_back(note);
+            }
+            return results.size() < limit;
+        });
+    return results;
+}
+
+// --- Concurrent Reads ---
+
+void NoteManager::enableSnapshots() {
+    const uint64_t version = snapshots.update([&](SnapshotStore::Writer& writer) {
+        writer.clear();
+        for (const auto& entry : all_folders_by_id) {
+            stageFolder(writer, *entry.second);
+        }
+        for (const auto& entry : all_notes_by_id) {
+            stageNote(writer, *entry.second);
+        }
+    });
+    snapshots_enabled = true;
+    log("Snapshots enabled at version " + std::to_string(version) + ".");
+}
+
+std::shared_ptr<const NoteSnapshot> NoteManager::getSnapshot() const {
+    return snapshots_enabled ? snapshots.current() : nullptr;
+}
+
+std::vector<std::shared_ptr<const NoteRecord>> NoteManager::searchNotes(const NoteSnapshot& snapshot,
+                                                                         const SearchCriteria& criteria) {
+    NOTES_TIME_OPERATION("search.snapshot");
+    SearchCriteria trimmed = criteria;
+    trimmed.keyword = trim(criteria.keyword);
+    std::vector<std::shared_ptr<const NoteRecord>> results;
+    snapshot.notes().forEach([&](const std::shared_ptr<const NoteRecord>& note) {
+        if (matchesCriteria(*note, trimmed)) {
+            results.push_back(note);
+        }
+    });
+    if (criteria.newest_first) {
+        sortNewestFirst(results, criteria.date_field);
+    }
+    return results;
+}
+
+bool NoteManager::matchesCriteria(const NoteRecord& note, const SearchCriteria& criteria) {
+    if (note.in_trash && !criteria.search_in_trash) return false;
+    const time_t date =
+        criteria.date_field == SearchCriteria::DateField::Created ? note.creation_date : note.last_modified_date;
+    if (criteria.start_date != 0 && date < criteria.start_date) return false;
+    if (criteria.end_date != 0 && date > criteria.end_date) return false;
+    if (!criteria.tags.empty()) {
+        auto carried = [&](const std::string& tag) { return note.hasTag(tag); };
+        if (criteria.match_any_tag ? std::none_of(criteria.tags.begin(), criteria.tags.end(), carried)
+                                   : !std::all_of(criteria.tags.begin(), criteria.tags.end(), carried)) {
+            return false;
+        }
+    }
+    return criteria.keyword.empty() || TrigramIndex::containsIgnoreCase(note.title, criteria.keyword) ||
+           TrigramIndex::containsIgnoreCase(*note.content, criteria.keyword);
+}
+
+void NoteManager::sortNewestFirst(std::vector<std::shared_ptr<const NoteRecord>>& notes,
+                                  SearchCriteria::DateField field) {
+    const bool by_creation = field == SearchCriteria::DateField::Created;
+    // Same order as searchNotes(): equal dates put the higher ID first.
+    std::sort(notes.begin(), notes.end(),
+              [by_creation](const std::shared_ptr<const NoteRecord>& a, const std::shared_ptr<const NoteRecord>& b) {
+                  const time_t date_a = by_creation ? a->creation_date : a->last_modified_date;
+                  const time_t date_b = by_creation ? b->creation_date : b->last_modified_date;
+                  return date_a != date_b ? date_a > date_b : a->id > b->id;
+              });
+}
@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <ctime>
 #include <memory>
@@ -17,6 +18,24 @@
 #include <fstream>      // For file I/O
 #include <chrono>       // For logging timestamps
 #include <set>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>       // For the asynchronous log writer
+#include "search_index.hpp"
+#include "trigram_index.hpp"
+#include "storage_backend.hpp"
+#include "startup_loader.hpp"
+#include "id_index.hpp"
+#include "tag_dictionary.hpp"
+#include "date_index.hpp"
+#include "query_plan.hpp"
+#include "piece_table.hpp"
+#include "small_vector.hpp"
+#include "object_arena.hpp"
+#include "mpsc_ring.hpp"
+#include "note_snapshot.hpp"
+#include "metrics.hpp"
 
 // Forward declarations to resolve circular dependencies
 class Note;
@@ -25,6 +44,7 @@ class Tag;
 class NoteVersion;
 class Reminder;
 class ColorLabel;
+class NoteBatch;
 
 /**
  * @class Tag
@@ -67,6 +87,12 @@ public:
      */
     std::string getName() const;
 
+    /**
+     * @brief Gets the name of the tag without copying it.
+     * @return A view of the name, valid until the tag is renamed or destroyed.
+     */
+    std::string_view getNameView() const { return name; }
+
     /**
      * @brief Sets the name of the tag.
      * @param name The new name for the tag.
@@ -79,6 +105,24 @@ public:
     void display() const;
 };
 
+/**
+ * @class Reminder
+ * @brief Represents a reminder with a due date.
+ */
+class Reminder {
+private:
+    time_t due_date;
+    std::string description;
+    bool completed;
+
+public:
+    Reminder(time_t due, const std::string& desc);
+    time_t getDueDate() const;
+    std::string getDescription() const;
+    bool isCompleted() const;
+    void markAsCompleted();
+};
+
 /**
  * @class Note
  * @brief Represents a single note.
@@ -88,29 +132,57 @@ public:
  */
 class Note {
     friend class NoteManager;
+    friend class Folder;
+public:
+    /// Most notes have a few tags and at most one reminder: both lists live inside the note until they grow.
+    using TagList = SmallVector<std::shared_ptr<Tag>, 4>;
+    using ReminderList = SmallVector<Reminder, 1>;
+
 private:
     int id;
     std::string title;
-    std::string content;
+    mutable std::string content; // Filled on first access for lazily loaded notes
     time_t creation_date;
     time_t last_modified_date;
-    std::vector<std::shared_ptr<Tag>> tags;
+    TagList tags;
     bool is_in_trash;
     std::vector<NoteVersion> history; // For version control
     std::vector<std::string> attachments; // For file attachments
-    std::vector<Reminder> reminders; // For reminders
+    ReminderList reminders; // For reminders
     std::shared_ptr<ColorLabel> color_label; // For color labels
     bool is_encrypted;
     int word_count;
     int char_count;
+    mutable std::string deferred_content_path; // Non-empty while the body is still on disk
+    // Holds the body instead of `content` once replaceRange() edits a large note; shared copy-on-write
+    // between copies of the note, and moved back into `content` only by flattenContent().
+    std::shared_ptr<PieceTable> large_content;
+    uint64_t deferred_content_offset = 0;
+    uint64_t content_revision = 0; // Bumped by each body change made through replaceRange() or NoteManager
+    std::weak_ptr<Folder> parent_folder; // Maintained by Folder::addNote() and Folder::removeNote()
     static int next_id;
 
     /**
-     * @brief Recalculates the word and character count for the note.
-     * This is a private helper method called whenever the content is updated.
+     * @brief Recalculates the word and character count for the note with a full scan (see countText).
+     * This is a private helper method called whenever the whole content is replaced.
      */
     void updateMetadata();
 
+    /**
+     * @brief Marks the note body as not loaded yet; it will be read from a file on first access.
+     * @param file_path The file holding the body.
+     * @param offset The byte offset of the body inside the file.
+     */
+    void deferContent(const std::string& file_path, uint64_t offset);
+
+    /**
+     * @brief Reads a deferred body from disk. Called at the top of getContent(), setContent(),
+     * getWordCount() and getCharCount(); a no-op once the body is in memory. A piece-table body
+     * is left as it is: getContent() copies it out through forEachContentChunk() and setContent()
+     * replaces it.
+     */
+    void ensureContentLoaded() const;
+
 public:
     /**
      * @brief Adds a file attachment path to the note.
@@ -138,9 +210,9 @@ public:
 
     /**
      * @brief Gets the list of reminders for the note.
-     * @return A constant reference to the vector of reminders.
+     * @return A constant reference to the list of reminders.
      */
-    const std::vector<Reminder>& getReminders() const;
+    const ReminderList& getReminders() const;
 
     /**
      * @brief Sets the color label for the note.
@@ -185,6 +257,8 @@ public:
 
     /**
      * @brief Adds a version to the note's history.
+     * The previous newest version is re-encoded as a delta against this one,
+     * unless it is a keyframe.
      * @param version The NoteVersion object to add.
      */
     void addVersion(const NoteVersion& version);
@@ -236,6 +310,12 @@ public:
      */
     std::string getTitle() const;
 
+    /**
+     * @brief Gets the title of the note without copying it.
+     * @return A view of the title, valid until the title changes or the note is destroyed.
+     */
+    std::string_view getTitleView() const { return title; }
+
     /**
      * @brief Sets the title of the note.
      * @param title The new title for the note.
@@ -249,11 +329,73 @@ public:
     std::string getContent() const;
 
     /**
-     * @brief Sets the content of the note.
+     * @brief Gets the content of the note without copying it, loading a deferred body first.
+     * Only for a body held in one string (isContentContiguous()): read a piece-table body with
+     * forEachContentChunk(), or call flattenContent() first.
+     * @return A view of the content, valid until the note is next edited or destroyed.
+     */
+    std::string_view getContentView() const;
+
+    /**
+     * @brief Checks whether the body is held in one string, i.e. not in a piece table.
+     */
+    bool isContentContiguous() const { return !large_content; }
+
+    /**
+     * @brief Moves a piece-table body back into one string. Costs the size of the note; the counts are unchanged.
+     */
+    void flattenContent();
+
+    /**
+     * @brief Compares the content with a text piece by piece, without copying or flattening it.
+     * @param text The text to compare with.
+     * @return True if the content equals the text.
+     */
+    bool contentEquals(std::string_view text) const;
+
+    /**
+     * @brief Sets the content of the note, replacing a piece-table body.
      * @param content The new content for the note.
      */
     void setContent(const std::string& content);
 
+    /**
+     * @brief Replaces part of the content and updates the word and character counts from the
+     * edited region alone, so an edit costs the size of the edit, not of the note.
+     * @param begin The byte offset where the replaced range starts; clamped to the content.
+     * @param end The byte offset one past the replaced range; clamped to the content and to no less than begin.
+     * @param text The text that takes the range's place.
+     */
+    void replaceRange(size_t begin, size_t end, const std::string& text);
+
+    /**
+     * @brief Gets a counter that changes whenever the body is edited in place, so callers can tell
+     * whether a copy of the body is still current without comparing it.
+     */
+    uint64_t getContentRevision() const { return content_revision; }
+
+    /// Bodies at least this large switch to a PieceTable on their first replaceRange().
+    static constexpr size_t LARGE_CONTENT_THRESHOLD = 256 * 1024;
+
+    /**
+     * @brief Gets the size of the content in bytes without copying it.
+     */
+    size_t getContentSize() const;
+
+    /**
+     * @brief Calls fn(std::string_view) for consecutive pieces of the content, without copying it.
+     * For search, export and rendering of large notes. The views are invalidated by the next edit.
+     */
+    template <typename Fn>
+    void forEachContentChunk(Fn&& fn) const {
+        if (large_content) {
+            large_content->forEachChunk(fn);
+            return;
+        }
+        ensureContentLoaded();
+        fn(std::string_view(content));
+    }
+
     /**
      * @brief Gets the creation date of the note.
      * @return The creation date.
@@ -285,6 +427,18 @@ public:
      */
     std::vector<std::shared_ptr<Tag> > getTags() const;
 
+    /**
+     * @brief Gets the tags of the note without copying the vector.
+     * @return A reference to the note's tags, valid until its tags change.
+     */
+    const TagList& getTagList() const { return tags; }
+
+    /**
+     * @brief Gets the folder that currently contains the note.
+     * @return A shared pointer to the containing folder, or nullptr if the note is not in a folder.
+     */
+    std::shared_ptr<Folder> getParentFolder() const;
+
     /**
      * @brief Checks if the note has a specific tag.
      * @param tag_name The name of the tag to check for.
@@ -299,6 +453,42 @@ public:
     void display(bool detailed = false) const;
 };
 
+/**
+ * @class FolderObserver
+ * @brief Receives row-level notifications when the notes or subfolders of a Folder change.
+ *
+ * The "about to" callbacks run before the folder's vectors are modified and
+ * the others right after, which is the order item models need for their
+ * begin/end row notifications. Note rows are indexes into Folder::getNoteList(),
+ * subfolder rows into Folder::getSubfolderList(). Every callback defaults to
+ * doing nothing, so an observer only overrides what it displays.
+ */
+class FolderObserver {
+public:
+    virtual ~FolderObserver() = default;
+    virtual void noteAboutToBeAdded(const Folder& /*folder*/, size_t /*row*/) {}
+    virtual void noteAdded(const Folder& /*folder*/, size_t /*row*/) {}
+    virtual void noteAboutToBeRemoved(const Folder& /*folder*/, size_t /*row*/) {}
+    virtual void noteRemoved(const Folder& /*folder*/, size_t /*row*/) {}
+    virtual void noteChanged(const Folder& /*folder*/, size_t /*row*/) {}
+    virtual void subfolderAboutToBeAdded(const Folder& /*folder*/, size_t /*row*/) {}
+    virtual void subfolderAdded(const Folder& /*folder*/, size_t /*row*/) {}
+    virtual void subfolderAboutToBeRemoved(const Folder& /*folder*/, size_t /*row*/) {}
+    virtual void subfolderRemoved(const Folder& /*folder*/, size_t /*row*/) {}
+
+    /**
+     * @brief Called when the folder's name, trash state or total note count changed.
+     */
+    virtual void folderChanged(const Folder& /*folder*/) {}
+
+    /**
+     * @brief Called before and after a batch replaces many notes of the folder at once.
+     * No note row callbacks are sent in between; re-read getNoteList() afterwards.
+     */
+    virtual void notesAboutToBeReset(const Folder& /*folder*/) {}
+    virtual void notesReset(const Folder& /*folder*/) {}
+};
+
 /**
  * @class Folder
  * @brief Represents a folder that can contain notes and other folders.
@@ -315,8 +505,41 @@ private:
     std::vector<std::shared_ptr<Note>> notes;
     std::vector<std::shared_ptr<Folder>> subfolders;
     bool is_in_trash;
+    std::vector<FolderObserver*> observers; // Not owned
+    size_t total_note_count = 0;            // Notes in this folder and all subfolders
+    bool rows_suspended = false;            // Note row callbacks are replaced by one reset
+    bool changes_suspended = false;         // folderChanged is sent once, on resume
     static int next_id;
 
+    /**
+     * @brief Adds delta to the cached total note count of this folder and every ancestor.
+     * @param delta The change in the number of notes below this folder.
+     */
+    void adjustTotalNoteCount(long long delta);
+
+    /**
+     * @brief Tells the observers that the folder itself changed. Called by NoteManager::notifyFolderChanged.
+     */
+    void reportChanged() const;
+
+    /**
+     * @brief Tells the observers that a note in this folder was edited.
+     * Called by NoteManager::notifyNoteChanged.
+     * @param note_id The ID of the edited note.
+     */
+    void reportNoteChanged(int note_id) const;
+
+    /**
+     * @brief Holds back observer notifications while NoteManager applies a batch.
+     * @param rows True to also replace the note row callbacks by one notesAboutToBeReset/notesReset pair.
+     */
+    void suspendNotifications(bool rows);
+
+    /**
+     * @brief Ends suspendNotifications() and sends the held-back reset and folderChanged.
+     */
+    void resumeNotifications();
+
 public:
     /**
      * @brief Gets the total number of notes within this folder (non-recursively).
@@ -331,7 +554,8 @@ public:
     size_t getSubfolderCount() const;
 
     /**
-     * @brief Recursively calculates the total number of notes in this folder and all subfolders.
+     * @brief Gets the total number of notes in this folder and all subfolders.
+     * The count is maintained incrementally by addNote, removeNote, addSubfolder and removeSubfolder.
      * @return The total count of all notes contained within this folder's hierarchy.
      */
     size_t getTotalNoteCountRecursive() const;
@@ -369,6 +593,12 @@ public:
      */
     std::string getName() const;
 
+    /**
+     * @brief Gets the name of the folder without copying it.
+     * @return A view of the name, valid until the folder is renamed or destroyed.
+     */
+    std::string_view getNameView() const { return name; }
+
     /**
      * @brief Sets the name of the folder.
      * @param name The new name for the folder.
@@ -388,13 +618,13 @@ public:
     std::shared_ptr<Folder> getParent() const;
 
     /**
-     * @brief Adds a note to the folder.
+     * @brief Adds a note to the folder and points the note's parent back-reference at it.
      * @param note A shared pointer to the note to be added.
      */
     void addNote(std::shared_ptr<Note> note);
 
     /**
-     * @brief Removes a note from the folder by its ID.
+     * @brief Removes a note from the folder by its ID and clears the note's parent back-reference.
      * @param note_id The ID of the note to be removed.
      * @return A shared pointer to the removed note, or nullptr if not found.
      */
@@ -434,12 +664,36 @@ public:
      */
     std::vector<std::shared_ptr<Note> > getNotes() const;
 
+    /**
+     * @brief Gets the notes in the folder without copying the vector.
+     * @return A reference to the folder's notes, valid until the folder changes.
+     */
+    const std::vector<std::shared_ptr<Note>>& getNoteList() const { return notes; }
+
+    /**
+     * @brief Registers an observer for note insertions, removals and edits.
+     * @param observer The observer; it must be removed before it is destroyed.
+     */
+    void addObserver(FolderObserver* observer);
+
+    /**
+     * @brief Unregisters an observer.
+     * @param observer The observer to remove.
+     */
+    void removeObserver(FolderObserver* observer);
+
     /**
      * @brief Gets the list of subfolders in the folder.
      * @return A vector of shared pointers to the subfolders.
      */
     std::vector<std::shared_ptr<Folder> > getSubfolders() const;
 
+    /**
+     * @brief Gets the subfolders without copying the vector.
+     * @return A reference to the folder's subfolders, valid until the folder changes.
+     */
+    const std::vector<std::shared_ptr<Folder>>& getSubfolderList() const { return subfolders; }
+
     /**
      * @brief Displays the contents of the folder.
      * @param indent The indentation string for hierarchical display.
@@ -462,37 +716,41 @@ public:
     std::string getHexCode() const;
 };
 
-/**
- * @class Reminder
- * @brief Represents a reminder with a due date.
- */
-class Reminder {
-private:
-    time_t due_date;
-    std::string description;
-    bool completed;
-
-public:
-    Reminder(time_t due, const std::string& desc);
-    time_t getDueDate() const;
-    std::string getDescription() const;
-    bool isCompleted() const;
-    void markAsCompleted();
-};
-
 /**
  * @class NoteVersion
  * @brief Represents a snapshot of a note's content at a specific time.
  *
  * This class is used to maintain a history of changes for a Note object,
  * allowing for version tracking and restoration.
+ *
+ * Only the newest version of a history and every KEYFRAME_INTERVAL-th version
+ * hold a full copy of the text. When Note::addVersion appends a newer version,
+ * the previous one is re-encoded as a binary delta against it (see
+ * delta_codec), so the memory used by a version is proportional to the size
+ * of the edit that followed it.
  */
 class NoteVersion {
+    friend class Note;
 private:
+    /**
+     * @struct Data
+     * @brief The stored form of a version, shared between copies of the same NoteVersion.
+     */
+    struct Data {
+        std::string payload;         // Full text, or a delta that rebuilds this text from `newer`
+        std::shared_ptr<Data> newer; // Null while the payload is the full text
+    };
+
     time_t version_date;
-    std::string content_snapshot;
+    std::shared_ptr<Data> data;
 
 public:
+    /**
+     * @brief Every version whose index is a multiple of this keeps its full text,
+     * bounding the number of deltas applied by getContent().
+     */
+    static const size_t KEYFRAME_INTERVAL = 32;
+
     /**
      * @brief Constructs a NoteVersion.
      * @param content The content of the note at the time of versioning.
@@ -506,10 +764,29 @@ public:
     time_t getDate() const;
 
     /**
-     * @brief Gets the content snapshot of this version.
+     * @brief Gets the content snapshot of this version, applying deltas if needed.
      * @return The note content as a string.
      */
     std::string getContent() const;
+
+    /**
+     * @brief Gets the content snapshot of this version, copying only when deltas must be applied.
+     * @param buffer Receives the rebuilt text when this version is stored as a delta.
+     * @return A view of the stored full text, or of buffer; valid until buffer or the history changes.
+     */
+    std::string_view getContentView(std::string& buffer) const;
+
+    /**
+     * @brief Checks whether this version stores its full text.
+     * @return True for keyframes and the newest version, false for deltas.
+     */
+    bool isKeyframe() const;
+
+    /**
+     * @brief Gets the number of bytes used to store this version.
+     * @return The payload size in bytes.
+     */
+    size_t getStorageSize() const;
 };
 
 /**
@@ -518,30 +795,113 @@ public:
  *
  * This logger writes timestamped and categorized messages to a specified file,
  * allowing for granular control over log output for debugging and monitoring.
+ *
+ * In asynchronous mode (the default) log() only checks the level, stamps the
+ * record with the current time and pushes it onto a lock-free ring; a
+ * background thread formats the timestamps and writes records in batches.
+ * ERROR records, flush() and destruction all wait until everything logged
+ * before them has reached the file.
  */
 class Logger {
 public:
     enum class Level { DEBUG, INFO, WARNING, ERROR };
+    enum class Mode { Synchronous, Asynchronous };
 
     /**
      * @brief Constructs a Logger instance.
      * @param filename The path to the log file. Defaults to "app.log".
+     * @param mode Whether records are written on the caller's thread or by a background writer.
      */
-    Logger(const std::string& filename = "app.log");
+    Logger(const std::string& filename = "app.log", Mode mode = Mode::Asynchronous);
+
+    /**
+     * @brief Writes out every pending record and stops the writer thread.
+     */
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
 
     /**
      * @brief Writes a message to the log file with a specific level.
+     * Messages below the minimum level are discarded before any formatting.
      * @param level The logging level (e.g., Level::INFO).
      * @param message The message to be logged.
      */
-    void log(Level level, const std::string& message);
+    void log(Level level, std::string message);
+
+    /**
+     * @brief Checks whether messages of a level are currently written.
+     * Use NOTES_LOG to skip building the message string for disabled levels.
+     * @param level The logging level to check.
+     * @return True if the level is at or above the minimum level.
+     */
+    bool isEnabled(Level level) const {
+        return static_cast<int>(level) >= min_level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets the minimum level that is written.
+     * NoteManager applies the "log_level" setting from app.conf (debug, info, warning or error) when it loads.
+     * @param level The new minimum level.
+     */
+    void setLevel(Level level);
+
+    /**
+     * @brief Parses a level name as used in app.conf.
+     * @param name The level name, case-insensitive.
+     * @param fallback The level returned for unknown names.
+     * @return The parsed level.
+     */
+    static Level parseLevel(const std::string& name, Level fallback = Level::INFO);
+
+    /**
+     * @brief Blocks until every record logged so far has been written to the file.
+     */
+    void flush();
 
 private:
+    struct Record {
+        std::chrono::system_clock::time_point time;
+        Level level = Level::INFO;
+        std::string message;
+    };
+
     std::ofstream log_file;
-    std::string getTimestamp() const;
+    std::atomic<int> min_level{static_cast<int>(Level::INFO)};
+    const Mode mode;
+    MpscRing<Record> ring;
+    std::mutex write_mutex;          // Serializes file writes in synchronous mode
+    std::mutex wake_mutex;
+    std::condition_variable wake;    // Wakes the writer early
+    std::condition_variable written; // Signals flush() waiters
+    std::atomic<size_t> written_count{0};
+    std::atomic<bool> flush_requested{false};
+    std::atomic<bool> stopping{false};
+    time_t cached_second = -1;       // The timestamp of the last record, to reuse its formatting
+    std::string cached_timestamp;
+    std::thread writer;
+
+    void writerLoop();
+    bool backlogIsHigh() const;
+    void appendRecord(std::string& out, const Record& record);
+    std::string getTimestamp(std::chrono::system_clock::time_point time);
     std::string levelToString(Level level) const;
 };
 
+/**
+ * @brief Logs a message only if its level is enabled, without evaluating the message otherwise.
+ * @param logger A Logger (not a pointer).
+ * @param level A Logger::Level.
+ * @param message An expression producing the message string.
+ */
+#define NOTES_LOG(logger, level, message)                  \
+    do {                                                   \
+        if ((logger).isEnabled(level)) {                   \
+            (logger).log((level), (message));              \
+        }                                                  \
+    } while (0)
+
 /**
  * @class ConfigManager
  * @brief Manages application configuration settings.
@@ -597,15 +957,30 @@ private:
  * including file persistence, search, and trash management.
  */
 class NoteManager {
+    friend class NoteBatch;
 private:
     std::shared_ptr<Folder> root_folder;
     std::shared_ptr<Folder> trash_folder; // For deleted items
     std::shared_ptr<Folder> current_folder;
     std::vector<std::shared_ptr<Tag>> all_tags;
-    std::map<int, std::shared_ptr<Note>> all_notes_by_id;
-    std::map<int, std::shared_ptr<Folder>> all_folders_by_id;
+    IdHashMap<std::shared_ptr<Note>> all_notes_by_id;     // Iteration order is unspecified
+    IdHashMap<std::shared_ptr<Folder>> all_folders_by_id;
     std::unique_ptr<Logger> logger;
     std::unique_ptr<ConfigManager> config;
+    InvertedIndex keyword_index;
+    TrigramIndex substring_index;
+    TagDictionary tag_dictionary; // Interned tag names and the notes carrying each tag
+    DateIndex notes_by_modified;  // For date-range searches and recently modified listings
+    DateIndex notes_by_created;
+    std::string search_index_path;
+    std::unique_ptr<StorageBackend> storage; // Null when note files are written on the calling thread
+    bool substring_index_ready = false;
+    StartupReport startup_report;
+    std::chrono::steady_clock::time_point startup_begin;
+    SnapshotStore snapshots;        // Versioned copy of the graph for readers on other threads
+    std::atomic<bool> snapshots_enabled{false}; // Set by enableSnapshots(); the hooks keep `snapshots` current
+    std::shared_ptr<ObjectArena> object_arena; // Holds notes, folders and tags unless "object_arena = false"
+    bool object_arena_configured = false;
 
 public:
     void log(const std::string& message);
@@ -619,19 +994,177 @@ public:
      */
     std::shared_ptr<Tag> findTagByName(const std::string& name);
     std::shared_ptr<Folder> findFolderByPath(const std::string& path);
+    // The ID lookups below probe the hash indexes and walk up the parent chain
+    // to check that the result lies under `current`; they do not walk the tree.
     std::shared_ptr<Folder> findFolderByIdRecursive(std::shared_ptr<Folder> current, int id);
     std::shared_ptr<Note> findNoteByIdRecursive(std::shared_ptr<Folder> current, int id);
     std::shared_ptr<const Note> findNoteByIdRecursive(std::shared_ptr<const Folder> current, int id) const; // Const overload
     std::shared_ptr<Folder> findParentFolderOfNote(int note_id);
     std::string getPathForFolder(const std::shared_ptr<Folder>& folder) const;
     void createDirectoriesForFolder(const std::shared_ptr<Folder>& folder) const;
+    // The per-file helpers below are skipped when a StorageBackend is configured, which
+    // includes the per-file layout itself unless "background_writes = false".
     void saveNoteToFile(const std::shared_ptr<Note>& note, const std::shared_ptr<Folder>& folder);
     void deleteNoteFile(const std::shared_ptr<Note>& note, const std::shared_ptr<Folder>& folder);
     void loadNotesFromDirectory(const std::string& path, std::shared_ptr<Folder> parent_folder);
     std::vector<std::string> parseTags(const std::string& tag_string);
+    std::shared_ptr<Tag> findOrCreateTag(const std::string& name);
     void recursivelyDeleteFolder(const std::shared_ptr<Folder>& folder);
     void recursivelyUpdatePaths(const std::shared_ptr<Folder>& folder, const std::string& old_base, const std::string& new_base);
 
+    /**
+     * @brief Creates a Note, Folder or Tag in the object arena, which is set up on first use
+     * from the "object_arena" setting (default true); with the arena off this is make_shared.
+     * @param args The constructor arguments.
+     * @return The new object.
+     */
+    template <typename T, typename... Args>
+    std::shared_ptr<T> makeObject(Args&&... args) {
+        if (!object_arena_configured) {
+            object_arena_configured = true;
+            if (config->get("object_arena", "true") == "true") {
+                object_arena = std::make_shared<ObjectArena>();
+            }
+        }
+        if (!object_arena) {
+            return std::make_shared<T>(std::forward<Args>(args)...);
+        }
+        return std::allocate_shared<T>(ArenaAllocator<T>(object_arena), std::forward<Args>(args)...);
+    }
+
+    // --- Index Maintenance ---
+
+    /**
+     * @brief Brings every search index up to date with a note's title, content, tags and dates.
+     * Called by createNote, editNote, renameNote, revertNoteToVersion and importNoteFromText
+     * after the note has been modified. Observers of the note's folder receive noteChanged.
+     * @param note The note that was created or changed.
+     */
+    void notifyNoteChanged(const std::shared_ptr<Note>& note);
+
+    /**
+     * @brief Drops a note from every search index.
+     * Called when a note is permanently deleted (directly or by emptying the trash).
+     * Trashed notes stay indexed so that SearchCriteria::search_in_trash keeps working.
+     * @param note_id The ID of the removed note.
+     */
+    void notifyNoteRemoved(int note_id);
+
+    /**
+     * @brief Records that a note now lives in another folder.
+     * Called by moveNote, deleteNote (when moving to the trash) and restoreItem.
+     * @param note The moved note.
+     * @param folder The destination folder.
+     */
+    void notifyNoteMoved(const std::shared_ptr<Note>& note, const std::shared_ptr<Folder>& folder);
+
+    /**
+     * @brief Records a tag being added to or removed from a note.
+     * Called by addTagToNote and removeTagFromNote. Tag changes made through editNote or
+     * createNote are picked up by notifyNoteChanged, which resyncs the note's tag set.
+     * @param note_id The ID of the note.
+     * @param tag_name The name of the tag.
+     * @param added True if the tag was added, false if it was removed.
+     */
+    void notifyNoteTagged(int note_id, const std::string& tag_name, bool added);
+
+    /**
+     * @brief Detaches a deleted tag from every note in the tag dictionary.
+     * Called by deleteTag.
+     * @param tag_name The name of the deleted tag.
+     */
+    void notifyTagDeleted(const std::string& tag_name);
+
+    /**
+     * @brief Records a created, renamed, moved or trashed folder.
+     * Observers of the folder receive folderChanged.
+     * @param folder The folder that changed.
+     */
+    void notifyFolderChanged(const std::shared_ptr<Folder>& folder);
+
+    /**
+     * @brief Records a permanently deleted folder.
+     * @param folder_id The ID of the removed folder.
+     */
+    void notifyFolderRemoved(int folder_id);
+
+    /**
+     * @brief Loads the persisted keyword index and reconciles it with the notes in memory.
+     * Called by initializeFromFileSystem once all notes are loaded. Notes modified after
+     * the index was written are re-indexed; stale entries are dropped. The in-memory
+     * trigram index is rebuilt on the first substring query, so lazily loaded note
+     * bodies stay on disk until they are needed. The tag dictionary is rebuilt from
+     * the loaded notes. Snapshots are enabled here when `concurrent_reads = true`, and
+     * note file writes move to a writer thread (see attachFileStorage()).
+     * @param base_path The root directory for active notes; the index lives inside it.
+     */
+    void loadSearchIndex(const std::string& base_path);
+
+    /**
+     * @brief Routes the writes of the per-file layout through a FileStorage on a writer thread.
+     * Does nothing when another backend is in use, with "background_writes = false", or when
+     * note bodies were loaded lazily: those are read from their files in place, which the writer
+     * could move underneath them.
+     */
+    void attachFileStorage();
+
+    /**
+     * @brief Gets the persisted form of a folder. The root folder is referred to by ID 0.
+     */
+    StoredFolder toStoredFolder(const Folder& folder) const;
+
+    /**
+     * @brief Writes the keyword index next to the note files.
+     * @return True if the index was saved successfully, false otherwise.
+     */
+    bool saveSearchIndex() const;
+
+    /**
+     * @brief Applies a NoteBatch: validates every operation, applies them with observers,
+     * indexes and storage held back, then updates each once. If applying throws, the touched
+     * notes and folders are restored and the exception is rethrown. Called by NoteBatch::commit.
+     * @param batch The batch; its error is set if an operation is rejected.
+     * @return True if the batch was applied, false if nothing was changed.
+     */
+    bool commitBatch(NoteBatch& batch);
+
+    // --- Storage Backend ---
+
+    /**
+     * @brief Opens the configured storage backend and replays it into memory.
+     * Called first by initializeFromFileSystem, so it also applies the "log_level" setting. With "storage_backend = journal" in
+     * app.conf, the whole store is loaded by a single sequential scan of
+     * <base_path>/notes.journal and the directory walk is skipped.
+     * @param base_path The root directory for active notes.
+     * @return True if the notes were loaded from a backend, false if the per-file layout is in use.
+     */
+    bool loadFromStorage(const std::string& base_path);
+
+    /**
+     * @brief Builds the folder tree and note metadata from the per-file layout without reading note bodies.
+     * Called by initializeFromFileSystem instead of loadNotesFromDirectory when "lazy_loading = true"
+     * is set in app.conf. Both directory trees are walked in parallel; each note body is read on the
+     * first call to Note::getContent().
+     * @param base_path The root directory for active notes.
+     * @param trash_path The root directory for trashed items.
+     * @return True if the lazy mode is enabled and the notes were loaded, false otherwise.
+     */
+    bool loadLazilyFromDirectories(const std::string& base_path, const std::string& trash_path);
+
+    /**
+     * @brief Finds the notes whose title or content contains a fragment, ignoring case.
+     * Candidates come from the trigram index and are verified against the note text;
+     * fragments shorter than three characters fall back to a scan.
+     * @param fragment The text to look for.
+     * @return The matching notes (including trashed ones), ordered by ID.
+     */
+    std::vector<std::shared_ptr<Note>> findNotesContaining(const std::string& fragment);
+
+    /**
+     * @brief Builds the trigram index if it has not been built since startup.
+     */
+    void ensureSubstringIndex();
+
 public:
     /**
      * @brief Finds a note by its unique ID across all folders.
@@ -641,12 +1174,23 @@ public:
     std::shared_ptr<Note> findNoteById(int id);
     std::shared_ptr<const Note> findNoteById(int id) const; // Const overload
     std::shared_ptr<Folder> getRootFolder() const;
+
+    /**
+     * @brief Gets the folder that holds trashed items.
+     * @return A shared pointer to the trash folder.
+     */
+    std::shared_ptr<Folder> getTrashFolder() const;
     std::shared_ptr<Folder> findFolderById(int id);
     /**
      * @brief Constructs a NoteManager and initializes the root folder.
      */
     NoteManager();
 
+    /**
+     * @brief Destructor for NoteManager. Persists the search index.
+     */
+    ~NoteManager();
+
     // --- Folder Operations ---
 
     /**
@@ -745,6 +1289,16 @@ public:
     bool editNote(int note_id, const std::string& new_title, const std::string& new_content);
     bool editNote(int note_id, const std::string& new_title, const std::string& new_content, const std::vector<std::string>& new_tags);
 
+    /**
+     * @brief Replaces a note's content, versioning only when asked. Used by the editor's autosave,
+     * which saves far more often than a version should be kept.
+     * @param note_id The ID of the note.
+     * @param new_content The new content.
+     * @param record_version True to keep the previous content as a version ("enable_versioning" permitting).
+     * @return True if the note exists, false otherwise. Unchanged content is not saved again.
+     */
+    bool saveNoteContent(int note_id, const std::string& new_content, bool record_version);
+
     /**
      * @brief Reverts a note to a previous version.
      * @param note_id The ID of the note to revert.
@@ -794,15 +1348,39 @@ public:
 
     /**
      * @brief Searches for notes by a keyword in their title or content.
+     * The keyword matches anywhere inside a word ("nfig" finds "config"), ignoring case.
      * @param keyword The keyword to search for.
-     * @return A vector of shared pointers to the matching notes.
+     * @return A vector of shared pointers to the matching notes, ordered by ID.
      */
     std::vector<std::shared_ptr<Note>> searchNotesByKeyword(const std::string& keyword);
 
     /**
-     * @brief Searches for notes by a tag.
+     * @struct RankedNote
+     * @brief A note returned by searchNotesRanked(), with its relevance score.
+     */
+    struct RankedNote {
+        std::shared_ptr<Note> note;
+        double score;
+    };
+
+    /**
+     * @brief Finds the notes most relevant to a query, best first.
+     * Notes are scored with BM25F over their title and content words, title
+     * matches counting more, and only the best `limit` are kept, so common
+     * words do not make the query read every posting. Unlike searchNotesByKeyword(),
+     * query words must match whole words.
+     * @param query The words to look for; a note needs at least one of them.
+     * @param limit The maximum number of results.
+     * @param include_trash True to include notes in the trash.
+     * @return Up to limit notes, best first.
+     */
+    std::vector<RankedNote> searchNotesRanked(const std::string& query, size_t limit, bool include_trash = false);
+
+    /**
+     * @brief Searches for notes by a tag, using the tag's bitmap instead of scanning notes.
+     * Notes in the trash are skipped.
      * @param tag_name The name of the tag to search for.
-     * @return A vector of shared pointers to the matching notes.
+     * @return A vector of shared pointers to the matching notes, ordered by ID.
      */
     std::vector<std::shared_ptr<Note>> searchNotesByTag(const std::string& tag_name);
 
@@ -813,18 +1391,41 @@ public:
     struct SearchCriteria {
         std::string keyword;
         std::vector<std::string> tags;
+        bool match_any_tag = false; // By default a note must carry every tag in `tags`
         time_t start_date = 0;
         time_t end_date = 0;
         bool search_in_trash = false;
+        /// Which timestamp start_date and end_date apply to.
+        enum class DateField { Modified, Created } date_field = DateField::Modified;
+        /// Orders the results by date_field, newest first, instead of by note ID.
+        bool newest_first = false;
     };
 
     /**
      * @brief Performs an advanced search for notes based on multiple criteria.
+     * The predicate expected to match the fewest notes, judged from the tag
+     * bitmaps, the date indexes and the trigram index, produces the candidates;
+     * the others filter them, cheapest first, and the text match runs last.
      * @param criteria The search criteria.
-     * @return A vector of shared pointers to matching notes.
+     * @return A vector of shared pointers to matching notes, ordered by ID unless criteria.newest_first is set.
      */
     std::vector<std::shared_ptr<Note>> searchNotes(const SearchCriteria& criteria);
 
+    /**
+     * @brief Runs a search like searchNotes() and reports how it was evaluated.
+     * @param criteria The search criteria.
+     * @return The plan, with the estimate, the rows and the time of each step.
+     */
+    QueryPlan explainSearch(const SearchCriteria& criteria);
+
+    /**
+     * @brief Lists the most recently modified notes, newest first, without scanning or sorting every note.
+     * @param limit The maximum number of notes to return.
+     * @param include_trash True to include notes in the trash.
+     * @return Up to limit notes, newest first.
+     */
+    std::vector<std::shared_ptr<Note>> getRecentlyModifiedNotes(size_t limit, bool include_trash = false);
+
     // --- Trash Management ---
 
     /**
@@ -883,6 +1484,25 @@ public:
      */
     void initializeFromFileSystem(const std::string& base_path = "data", const std::string& trash_path = "trash");
 
+    /**
+     * @brief Gets the timings of the last initializeFromFileSystem call.
+     * @return The startup report.
+     */
+    const StartupReport& getStartupReport() const;
+
+    /**
+     * @brief Gets the memory held by the arena that stores notes, folders and tags.
+     * @return The arena's statistics; all zero when the arena is off or nothing was created in it yet.
+     */
+    ObjectArena::Stats getObjectArenaStats() const;
+
+    /**
+     * @brief Makes every change so far durable. With "background_writes = true" (the default) the
+     * journal or the note files are written on a background thread, and this waits for it to catch up.
+     * @return True if every write since the last flush succeeded, false otherwise.
+     */
+    bool flushStorage();
+
     // --- Utility Functions ---
     /**
      * @brief Trims whitespace from the beginning and end of a string.
@@ -891,13 +1511,129 @@ public:
      */
     static std::string trim(const std::string& str);
 
+    /**
+     * @brief Gets a value from the application configuration.
+     * @param key The configuration key.
+     * @param default_value The value returned if the key is not set.
+     * @return The configured value.
+     */
+    std::string getSetting(const std::string& key, const std::string& default_value = "") const;
+
     /**
      * @brief Converts a note's content from Markdown to HTML.
      * @param note_id The ID of the note to convert.
      * @return A string containing the HTML representation of the note's content.
      */
     std::string convertNoteToHtml(int note_id);
-    std::set<std::shared_ptr<Tag>> getAllTags() const;
+
+    /**
+     * @brief Gets every known tag, in creation order.
+     * @return A reference to the manager's tag list; no copy is made.
+     */
+    const std::vector<std::shared_ptr<Tag>>& getAllTags() const;
+
+    // --- Concurrent Reads ---
+
+    /**
+     * @brief Starts maintaining versioned snapshots of the notes and folders.
+     * Copies the current graph into a first version; afterwards every edit publishes
+     * a new one. Lazily loaded note bodies are read from disk during the copy.
+     * Must be called on the thread that edits the notes.
+     */
+    void enableSnapshots();
+
+    /**
+     * @brief Checks if snapshots are maintained.
+     */
+    bool snapshotsEnabled() const { return snapshots_enabled.load(); }
+
+    /**
+     * @brief Gets the latest published snapshot. Safe to call from any thread.
+     * The snapshot never changes, so searches, exports or autosave can run on it
+     * while the GUI thread keeps editing.
+     * @return The snapshot, or nullptr if snapshots are not enabled.
+     */
+    std::shared_ptr<const NoteSnapshot> getSnapshot() const;
+
+    /**
+     * @brief Runs searchNotes() against a snapshot instead of the live notes.
+     * Needs no lock and may run on any thread; it scans the snapshot rather than
+     * using the live indexes.
+     * @param snapshot The snapshot to search.
+     * @param criteria The search criteria.
+     * @return The matching notes, in ID order unless criteria.newest_first is set.
+     */
+    static std::vector<std::shared_ptr<const NoteRecord>> searchNotes(const NoteSnapshot& snapshot,
+                                                                     const SearchCriteria& criteria);
+
+    /**
+     * @brief Checks a snapshot note against search criteria, as searchNotes(snapshot, criteria) does.
+     * @param note The note.
+     * @param criteria The criteria; the keyword is used as is, so it should already be trimmed.
+     * @return True if the note matches.
+     */
+    static bool matchesCriteria(const NoteRecord& note, const SearchCriteria& criteria);
+
+    /**
+     * @brief Orders snapshot notes newest first by a date, the way searchNotes() does with newest_first.
+     * @param notes The notes to sort.
+     * @param field The date to order by.
+     */
+    static void sortNewestFirst(std::vector<std::shared_ptr<const NoteRecord>>& notes,
+                                SearchCriteria::DateField field);
+
+private:
+    friend class SearchCursor;
+
+    /**
+     * @struct PreparedSearch
+     * @brief A planned search: its steps and the index data they read.
+     */
+    struct PreparedSearch {
+        std::vector<QueryStep> steps; // steps[0] produces the candidates, the others filter them
+        RoaringBitmap tagged;         // Notes carrying the searched tags
+        std::string keyword;          // Trimmed
+        time_t from = 0;              // Date range, with open ends widened to the limits of time_t
+        time_t to = 0;
+        bool by_creation = false;
+        bool newest_first = false;
+        bool short_circuit = false;   // Some step matches no note
+    };
+
+    /**
+     * @brief Estimates each predicate of a search and orders them into steps.
+     */
+    PreparedSearch prepareSearch(const SearchCriteria& criteria);
+
+    /**
+     * @brief Produces the IDs of the driving step, in the order the results are returned.
+     * @param search The prepared search; must not be short-circuited.
+     * @param ordering Receives a description of how the order was obtained, if not null.
+     * @param dates Receives, in newest-first order and if not null, the date each candidate was ordered by.
+     * @return The candidate IDs: by ID, or newest first by the searched date.
+     */
+    std::vector<int> searchCandidates(const PreparedSearch& search, std::string* ordering,
+                                      std::vector<time_t>* dates = nullptr);
+
+    /**
+     * @brief Checks a note against one filtering step of a search.
+     */
+    bool passesSearchStep(const PreparedSearch& search, const QueryStep& step, const Note& note) const;
+
+    /**
+     * @brief Gets the date a search compares and orders by.
+     */
+    static time_t searchDate(const PreparedSearch& search, const Note& note) {
+        return search.by_creation ? note.getCreationDate() : note.getLastModifiedDate();
+    }
+
+    /**
+     * @brief Plans and runs a search for searchNotes() and explainSearch().
+     * @param criteria The search criteria.
+     * @param explain Receives the plan with its descriptions and timings, if not null.
+     * @return The matching notes.
+     */
+    std::vector<std::shared_ptr<Note>> runSearch(const SearchCriteria& criteria, QueryPlan* explain);
 };
 
 #endif // NOTES_HPP
\ No newline at end of file
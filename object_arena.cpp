@@ -0,0 +1,70 @@
+/**
+ * @file object_arena.cpp
+ * @brief Implementation of the ObjectArena class.
+ */
+
+#include "object_arena.hpp"
+
+namespace {
+
+size_t roundUp(size_t size, size_t granularity) {
+    return (size + granularity - 1) / granularity * granularity;
+}
+
+} // namespace
+
+void* ObjectArena::allocate(size_t size, size_t alignment) {
+    if (!fits(size, alignment)) {
+        return ::operator new(size);
+    }
+    const size_t block_size = roundUp(size == 0 ? 1 : size, GRANULARITY);
+    const size_t size_class = block_size / GRANULARITY - 1;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    void* block;
+    if (FreeBlock* reused = free_lists[size_class]) {
+        free_lists[size_class] = reused->next;
+        block = reused;
+    } else {
+        if (static_cast<size_t>(slab_end - cursor) < block_size) {
+            // The tail of the old slab is left unused; it is less than MAX_BLOCK_SIZE.
+            slabs.push_back(std::unique_ptr<char[]>(new char[SLAB_SIZE]));
+            cursor = slabs.back().get();
+            slab_end = cursor + SLAB_SIZE;
+        }
+        block = cursor;
+        cursor += block_size;
+    }
+    live_bytes += block_size;
+    ++live_blocks;
+    return block;
+}
+
+void ObjectArena::deallocate(void* block, size_t size, size_t alignment) noexcept {
+    if (!block) {
+        return;
+    }
+    if (!fits(size, alignment)) {
+        ::operator delete(block);
+        return;
+    }
+    const size_t block_size = roundUp(size == 0 ? 1 : size, GRANULARITY);
+    const size_t size_class = block_size / GRANULARITY - 1;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    FreeBlock* freed = static_cast<FreeBlock*>(block);
+    freed->next = free_lists[size_class];
+    free_lists[size_class] = freed;
+    live_bytes -= block_size;
+    --live_blocks;
+}
+
+ObjectArena::Stats ObjectArena::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats stats;
+    stats.slab_count = slabs.size();
+    stats.reserved_bytes = slabs.size() * SLAB_SIZE;
+    stats.live_bytes = live_bytes;
+    stats.live_blocks = live_blocks;
+    return stats;
+}
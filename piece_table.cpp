@@ -0,0 +1,170 @@
+/**
+ * @file piece_table.cpp
+ * @brief Implementation of the PieceTable class.
+ */
+
+#include "piece_table.hpp"
+
+#include <algorithm>
+
+PieceTable::PieceTable(std::string text) : original(std::move(text)) {
+    if (!original.empty()) {
+        root = newNode(Piece{false, 0, original.size()});
+    }
+}
+
+int32_t PieceTable::newNode(const Piece& piece) {
+    // xorshift32: treap priorities only need to be unpredictable relative to the edit pattern.
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    Node node;
+    node.piece = piece;
+    node.priority = random_state;
+    node.subtree_length = piece.length;
+    if (!free_nodes.empty()) {
+        const int32_t index = free_nodes.back();
+        free_nodes.pop_back();
+        nodes[index] = node;
+        return index;
+    }
+    nodes.push_back(node);
+    return static_cast<int32_t>(nodes.size() - 1);
+}
+
+void PieceTable::freeSubtree(int32_t node) {
+    std::vector<int32_t> pending{node};
+    while (!pending.empty()) {
+        const int32_t current = pending.back();
+        pending.pop_back();
+        if (current < 0) continue;
+        pending.push_back(nodes[current].left);
+        pending.push_back(nodes[current].right);
+        free_nodes.push_back(current);
+    }
+}
+
+void PieceTable::update(int32_t node) {
+    Node& n = nodes[node];
+    n.subtree_length = length(n.left) + n.piece.length + length(n.right);
+}
+
+int32_t PieceTable::merge(int32_t left, int32_t right) {
+    if (left < 0) return right;
+    if (right < 0) return left;
+    if (nodes[left].priority > nodes[right].priority) {
+        const int32_t merged = merge(nodes[left].right, right);
+        nodes[left].right = merged;
+        update(left);
+        return left;
+    }
+    const int32_t merged = merge(left, nodes[right].left);
+    nodes[right].left = merged;
+    update(right);
+    return right;
+}
+
+void PieceTable::split(int32_t node, size_t position, int32_t& left, int32_t& right) {
+    if (node < 0) {
+        left = right = -1;
+        return;
+    }
+    // Work on indexes only: newNode() may grow the vector and move every Node.
+    const size_t left_length = length(nodes[node].left);
+    const size_t piece_length = nodes[node].piece.length;
+    if (position <= left_length) {
+        int32_t inner_left, inner_right;
+        split(nodes[node].left, position, inner_left, inner_right);
+        nodes[node].left = inner_right;
+        update(node);
+        left = inner_left;
+        right = node;
+    } else if (position >= left_length + piece_length) {
+        int32_t inner_left, inner_right;
+        split(nodes[node].right, position - left_length - piece_length, inner_left, inner_right);
+        nodes[node].right = inner_left;
+        update(node);
+        left = node;
+        right = inner_right;
+    } else {
+        // The position falls inside this piece: keep the head here and move the tail into a new node.
+        const size_t cut = position - left_length;
+        Piece tail = nodes[node].piece;
+        tail.offset += cut;
+        tail.length -= cut;
+        const int32_t tail_node = newNode(tail);
+        const int32_t old_right = nodes[node].right;
+        nodes[node].piece.length = cut;
+        nodes[node].right = -1;
+        update(node);
+        left = node;
+        right = merge(tail_node, old_right);
+    }
+}
+
+char PieceTable::at(size_t position) const {
+    int32_t node = root;
+    while (node >= 0) {
+        const Node& n = nodes[node];
+        const size_t left_length = length(n.left);
+        if (position < left_length) {
+            node = n.left;
+        } else if (position < left_length + n.piece.length) {
+            return view(n.piece)[position - left_length];
+        } else {
+            position -= left_length + n.piece.length;
+            node = n.right;
+        }
+    }
+    return '\0';
+}
+
+void PieceTable::insert(size_t position, std::string_view text) {
+    if (text.empty()) {
+        return;
+    }
+    position = std::min(position, size());
+    int32_t left, right;
+    split(root, position, left, right);
+
+    // Typing appends to the insertion buffer right after the previous keystroke: grow that piece.
+    int32_t last = left;
+    while (last >= 0 && nodes[last].right >= 0) last = nodes[last].right;
+    if (last >= 0 && nodes[last].piece.inserted &&
+        nodes[last].piece.offset + nodes[last].piece.length == insertions.size()) {
+        insertions.append(text.data(), text.size());
+        nodes[last].piece.length += text.size();
+        for (int32_t node = left; node >= 0; node = nodes[node].right) {
+            nodes[node].subtree_length += text.size(); // Every node on the right spine contains the grown piece
+        }
+        root = merge(left, right);
+        return;
+    }
+
+    const size_t offset = insertions.size();
+    insertions.append(text.data(), text.size());
+    root = merge(merge(left, newNode(Piece{true, offset, text.size()})), right);
+}
+
+void PieceTable::erase(size_t position, size_t count) {
+    if (position >= size() || count == 0) {
+        return;
+    }
+    int32_t left, middle, right;
+    split(root, position, left, middle);
+    split(middle, std::min(count, length(middle)), middle, right);
+    freeSubtree(middle);
+    root = merge(left, right);
+}
+
+void PieceTable::replace(size_t position, size_t count, std::string_view text) {
+    erase(position, count);
+    insert(position, text);
+}
+
+std::string PieceTable::substr(size_t position, size_t count) const {
+    std::string text;
+    text.reserve(std::min(count, size() - std::min(position, size())));
+    forEachChunk(position, count, [&text](std::string_view chunk) { text.append(chunk.data(), chunk.size()); });
+    return text;
+}
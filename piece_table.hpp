@@ -0,0 +1,154 @@
+/**
+ * @file piece_table.hpp
+ * @brief This file contains the piece table that stores the body of large notes.
+ */
+
+#ifndef PIECE_TABLE_HPP
+#define PIECE_TABLE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class PieceTable
+ * @brief An editable text made of pieces of two buffers: the original text and an append-only buffer of insertions.
+ *
+ * The pieces sit in an implicit treap ordered by text position, each node
+ * caching the byte length of its subtree, so locating a position, inserting
+ * and erasing are O(log n) in the number of pieces and never move the text
+ * itself. Typing at the end of the last insertion grows that piece instead of
+ * adding one. Readers walk the pieces as string_views without copying; the
+ * views stay valid until the next modification.
+ */
+class PieceTable {
+public:
+    PieceTable() = default;
+
+    /**
+     * @brief Constructs a table holding a text. The text is moved in, not copied.
+     * @param text The initial text.
+     */
+    explicit PieceTable(std::string text);
+
+    /**
+     * @brief Gets the length of the text in bytes.
+     */
+    size_t size() const { return length(root); }
+
+    /**
+     * @brief Gets the number of pieces the text is made of.
+     */
+    size_t pieceCount() const { return nodes.size() - free_nodes.size(); }
+
+    /**
+     * @brief Gets the byte at a position. O(log n).
+     * @param position The position; must be less than size().
+     */
+    char at(size_t position) const;
+
+    /**
+     * @brief Inserts text. Positions past the end append.
+     * @param position The byte position to insert at.
+     * @param text The text to insert.
+     */
+    void insert(size_t position, std::string_view text);
+
+    /**
+     * @brief Erases a range. The range is clamped to the text.
+     * @param position The byte position of the first erased byte.
+     * @param count The number of bytes to erase.
+     */
+    void erase(size_t position, size_t count);
+
+    /**
+     * @brief Replaces a range with text, i.e. erase() then insert().
+     */
+    void replace(size_t position, size_t count, std::string_view text);
+
+    /**
+     * @brief Copies a range of the text. The range is clamped to the text.
+     */
+    std::string substr(size_t position, size_t count) const;
+
+    /**
+     * @brief Copies the whole text.
+     */
+    std::string toString() const { return substr(0, size()); }
+
+    /**
+     * @brief Calls fn(std::string_view) for each piece of the text, in order.
+     */
+    template <typename Fn>
+    void forEachChunk(Fn&& fn) const {
+        visit(root, 0, 0, size(), fn);
+    }
+
+    /**
+     * @brief Calls fn(std::string_view) for each piece of a range of the text, in order. The range is clamped.
+     */
+    template <typename Fn>
+    void forEachChunk(size_t position, size_t count, Fn&& fn) const {
+        const size_t end = position + std::min(count, size() - std::min(position, size()));
+        visit(root, 0, position, end, fn);
+    }
+
+private:
+    struct Piece {
+        bool inserted = false; // In insertions, otherwise in original
+        size_t offset = 0;
+        size_t length = 0;
+    };
+
+    struct Node {
+        Piece piece;
+        uint32_t priority = 0;
+        int32_t left = -1;
+        int32_t right = -1;
+        size_t subtree_length = 0;
+    };
+
+    std::string_view view(const Piece& piece) const {
+        return std::string_view(piece.inserted ? insertions : original).substr(piece.offset, piece.length);
+    }
+
+    size_t length(int32_t node) const { return node < 0 ? 0 : nodes[node].subtree_length; }
+
+    template <typename Fn>
+    void visit(int32_t node, size_t base, size_t from, size_t to, Fn& fn) const {
+        if (node < 0 || from >= to) {
+            return;
+        }
+        const Node& n = nodes[node];
+        const size_t start = base + length(n.left);
+        const size_t end = start + n.piece.length;
+        if (from < start) {
+            visit(n.left, base, from, to, fn);
+        }
+        if (from < end && to > start) {
+            const size_t first = std::max(from, start);
+            fn(view(n.piece).substr(first - start, std::min(to, end) - first));
+        }
+        if (to > end) {
+            visit(n.right, end, from, to, fn);
+        }
+    }
+
+    int32_t newNode(const Piece& piece);
+    void freeSubtree(int32_t node);
+    void update(int32_t node);
+    int32_t merge(int32_t left, int32_t right);
+    void split(int32_t node, size_t position, int32_t& left, int32_t& right);
+
+    std::string original;
+    std::string insertions; // Append-only
+    std::vector<Node> nodes;
+    std::vector<int32_t> free_nodes;
+    int32_t root = -1;
+    uint32_t random_state = 0x9E3779B9u;
+};
+
+#endif // PIECE_TABLE_HPP
@@ -0,0 +1,48 @@
+/**
+ * @file query_plan.cpp
+ * @brief Implementation of QueryPlan::describe.
+ */
+
+#include "query_plan.hpp"
+
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+const char* stepRole(size_t index, const QueryStep& step) {
+    if (index == 0) {
+        return step.kind == QueryStep::Kind::AllNotes ? "scan" : "drive";
+    }
+    return "filter";
+}
+
+std::string formatCount(size_t count) {
+    return count == SIZE_MAX ? "?" : std::to_string(count);
+}
+
+} // namespace
+
+std::string QueryPlan::describe() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "Plan for " << total_notes << " notes: " << result_count << " results in "
+        << static_cast<double>(total_ns) / 1e6 << " ms (planning " << static_cast<double>(plan_ns) / 1e6 << " ms)\n";
+    out << "  #  " << std::left << std::setw(7) << "step" << std::setw(44) << "predicate" << std::right
+        << std::setw(10) << "estimate" << std::setw(10) << "in" << std::setw(10) << "out" << std::setw(12) << "ms"
+        << "\n";
+    for (size_t i = 0; i < steps.size(); ++i) {
+        const QueryStep& step = steps[i];
+        out << "  " << i + 1 << "  " << std::left << std::setw(7) << stepRole(i, step) << std::setw(44)
+            << step.description << std::right << std::setw(10) << formatCount(step.estimated_rows) << std::setw(10)
+            << step.rows_in << std::setw(10) << step.rows_out << std::setw(12)
+            << static_cast<double>(step.time_ns) / 1e6 << "\n";
+    }
+    if (short_circuited) {
+        out << "  Stopped before scanning: a predicate matches no note.\n";
+    }
+    if (!ordering.empty()) {
+        out << "  Order: " << ordering << "\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,65 @@
+/**
+ * @file query_plan.hpp
+ * @brief This file contains the plan NoteManager::searchNotes builds for a query, as reported by explain.
+ */
+
+#ifndef QUERY_PLAN_HPP
+#define QUERY_PLAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct QueryStep
+ * @brief One predicate of a search, with the planner's estimate and, after execution, what it did.
+ */
+struct QueryStep {
+    enum class Kind {
+        AllNotes,  ///< No index predicate: every note is a candidate.
+        Tags,      ///< Tag bitmap from the tag dictionary (exact cardinality).
+        DateRange, ///< Range of a date index.
+        Keyword,   ///< Substring match, narrowed by the trigram index.
+        NotInTrash ///< Only a filter: trashed notes have no index of their own.
+    };
+
+    Kind kind = Kind::AllNotes;
+    size_t estimated_rows = 0; ///< Point estimate used to order the steps.
+    size_t upper_bound = SIZE_MAX; ///< Guaranteed maximum of matching notes; 0 lets the search stop at once.
+    std::string description;   ///< Filled only when the plan is explained.
+
+    size_t rows_in = 0;     ///< Notes this step examined.
+    size_t rows_out = 0;    ///< Notes that passed it.
+    uint64_t time_ns = 0;   ///< Time spent in the step; measured only when explaining.
+
+    QueryStep() = default;
+    QueryStep(Kind kind, size_t estimated_rows, size_t upper_bound)
+        : kind(kind), estimated_rows(estimated_rows), upper_bound(upper_bound) {}
+};
+
+/**
+ * @struct QueryPlan
+ * @brief The steps of a search in evaluation order: steps[0] produces the candidates, the rest filter them.
+ *
+ * The planner drives the search from the predicate with the lowest estimate,
+ * applies the cheap filters (tags, dates, trash) by increasing selectivity,
+ * and keeps the substring match, the only one that reads note text, for last.
+ */
+struct QueryPlan {
+    std::vector<QueryStep> steps;
+    size_t total_notes = 0;
+    size_t result_count = 0;
+    bool short_circuited = false; ///< A step could match no note, so nothing was scanned.
+    std::string ordering;         ///< How the results were put in order, e.g. "by ID (sorted)".
+    uint64_t plan_ns = 0;
+    uint64_t total_ns = 0;
+
+    /**
+     * @brief Formats the plan as a table, one step per line.
+     * @return The text shown by the CLI explain command.
+     */
+    std::string describe() const;
+};
+
+#endif // QUERY_PLAN_HPP
@@ -0,0 +1,240 @@
+/**
+ * @file roaring_bitmap.cpp
+ * @brief Implementation of the RoaringBitmap class.
+ */
+
+#include "roaring_bitmap.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+unsigned popCount(uint64_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(w));
+#else
+    unsigned count = 0;
+    for (; w != 0; w &= w - 1) ++count;
+    return count;
+#endif
+}
+
+bool testBit(const std::vector<uint64_t>& bits, uint16_t low) {
+    return (bits[low >> 6] >> (low & 63)) & 1;
+}
+
+} // namespace
+
+unsigned RoaringBitmap::countTrailingZeros(uint64_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(w));
+#else
+    unsigned n = 0;
+    while ((w & 1) == 0) {
+        w >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+RoaringBitmap::Container* RoaringBitmap::findContainer(uint16_t key) {
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    return it != containers.end() && it->key == key ? &*it : nullptr;
+}
+
+const RoaringBitmap::Container* RoaringBitmap::findContainer(uint16_t key) const {
+    return const_cast<RoaringBitmap*>(this)->findContainer(key);
+}
+
+void RoaringBitmap::toBitmap(Container& container) {
+    container.bits.assign(BITMAP_WORDS, 0);
+    for (uint16_t low : container.values) {
+        container.bits[low >> 6] |= uint64_t(1) << (low & 63);
+    }
+    container.values.clear();
+    container.values.shrink_to_fit();
+}
+
+void RoaringBitmap::toArray(Container& container) {
+    container.values.clear();
+    container.values.reserve(container.count);
+    for (size_t word = 0; word < container.bits.size(); ++word) {
+        for (uint64_t w = container.bits[word]; w != 0; w &= w - 1) {
+            container.values.push_back(static_cast<uint16_t>(word * 64 + countTrailingZeros(w)));
+        }
+    }
+    container.bits.clear();
+    container.bits.shrink_to_fit();
+}
+
+bool RoaringBitmap::add(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+                               [](const Container& c, uint16_t k) { return c.key < k; });
+    if (it == containers.end() || it->key != key) {
+        it = containers.insert(it, Container());
+        it->key = key;
+    }
+    Container& container = *it;
+
+    if (!container.bits.empty()) {
+        uint64_t& word = container.bits[low >> 6];
+        const uint64_t mask = uint64_t(1) << (low & 63);
+        if (word & mask) return false;
+        word |= mask;
+        ++container.count;
+        return true;
+    }
+
+    auto pos = std::lower_bound(container.values.begin(), container.values.end(), low);
+    if (pos != container.values.end() && *pos == low) return false;
+    container.values.insert(pos, low);
+    ++container.count;
+    if (container.count > ARRAY_LIMIT) toBitmap(container);
+    return true;
+}
+
+bool RoaringBitmap::remove(uint32_t value) {
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    Container* container = findContainer(static_cast<uint16_t>(value >> 16));
+    if (!container) return false;
+
+    if (!container->bits.empty()) {
+        uint64_t& word = container->bits[low >> 6];
+        const uint64_t mask = uint64_t(1) << (low & 63);
+        if (!(word & mask)) return false;
+        word &= ~mask;
+        // Convert back only well below the limit so a tag hovering around it does not flip-flop.
+        if (--container->count <= ARRAY_LIMIT / 2) toArray(*container);
+    } else {
+        auto pos = std::lower_bound(container->values.begin(), container->values.end(), low);
+        if (pos == container->values.end() || *pos != low) return false;
+        container->values.erase(pos);
+        --container->count;
+    }
+    if (container->count == 0) {
+        containers.erase(containers.begin() + (container - containers.data()));
+    }
+    return true;
+}
+
+bool RoaringBitmap::contains(uint32_t value) const {
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    const Container* container = findContainer(static_cast<uint16_t>(value >> 16));
+    if (!container) return false;
+    if (!container->bits.empty()) return testBit(container->bits, low);
+    return std::binary_search(container->values.begin(), container->values.end(), low);
+}
+
+size_t RoaringBitmap::cardinality() const {
+    size_t total = 0;
+    for (const Container& container : containers) total += container.count;
+    return total;
+}
+
+std::vector<uint32_t> RoaringBitmap::toVector() const {
+    std::vector<uint32_t> out;
+    out.reserve(cardinality());
+    forEach([&out](uint32_t value) { out.push_back(value); });
+    return out;
+}
+
+size_t RoaringBitmap::memoryUsage() const {
+    size_t bytes = containers.capacity() * sizeof(Container);
+    for (const Container& container : containers) {
+        bytes += container.values.capacity() * sizeof(uint16_t) + container.bits.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+// --- Set Operations ---
+
+bool RoaringBitmap::intersectContainers(const Container& a, const Container& b, Container& out) {
+    out.key = a.key;
+    if (!a.bits.empty() && !b.bits.empty()) {
+        out.bits.resize(BITMAP_WORDS);
+        uint32_t count = 0;
+        for (size_t i = 0; i < BITMAP_WORDS; ++i) {
+            out.bits[i] = a.bits[i] & b.bits[i];
+            count += popCount(out.bits[i]);
+        }
+        out.count = count;
+        if (count <= ARRAY_LIMIT) toArray(out);
+    } else if (a.bits.empty() && b.bits.empty()) {
+        std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                              std::back_inserter(out.values));
+        out.count = static_cast<uint32_t>(out.values.size());
+    } else {
+        // Probe the array side against the bitmap side.
+        const Container& array = a.bits.empty() ? a : b;
+        const Container& bitmap = a.bits.empty() ? b : a;
+        for (uint16_t low : array.values) {
+            if (testBit(bitmap.bits, low)) out.values.push_back(low);
+        }
+        out.count = static_cast<uint32_t>(out.values.size());
+    }
+    return out.count > 0;
+}
+
+void RoaringBitmap::uniteContainers(const Container& a, const Container& b, Container& out) {
+    out.key = a.key;
+    if (a.bits.empty() && b.bits.empty() && a.count + b.count <= ARRAY_LIMIT) {
+        std::set_union(a.values.begin(), a.values.end(), b.values.begin(), b.values.end(),
+                       std::back_inserter(out.values));
+        out.count = static_cast<uint32_t>(out.values.size());
+        return;
+    }
+    out.bits.assign(BITMAP_WORDS, 0);
+    for (const Container* side : {&a, &b}) {
+        if (!side->bits.empty()) {
+            for (size_t i = 0; i < BITMAP_WORDS; ++i) out.bits[i] |= side->bits[i];
+        } else {
+            for (uint16_t low : side->values) out.bits[low >> 6] |= uint64_t(1) << (low & 63);
+        }
+    }
+    uint32_t count = 0;
+    for (uint64_t w : out.bits) count += popCount(w);
+    out.count = count;
+    if (count <= ARRAY_LIMIT) toArray(out);
+}
+
+RoaringBitmap RoaringBitmap::intersect(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < a.containers.size() && j < b.containers.size()) {
+        const Container& ca = a.containers[i];
+        const Container& cb = b.containers[j];
+        if (ca.key < cb.key) {
+            ++i;
+        } else if (cb.key < ca.key) {
+            ++j;
+        } else {
+            Container out;
+            if (intersectContainers(ca, cb, out)) result.containers.push_back(std::move(out));
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+RoaringBitmap RoaringBitmap::unite(const RoaringBitmap& a, const RoaringBitmap& b) {
+    RoaringBitmap result;
+    size_t i = 0, j = 0;
+    while (i < a.containers.size() || j < b.containers.size()) {
+        if (j == b.containers.size() || (i < a.containers.size() && a.containers[i].key < b.containers[j].key)) {
+            result.containers.push_back(a.containers[i++]);
+        } else if (i == a.containers.size() || b.containers[j].key < a.containers[i].key) {
+            result.containers.push_back(b.containers[j++]);
+        } else {
+            Container out;
+            uniteContainers(a.containers[i++], b.containers[j++], out);
+            result.containers.push_back(std::move(out));
+        }
+    }
+    return result;
+}
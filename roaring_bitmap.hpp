@@ -0,0 +1,129 @@
+/**
+ * @file roaring_bitmap.hpp
+ * @brief This file contains the compressed bitmap used to store sets of note IDs.
+ */
+
+#ifndef ROARING_BITMAP_HPP
+#define ROARING_BITMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class RoaringBitmap
+ * @brief A compressed set of 32-bit integers with fast intersection and union.
+ *
+ * Values are split by their high 16 bits into containers. A container holding
+ * at most ARRAY_LIMIT values stores them as a sorted array of low halves (two
+ * bytes per value); a denser one switches to a fixed 8 KB bitmap. Sparse tags
+ * therefore cost a few bytes per note, and popular tags cost one bit per ID,
+ * while AND/OR work container by container on whichever form each side uses.
+ */
+class RoaringBitmap {
+public:
+    /**
+     * @brief The largest container kept as a sorted array.
+     */
+    static const size_t ARRAY_LIMIT = 4096;
+
+    /**
+     * @brief Adds a value.
+     * @param value The value to add.
+     * @return True if the value was not present yet.
+     */
+    bool add(uint32_t value);
+
+    /**
+     * @brief Removes a value.
+     * @param value The value to remove.
+     * @return True if the value was present.
+     */
+    bool remove(uint32_t value);
+
+    /**
+     * @brief Checks whether a value is present.
+     * @param value The value to look for.
+     * @return True if the set contains the value.
+     */
+    bool contains(uint32_t value) const;
+
+    /**
+     * @brief Gets the number of values in the set.
+     * @return The cardinality.
+     */
+    size_t cardinality() const;
+
+    bool empty() const { return containers.empty(); }
+    void clear() { containers.clear(); }
+
+    /**
+     * @brief Gets the values in ascending order.
+     * @return A sorted vector of the values.
+     */
+    std::vector<uint32_t> toVector() const;
+
+    /**
+     * @brief Calls a function for every value, in ascending order.
+     * @param fn A callable taking a uint32_t.
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Container& container : containers) {
+            const uint32_t high = static_cast<uint32_t>(container.key) << 16;
+            if (container.bits.empty()) {
+                for (uint16_t low : container.values) fn(high | low);
+                continue;
+            }
+            for (size_t word = 0; word < container.bits.size(); ++word) {
+                for (uint64_t w = container.bits[word]; w != 0; w &= w - 1) {
+                    fn(high | static_cast<uint32_t>(word * 64 + countTrailingZeros(w)));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Computes the intersection of two sets.
+     * @return A set containing the values present in both a and b.
+     */
+    static RoaringBitmap intersect(const RoaringBitmap& a, const RoaringBitmap& b);
+
+    /**
+     * @brief Computes the union of two sets.
+     * @return A set containing the values present in a or b.
+     */
+    static RoaringBitmap unite(const RoaringBitmap& a, const RoaringBitmap& b);
+
+    /**
+     * @brief Gets the approximate heap memory used by the set.
+     * @return The size in bytes.
+     */
+    size_t memoryUsage() const;
+
+private:
+    /**
+     * @brief The values sharing one high half: a sorted array, or a bitmap when bits is non-empty.
+     */
+    struct Container {
+        uint16_t key = 0;
+        uint32_t count = 0;
+        std::vector<uint16_t> values;
+        std::vector<uint64_t> bits;
+    };
+
+    static const size_t BITMAP_WORDS = 65536 / 64;
+
+    static unsigned countTrailingZeros(uint64_t w);
+    static void toBitmap(Container& container);
+    static void toArray(Container& container);
+    static bool intersectContainers(const Container& a, const Container& b, Container& out);
+    static void uniteContainers(const Container& a, const Container& b, Container& out);
+
+    Container* findContainer(uint16_t key);
+    const Container* findContainer(uint16_t key) const;
+
+    std::vector<Container> containers; // Sorted by key
+};
+
+#endif // ROARING_BITMAP_HPP
@@ -0,0 +1,99 @@
+/**
+ * @file search_cursor.cpp
+ * @brief Implementation of the SearchCursor class.
+ */
+
+#include "search_cursor.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+// Tokens name the last result returned: "id:<note id>" for ID order,
+// "date:<timestamp>:<note id>" for newest-first order.
+const char ID_TOKEN_PREFIX[] = "id:";
+const char DATE_TOKEN_PREFIX[] = "date:";
+
+} // namespace
+
+SearchCursor::SearchCursor(NoteManager& manager, const NoteManager::SearchCriteria& criteria,
+                           const std::string& token)
+    : manager(manager), search(manager.prepareSearch(criteria)), token(token) {
+    NOTES_TIME_OPERATION("search.cursor.open");
+    if (!search.short_circuit) {
+        candidates = manager.searchCandidates(search, nullptr, &candidate_dates);
+    }
+    if (!token.empty() && !skipTo(token)) {
+        error = "Invalid continuation token '" + token + "'.";
+        position = candidates.size();
+    }
+}
+
+std::vector<std::shared_ptr<Note>> SearchCursor::next(size_t count) {
+    NOTES_TIME_OPERATION("search.cursor.next");
+    std::vector<std::shared_ptr<Note>> page;
+    size_t last_position = 0;
+    while (page.size() < count && position < candidates.size()) {
+        const size_t current = position++;
+        auto note = manager.findNoteById(candidates[current]);
+        if (!note) {
+            continue;
+        }
+        // The driving step included, since the note may have changed after the candidates were listed.
+        const auto& steps = search.steps;
+        const bool passes = std::all_of(steps.begin(), steps.end(), [&](const QueryStep& step) {
+            return manager.passesSearchStep(search, step, *note);
+        });
+        if (passes) {
+            page.push_back(std::move(note));
+            last_position = current;
+        }
+    }
+    if (!page.empty()) {
+        // Name the date the note was ordered by, so the token matches the order it was returned in.
+        const std::string last_id = std::to_string(candidates[last_position]);
+        const long long last_date = search.newest_first ? static_cast<long long>(candidate_dates[last_position]) : 0;
+        token = search.newest_first ? DATE_TOKEN_PREFIX + std::to_string(last_date) + ":" + last_id
+                                    : ID_TOKEN_PREFIX + last_id;
+    }
+    return page;
+}
+
+bool SearchCursor::skipTo(const std::string& resume_token) {
+    const std::string prefix = search.newest_first ? DATE_TOKEN_PREFIX : ID_TOKEN_PREFIX;
+    if (resume_token.compare(0, prefix.size(), prefix) != 0) {
+        return false;
+    }
+    std::istringstream in(resume_token.substr(prefix.size()));
+    long long last_time = 0;
+    int last_id = 0;
+    char separator = 0;
+    if (search.newest_first && !(in >> last_time >> separator && separator == ':')) {
+        return false;
+    }
+    if (!(in >> last_id) || in.peek() != std::char_traits<char>::eof()) {
+        return false;
+    }
+
+    // The candidates are sorted, so binary-search past the last result. Newest first, compare the
+    // dates they were sorted by: a live date may have changed since and would break the order.
+    if (search.newest_first) {
+        size_t low = 0;
+        size_t high = candidates.size();
+        while (low < high) {
+            const size_t middle = low + (high - low) / 2;
+            const long long time = static_cast<long long>(candidate_dates[middle]);
+            if (time != last_time ? time > last_time : candidates[middle] >= last_id) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        position = low;
+    } else {
+        position = static_cast<size_t>(std::upper_bound(candidates.begin(), candidates.end(), last_id) -
+                                       candidates.begin());
+    }
+    return true;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file search_cursor.hpp
+ * @brief This file contains the declaration of the SearchCursor class, which returns search results page by page.
+ */
+
+#ifndef SEARCH_CURSOR_HPP
+#define SEARCH_CURSOR_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "notes.hpp"
+
+/**
+ * @class SearchCursor
+ * @brief Runs NoteManager::searchNotes() incrementally, returning the results a page at a time.
+ *
+ * Opening a cursor only plans the search and lists the candidate IDs of its
+ * driving step. The filters, including the text match, run inside next(), on
+ * just enough candidates to fill the page, so the first page of a broad
+ * search is ready long before the whole search would be. Results come in the
+ * same order as searchNotes() returns them.
+ *
+ * After each page, getToken() names the last result returned. A cursor opened
+ * later with the same criteria and that token resumes right after it, even if
+ * notes were added or removed in between, so a page can be fetched without
+ * keeping the cursor (or the manager state it copied) alive. In newest-first
+ * order, a note whose date changes between two pages may be returned twice or
+ * not at all, as it moves across the token.
+ *
+ * The candidate list is fixed when the cursor opens: notes created afterwards
+ * are not returned, deleted ones are skipped, and edited ones are checked
+ * against their current state by every step of the search. The cursor must not outlive its manager.
+ *
+ * @code
+ * SearchCursor cursor(manager, criteria);
+ * auto page = cursor.next(50);
+ * std::string token = cursor.getToken(); // Later: SearchCursor(manager, criteria, token).next(50)
+ * @endcode
+ */
+class SearchCursor {
+public:
+    static constexpr size_t DEFAULT_PAGE_SIZE = 50;
+
+    /**
+     * @brief Plans a search and positions the cursor at its start, or after a continuation token.
+     * @param manager The manager to search; must outlive the cursor.
+     * @param criteria The search criteria.
+     * @param token A token from getToken() of a cursor with the same criteria, or empty to start at the beginning.
+     * If the token cannot be read, the cursor returns nothing and getError() says why.
+     */
+    SearchCursor(NoteManager& manager, const NoteManager::SearchCriteria& criteria, const std::string& token = "");
+
+    /**
+     * @brief Gets the next results.
+     * @param count The maximum number of results.
+     * @return Up to count notes; fewer only when the search is exhausted.
+     */
+    std::vector<std::shared_ptr<Note>> next(size_t count = DEFAULT_PAGE_SIZE);
+
+    /**
+     * @brief Checks if every candidate has been examined, so next() would return nothing.
+     */
+    bool done() const { return position >= candidates.size(); }
+
+    /**
+     * @brief Gets the continuation token for the results after those returned so far.
+     * @return The token; empty if nothing was returned and the cursor was opened without one.
+     */
+    const std::string& getToken() const { return token; }
+
+    /**
+     * @brief Gets the reason the continuation token was rejected.
+     * @return The error message, or an empty string.
+     */
+    const std::string& getError() const { return error; }
+
+private:
+    /**
+     * @brief Moves past every candidate at or before the position a token names.
+     * @return False if the token is malformed or belongs to the other result order.
+     */
+    bool skipTo(const std::string& resume_token);
+
+    NoteManager& manager;
+    NoteManager::PreparedSearch search;
+    std::vector<int> candidates;         // In result order
+    std::vector<time_t> candidate_dates; // Newest first only: the date each candidate was ordered by
+    size_t position = 0;                 // Next candidate to examine
+    std::string token;
+    std::string error;
+};
+
+#endif // SEARCH_CURSOR_HPP
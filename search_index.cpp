@@ -0,0 +1,527 @@
+/**
+ * @file search_index.cpp
+ * @brief Implementation of the InvertedIndex class.
+ */
+
+#include "search_index.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+namespace {
+
+const char INDEX_MAGIC[4] = {'N', 'I', 'D', 'X'};
+const uint32_t INDEX_FORMAT_VERSION = 1;
+
+// Score bounds are computed for average field lengths this much above the current ones.
+const double BOUND_SLACK = 1.05;
+// Covers rounding between a bound and the scores computed under it.
+const double BOUND_MARGIN = 1.0 + 1e-9;
+
+bool isTermChar(unsigned char c) {
+    // Bytes of multi-byte UTF-8 sequences are kept so non-ASCII words stay whole.
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+}
+
+void writeVarint(std::ostream& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+bool readVarint(std::istream& in, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = in.get();
+        if (c == EOF) return false;
+        value |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if ((c & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+std::vector<InvertedIndex::Posting>::const_iterator findPosting(const std::vector<InvertedIndex::Posting>& list,
+                                                                std::vector<InvertedIndex::Posting>::const_iterator from,
+                                                                int note_id) {
+    return std::lower_bound(from, list.end(), note_id,
+                            [](const InvertedIndex::Posting& p, int id) { return p.note_id < id; });
+}
+
+double lengthNorm(uint32_t length, double average_length) {
+    return average_length > 0 ? 1.0 - InvertedIndex::BM25_B + InvertedIndex::BM25_B * length / average_length : 1.0;
+}
+
+double inverseDocumentFrequency(size_t document_count, size_t document_frequency) {
+    const double n = static_cast<double>(document_count);
+    const double df = static_cast<double>(document_frequency);
+    return std::log(1.0 + (n - df + 0.5) / (df + 0.5));
+}
+
+double bm25(double weight, double idf) {
+    return idf * weight * (InvertedIndex::BM25_K1 + 1.0) / (InvertedIndex::BM25_K1 + weight);
+}
+
+} // namespace
+
+std::vector<std::string> InvertedIndex::tokenize(std::string_view text) {
+    return tokenize(std::vector<std::string_view>{text});
+}
+
+std::vector<std::string> InvertedIndex::tokenize(const std::vector<std::string_view>& chunks) {
+    std::vector<std::string> terms;
+    std::string current; // Carried over from one piece to the next
+    for (std::string_view chunk : chunks) {
+        for (unsigned char c : chunk) {
+            if (isTermChar(c)) {
+                current += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : static_cast<char>(c);
+            } else if (!current.empty()) {
+                terms.push_back(std::move(current));
+                current.clear();
+            }
+        }
+    }
+    if (!current.empty()) {
+        terms.push_back(std::move(current));
+    }
+    return terms;
+}
+
+void InvertedIndex::addDocument(int note_id, std::string_view title, std::string_view content) {
+    addDocument(note_id, title, std::vector<std::string_view>{content});
+}
+
+void InvertedIndex::addDocument(int note_id, std::string_view title, const std::vector<std::string_view>& content) {
+    removeDocument(note_id);
+
+    std::vector<std::string> title_terms = tokenize(title);
+    std::vector<std::string> content_terms = tokenize(content);
+
+    DocumentInfo info;
+    info.title_length = static_cast<uint32_t>(title_terms.size());
+    info.length = static_cast<uint32_t>(title_terms.size() + content_terms.size());
+
+    std::map<std::string, std::vector<uint32_t>> positions_by_term;
+    uint32_t position = 0;
+    for (auto& term : title_terms) {
+        positions_by_term[std::move(term)].push_back(position++);
+    }
+    for (auto& term : content_terms) {
+        positions_by_term[std::move(term)].push_back(position++);
+    }
+
+    info.terms.reserve(positions_by_term.size());
+    std::lock_guard<std::mutex> lock(bounds_mutex);
+    for (auto& entry : positions_by_term) {
+        std::vector<Posting>& list = postings_by_term[entry.first];
+        Posting posting{note_id, std::move(entry.second)};
+        auto bound = score_bounds.find(entry.first);
+        if (bound != score_bounds.end()) {
+            bound->second.max_weight =
+                std::max(bound->second.max_weight, termWeight(posting, info, bound->second.avg_title_length,
+                                                              bound->second.avg_content_length));
+        }
+        // IDs are handed out in increasing order, so this is almost always an append.
+        if (list.empty() || list.back().note_id < note_id) {
+            list.push_back(std::move(posting));
+        } else {
+            list.insert(findPosting(list, list.begin(), note_id), std::move(posting));
+        }
+        info.terms.push_back(entry.first);
+    }
+
+    total_length += info.length;
+    total_title_length += info.title_length;
+    documents[note_id] = std::move(info);
+}
+
+bool InvertedIndex::removeDocument(int note_id) {
+    auto doc_it = documents.find(note_id);
+    if (doc_it == documents.end()) {
+        return false;
+    }
+    for (const auto& term : doc_it->second.terms) {
+        auto list_it = postings_by_term.find(term);
+        if (list_it == postings_by_term.end()) continue;
+        std::vector<Posting>& list = list_it->second;
+        auto pos = findPosting(list, list.begin(), note_id);
+        if (pos != list.end() && pos->note_id == note_id) {
+            list.erase(pos);
+        }
+        if (list.empty()) {
+            postings_by_term.erase(list_it);
+            std::lock_guard<std::mutex> lock(bounds_mutex);
+            score_bounds.erase(term);
+        }
+    }
+    total_length -= doc_it->second.length;
+    total_title_length -= doc_it->second.title_length;
+    documents.erase(doc_it);
+    return true;
+}
+
+bool InvertedIndex::containsDocument(int note_id) const {
+    return documents.count(note_id) > 0;
+}
+
+const std::vector<InvertedIndex::Posting>* InvertedIndex::postings(const std::string& term) const {
+    auto it = postings_by_term.find(term);
+    return it == postings_by_term.end() ? nullptr : &it->second;
+}
+
+size_t InvertedIndex::documentFrequency(const std::string& term) const {
+    const std::vector<Posting>* list = postings(term);
+    return list ? list->size() : 0;
+}
+
+std::vector<int> InvertedIndex::findAll(const std::string& query) const {
+    std::vector<std::string> terms = tokenize(query);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    std::vector<const std::vector<Posting>*> lists;
+    for (const auto& term : terms) {
+        const std::vector<Posting>* list = postings(term);
+        if (!list) return {};
+        lists.push_back(list);
+    }
+    if (lists.empty()) return {};
+
+    // Drive the intersection from the rarest term.
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<Posting>* a, const std::vector<Posting>* b) { return a->size() < b->size(); });
+
+    std::vector<int> result;
+    result.reserve(lists.front()->size());
+    for (const auto& posting : *lists.front()) {
+        result.push_back(posting.note_id);
+    }
+    for (size_t i = 1; i < lists.size() && !result.empty(); ++i) {
+        const std::vector<Posting>& list = *lists[i];
+        auto cursor = list.begin();
+        size_t kept = 0;
+        for (int id : result) {
+            cursor = findPosting(list, cursor, id);
+            if (cursor == list.end()) break;
+            if (cursor->note_id == id) {
+                result[kept++] = id;
+            }
+        }
+        result.resize(kept);
+    }
+    return result;
+}
+
+std::vector<int> InvertedIndex::findPhrase(const std::string& phrase) const {
+    std::vector<std::string> terms = tokenize(phrase);
+    std::vector<int> candidates = findAll(phrase);
+    if (terms.size() < 2 || candidates.empty()) {
+        return candidates;
+    }
+
+    std::vector<const std::vector<Posting>*> lists;
+    for (const auto& term : terms) {
+        lists.push_back(postings(term));
+    }
+
+    std::vector<int> result;
+    for (int id : candidates) {
+        std::vector<const std::vector<uint32_t>*> positions;
+        for (const auto* list : lists) {
+            positions.push_back(&findPosting(*list, list->begin(), id)->positions);
+        }
+        for (uint32_t start : *positions.front()) {
+            bool match = true;
+            for (size_t k = 1; k < positions.size() && match; ++k) {
+                match = std::binary_search(positions[k]->begin(), positions[k]->end(), start + static_cast<uint32_t>(k));
+            }
+            if (match) {
+                result.push_back(id);
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<InvertedIndex::ScoredDocument> InvertedIndex::rankTopK(const std::string& query, size_t k,
+                                                                   const std::function<bool(int)>& accept) const {
+    std::vector<ScoredDocument> top;
+    if (k == 0) {
+        return top;
+    }
+    std::vector<std::string> terms = tokenize(query);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    struct Cursor {
+        const std::vector<Posting>* list;
+        std::vector<Posting>::const_iterator at;
+        double idf;
+        double bound; // No posting of the term scores more
+    };
+    std::vector<Cursor> cursors;
+    for (const auto& term : terms) {
+        if (const std::vector<Posting>* list = postings(term)) {
+            const double idf = inverseDocumentFrequency(documents.size(), list->size());
+            cursors.push_back({list, list->begin(), idf, bm25(maxTermWeight(term, *list), idf) * BOUND_MARGIN});
+        }
+    }
+    if (cursors.empty()) {
+        return top;
+    }
+    std::sort(cursors.begin(), cursors.end(), [](const Cursor& a, const Cursor& b) { return a.bound < b.bound; });
+    // prefix_bound[i]: the most terms 0..i can add to a score together.
+    std::vector<double> prefix_bound(cursors.size());
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        prefix_bound[i] = cursors[i].bound + (i > 0 ? prefix_bound[i - 1] : 0.0);
+    }
+
+    const double avg_title_length = averageTitleLength();
+    const double avg_content_length = averageContentLength();
+    auto better = [](const ScoredDocument& a, const ScoredDocument& b) {
+        return a.score != b.score ? a.score > b.score : a.note_id < b.note_id;
+    };
+    top.reserve(std::min(k, documentCount()) + 1);
+    double threshold = 0; // Score of the k-th note once k are held
+    size_t first_essential = 0; // Terms below it cannot reach the threshold on their own
+
+    while (true) {
+        int candidate = INT_MAX;
+        for (size_t i = first_essential; i < cursors.size(); ++i) {
+            if (cursors[i].at != cursors[i].list->end()) {
+                candidate = std::min(candidate, cursors[i].at->note_id);
+            }
+        }
+        if (candidate == INT_MAX) {
+            break;
+        }
+        auto doc = documents.find(candidate);
+        double score = 0;
+        for (size_t i = first_essential; i < cursors.size(); ++i) {
+            Cursor& cursor = cursors[i];
+            if (cursor.at != cursor.list->end() && cursor.at->note_id == candidate) {
+                if (doc != documents.end()) {
+                    score += bm25(termWeight(*cursor.at, doc->second, avg_title_length, avg_content_length), cursor.idf);
+                }
+                ++cursor.at;
+            }
+        }
+        if (doc == documents.end()) {
+            continue;
+        }
+        // Candidates come in ID order, so a later note that only ties the k-th score ranks below it.
+        for (size_t i = first_essential; i-- > 0 && score + prefix_bound[i] > threshold;) {
+            Cursor& cursor = cursors[i];
+            cursor.at = findPosting(*cursor.list, cursor.at, candidate);
+            if (cursor.at != cursor.list->end() && cursor.at->note_id == candidate) {
+                score += bm25(termWeight(*cursor.at, doc->second, avg_title_length, avg_content_length), cursor.idf);
+            }
+        }
+        if ((top.size() == k && score <= threshold) || (accept && !accept(candidate))) {
+            continue;
+        }
+        top.push_back({candidate, score});
+        std::push_heap(top.begin(), top.end(), better);
+        if (top.size() > k) {
+            std::pop_heap(top.begin(), top.end(), better);
+            top.pop_back();
+        }
+        if (top.size() == k) {
+            threshold = top.front().score;
+            while (first_essential < cursors.size() && prefix_bound[first_essential] <= threshold) {
+                ++first_essential;
+            }
+        }
+    }
+    std::sort(top.begin(), top.end(), better);
+    return top;
+}
+
+double InvertedIndex::termWeight(const Posting& posting, const DocumentInfo& info, double avg_title_length,
+                                 double avg_content_length) {
+    // Positions below the title length are title tokens.
+    const auto title_end = std::lower_bound(posting.positions.begin(), posting.positions.end(), info.title_length);
+    const double title_frequency = static_cast<double>(title_end - posting.positions.begin());
+    const double content_frequency = static_cast<double>(posting.positions.end() - title_end);
+    return TITLE_WEIGHT * title_frequency / lengthNorm(info.title_length, avg_title_length) +
+           content_frequency / lengthNorm(info.length - info.title_length, avg_content_length);
+}
+
+double InvertedIndex::maxTermWeight(const std::string& term, const std::vector<Posting>& list) const {
+    const double avg_title_length = averageTitleLength();
+    const double avg_content_length = averageContentLength();
+    std::lock_guard<std::mutex> lock(bounds_mutex);
+    auto it = score_bounds.find(term);
+    if (it != score_bounds.end() && avg_title_length <= it->second.avg_title_length &&
+        avg_content_length <= it->second.avg_content_length) {
+        return it->second.max_weight;
+    }
+    ScoreBound bound;
+    bound.avg_title_length = avg_title_length * BOUND_SLACK;
+    bound.avg_content_length = avg_content_length * BOUND_SLACK;
+    for (const auto& posting : list) {
+        auto doc = documents.find(posting.note_id);
+        if (doc != documents.end()) {
+            bound.max_weight = std::max(bound.max_weight, termWeight(posting, doc->second, bound.avg_title_length,
+                                                                     bound.avg_content_length));
+        }
+    }
+    score_bounds[term] = bound;
+    return bound.max_weight;
+}
+
+double InvertedIndex::averageTitleLength() const {
+    return documents.empty() ? 0.0 : static_cast<double>(total_title_length) / documents.size();
+}
+
+double InvertedIndex::averageContentLength() const {
+    return documents.empty() ? 0.0 : static_cast<double>(total_length - total_title_length) / documents.size();
+}
+
+uint32_t InvertedIndex::titleLength(int note_id) const {
+    auto it = documents.find(note_id);
+    return it == documents.end() ? 0 : it->second.title_length;
+}
+
+uint32_t InvertedIndex::documentLength(int note_id) const {
+    auto it = documents.find(note_id);
+    return it == documents.end() ? 0 : it->second.length;
+}
+
+std::vector<int> InvertedIndex::documentIds() const {
+    std::vector<int> ids;
+    ids.reserve(documents.size());
+    for (const auto& entry : documents) {
+        ids.push_back(entry.first);
+    }
+    return ids;
+}
+
+size_t InvertedIndex::documentCount() const {
+    return documents.size();
+}
+
+uint64_t InvertedIndex::totalLength() const {
+    return total_length;
+}
+
+void InvertedIndex::clear() {
+    postings_by_term.clear();
+    documents.clear();
+    total_length = 0;
+    total_title_length = 0;
+    std::lock_guard<std::mutex> lock(bounds_mutex);
+    score_bounds.clear();
+}
+
+bool InvertedIndex::save(const std::string& file_path) const {
+    std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    writeVarint(out, INDEX_FORMAT_VERSION);
+
+    writeVarint(out, documents.size());
+    for (const auto& entry : documents) {
+        writeVarint(out, static_cast<uint32_t>(entry.first));
+        writeVarint(out, entry.second.title_length);
+        writeVarint(out, entry.second.length);
+    }
+
+    writeVarint(out, postings_by_term.size());
+    for (const auto& entry : postings_by_term) {
+        writeVarint(out, entry.first.size());
+        out.write(entry.first.data(), static_cast<std::streamsize>(entry.first.size()));
+        writeVarint(out, entry.second.size());
+        for (const auto& posting : entry.second) {
+            writeVarint(out, static_cast<uint32_t>(posting.note_id));
+            writeVarint(out, posting.positions.size());
+            uint32_t previous = 0;
+            for (uint32_t position : posting.positions) {
+                writeVarint(out, position - previous); // Positions are ascending
+                previous = position;
+            }
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+bool InvertedIndex::load(const std::string& file_path) {
+    clear();
+    std::ifstream in(file_path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    in.seekg(0, std::ios::end);
+    const uint64_t file_size = static_cast<uint64_t>(in.tellg());
+    in.seekg(0);
+    char magic[sizeof(INDEX_MAGIC)];
+    uint64_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), INDEX_MAGIC) ||
+        !readVarint(in, version) || version != INDEX_FORMAT_VERSION) {
+        return false;
+    }
+
+    auto fail = [this]() {
+        clear();
+        return false;
+    };
+    // Sizes read from the file are checked against the bytes left before anything is allocated
+    // for them, so a corrupt index fails to load instead of throwing.
+    auto remaining = [&]() { return file_size - static_cast<uint64_t>(in.tellg()); };
+
+    uint64_t doc_count = 0;
+    if (!readVarint(in, doc_count)) return fail();
+    for (uint64_t i = 0; i < doc_count; ++i) {
+        uint64_t id = 0, title_length = 0, length = 0;
+        if (!readVarint(in, id) || !readVarint(in, title_length) || !readVarint(in, length)) return fail();
+        DocumentInfo& info = documents[static_cast<int>(id)];
+        info.title_length = static_cast<uint32_t>(title_length);
+        info.length = static_cast<uint32_t>(length);
+        total_length += length;
+        total_title_length += title_length;
+    }
+
+    uint64_t term_count = 0;
+    if (!readVarint(in, term_count)) return fail();
+    for (uint64_t t = 0; t < term_count; ++t) {
+        uint64_t term_size = 0, list_size = 0;
+        if (!readVarint(in, term_size) || term_size > remaining()) return fail();
+        std::string term(term_size, '\0');
+        if (!in.read(&term[0], static_cast<std::streamsize>(term_size)) || !readVarint(in, list_size)) return fail();
+        // Each posting takes at least two bytes: the note ID and the position count.
+        if (list_size > remaining() / 2) return fail();
+
+        std::vector<Posting>& list = postings_by_term[term];
+        list.reserve(list_size);
+        for (uint64_t p = 0; p < list_size; ++p) {
+            uint64_t id = 0, position_count = 0;
+            if (!readVarint(in, id) || !readVarint(in, position_count) || position_count > remaining()) {
+                return fail();
+            }
+            auto doc_it = documents.find(static_cast<int>(id));
+            if (doc_it == documents.end()) return fail();
+
+            Posting posting{static_cast<int>(id), {}};
+            posting.positions.reserve(position_count);
+            uint64_t position = 0;
+            for (uint64_t k = 0; k < position_count; ++k) {
+                uint64_t delta = 0;
+                if (!readVarint(in, delta)) return fail();
+                position += delta;
+                posting.positions.push_back(static_cast<uint32_t>(position));
+            }
+            list.push_back(std::move(posting));
+            doc_it->second.terms.push_back(term);
+        }
+        std::sort(list.begin(), list.end(), [](const Posting& a, const Posting& b) { return a.note_id < b.note_id; });
+    }
+    return true;
+}
@@ -0,0 +1,240 @@
+/**
+ * @file search_index.hpp
+ * @brief This file contains the declaration of the inverted full-text index used by keyword search.
+ */
+
+#ifndef SEARCH_INDEX_HPP
+#define SEARCH_INDEX_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+/**
+ * @class InvertedIndex
+ * @brief An incrementally maintained term -> posting list index over note titles and content.
+ *
+ * Every note is tokenized into lowercase alphanumeric terms. The title tokens
+ * come first, followed by the content tokens, so a token position below the
+ * note's title length belongs to the title. Posting lists are kept sorted by
+ * note ID, which lets multi-term queries intersect them starting from the
+ * rarest term; the cost of a query is therefore bounded by the shortest
+ * posting list rather than by the number of notes.
+ *
+ * rankTopK() orders matches by BM25F relevance, with the title and the content
+ * scored as separate fields and title matches boosted.
+ */
+class InvertedIndex {
+public:
+    /**
+     * @struct Posting
+     * @brief The occurrences of one term inside one note.
+     */
+    struct Posting {
+        int note_id;
+        std::vector<uint32_t> positions;
+    };
+
+    /**
+     * @struct ScoredDocument
+     * @brief A note returned by rankTopK(), with its relevance score.
+     */
+    struct ScoredDocument {
+        int note_id;
+        double score;
+    };
+
+    static constexpr double BM25_K1 = 1.2;       ///< Term frequency saturation.
+    static constexpr double BM25_B = 0.75;       ///< Strength of the length normalization of each field.
+    static constexpr double TITLE_WEIGHT = 3.0;  ///< A title occurrence counts as this many content occurrences.
+
+    /**
+     * @brief Splits text into lowercase alphanumeric terms.
+     * @param text The text to tokenize.
+     * @return The terms in the order they appear in the text.
+     */
+    static std::vector<std::string> tokenize(std::string_view text);
+
+    /**
+     * @brief Splits text held in consecutive pieces into terms, exactly as tokenize() splits the joined text.
+     * @param chunks The pieces of the text, in order. A term may continue from one piece into the next.
+     * @return The terms in the order they appear in the text.
+     */
+    static std::vector<std::string> tokenize(const std::vector<std::string_view>& chunks);
+
+    /**
+     * @brief Adds a note to the index, replacing any previous entry for the same ID.
+     * @param note_id The ID of the note.
+     * @param title The title of the note.
+     * @param content The content of the note.
+     */
+    void addDocument(int note_id, std::string_view title, std::string_view content);
+
+    /**
+     * @brief Adds a note whose content is held in pieces (see Note::forEachContentChunk), without joining them.
+     * @param note_id The ID of the note.
+     * @param title The title of the note.
+     * @param content The pieces of the content, in order.
+     */
+    void addDocument(int note_id, std::string_view title, const std::vector<std::string_view>& content);
+
+    /**
+     * @brief Removes a note from the index.
+     * @param note_id The ID of the note to remove.
+     * @return True if the note was indexed, false otherwise.
+     */
+    bool removeDocument(int note_id);
+
+    /**
+     * @brief Checks whether a note is present in the index.
+     * @param note_id The ID of the note.
+     * @return True if the note is indexed, false otherwise.
+     */
+    bool containsDocument(int note_id) const;
+
+    /**
+     * @brief Gets the posting list of a term.
+     * @param term The term to look up (must already be normalized by tokenize()).
+     * @return A pointer to the posting list sorted by note ID, or nullptr if the term is unknown.
+     */
+    const std::vector<Posting>* postings(const std::string& term) const;
+
+    /**
+     * @brief Gets the number of notes containing a term.
+     * @param term The normalized term.
+     * @return The document frequency of the term.
+     */
+    size_t documentFrequency(const std::string& term) const;
+
+    /**
+     * @brief Finds the notes that contain every term of a query.
+     * @param query The free-text query; it is tokenized like indexed text.
+     * @return The sorted IDs of the matching notes. An empty query matches nothing.
+     */
+    std::vector<int> findAll(const std::string& query) const;
+
+    /**
+     * @brief Finds the notes in which the query terms appear consecutively.
+     * @param phrase The phrase to look for.
+     * @return The sorted IDs of the matching notes.
+     */
+    std::vector<int> findPhrase(const std::string& phrase) const;
+
+    /**
+     * @brief Finds the k notes that best match a query, by BM25F score.
+     * A note matches if it contains any query term. Terms are visited in
+     * MaxScore fashion: once k notes are held, the terms whose combined score
+     * bound cannot lift a note past the k-th score no longer produce
+     * candidates and are only probed for notes the other terms found, so most
+     * postings of common terms are skipped.
+     * @param query The free-text query; it is tokenized like indexed text.
+     * @param k The maximum number of results.
+     * @param accept If set, only notes for which it returns true are ranked.
+     * @return Up to k notes, best first; equal scores are ordered by note ID.
+     */
+    std::vector<ScoredDocument> rankTopK(const std::string& query, size_t k,
+                                         const std::function<bool(int)>& accept = nullptr) const;
+
+    /**
+     * @brief Gets the number of tokens in a note's title.
+     * @param note_id The ID of the note.
+     * @return The title length in tokens, or 0 if the note is not indexed.
+     */
+    uint32_t titleLength(int note_id) const;
+
+    /**
+     * @brief Gets the total number of tokens (title and content) in a note.
+     * @param note_id The ID of the note.
+     * @return The document length in tokens, or 0 if the note is not indexed.
+     */
+    uint32_t documentLength(int note_id) const;
+
+    /**
+     * @brief Gets the IDs of every indexed note.
+     * @return The note IDs, in no particular order.
+     */
+    std::vector<int> documentIds() const;
+
+    /**
+     * @brief Gets the number of indexed notes.
+     * @return The number of documents.
+     */
+    size_t documentCount() const;
+
+    /**
+     * @brief Gets the total number of tokens over all indexed notes.
+     * @return The summed document lengths.
+     */
+    uint64_t totalLength() const;
+
+    /**
+     * @brief Removes every entry from the index.
+     */
+    void clear();
+
+    /**
+     * @brief Writes the index to a binary file.
+     * @param file_path The destination path.
+     * @return True if the index was written successfully, false otherwise.
+     */
+    bool save(const std::string& file_path) const;
+
+    /**
+     * @brief Replaces the index with the contents of a file written by save().
+     * @param file_path The path of the index file.
+     * @return True if the file was read and validated, false otherwise (the index is left empty).
+     */
+    bool load(const std::string& file_path);
+
+private:
+    /**
+     * @struct DocumentInfo
+     * @brief Per-note bookkeeping needed to unindex a note and to normalize scores.
+     */
+    struct DocumentInfo {
+        uint32_t title_length = 0;
+        uint32_t length = 0;
+        std::vector<std::string> terms; // Distinct terms, for removal
+    };
+
+    /**
+     * @struct ScoreBound
+     * @brief The largest field-weighted term frequency in a posting list, for rankTopK().
+     * The weight of a posting only grows with the average field lengths, so the
+     * bound is computed for averages a little above the current ones and stays
+     * valid until an average exceeds them. addDocument() raises it for new
+     * postings; removals leave it loose but valid.
+     */
+    struct ScoreBound {
+        double avg_title_length = 0;
+        double avg_content_length = 0;
+        double max_weight = 0;
+    };
+
+    /**
+     * @brief Gets the field-weighted term frequency of a posting.
+     */
+    static double termWeight(const Posting& posting, const DocumentInfo& info, double avg_title_length,
+                             double avg_content_length);
+
+    /**
+     * @brief Gets a bound on the weight of any posting of a term, refreshing it if the averages outgrew it.
+     */
+    double maxTermWeight(const std::string& term, const std::vector<Posting>& list) const;
+
+    double averageTitleLength() const;
+    double averageContentLength() const;
+
+    std::unordered_map<std::string, std::vector<Posting>> postings_by_term;
+    std::unordered_map<int, DocumentInfo> documents;
+    uint64_t total_length = 0;
+    uint64_t total_title_length = 0;
+    mutable std::mutex bounds_mutex; // rankTopK() is const but fills score_bounds
+    mutable std::unordered_map<std::string, ScoreBound> score_bounds;
+};
+
+#endif // SEARCH_INDEX_HPP
@@ -0,0 +1,200 @@
+/**
+ * @file small_vector.hpp
+ * @brief A vector that keeps its first few elements inside the object, for the short lists held by every note.
+ */
+
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @class SmallVector
+ * @brief A sequence container with room for N elements inline; it moves to the heap only past N.
+ *
+ * Most notes carry a handful of tags and at most one reminder, so an inline
+ * buffer saves a heap allocation per list and keeps the elements next to the
+ * note during scans. The interface is the subset of std::vector the notes code
+ * uses, and pointers are the iterators. Like std::vector, any insertion or
+ * erasure invalidates iterators; moving an inline SmallVector moves its
+ * elements one by one.
+ */
+template <typename T, size_t N>
+class SmallVector {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    SmallVector(std::initializer_list<T> values) {
+        reserve(values.size());
+        for (const T& value : values) push_back(value);
+    }
+
+    SmallVector(const SmallVector& other) {
+        reserve(other.size());
+        std::uninitialized_copy(other.begin(), other.end(), elements);
+        count = other.count;
+    }
+
+    SmallVector(SmallVector&& other) noexcept {
+        moveFrom(other);
+    }
+
+    ~SmallVector() {
+        clear();
+        releaseHeap();
+    }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size());
+            std::uninitialized_copy(other.begin(), other.end(), elements);
+            count = other.count;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            clear();
+            releaseHeap();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Copies the elements into a std::vector, for the by-value getters that return one.
+     */
+    operator std::vector<T>() const { return std::vector<T>(begin(), end()); }
+
+    // --- Access ---
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return slots; }
+    /// True while the elements are in the inline buffer.
+    bool isInline() const { return elements == inlineBuffer(); }
+
+    T* data() { return elements; }
+    const T* data() const { return elements; }
+    T* begin() { return elements; }
+    T* end() { return elements + count; }
+    const T* begin() const { return elements; }
+    const T* end() const { return elements + count; }
+    T& operator[](size_t index) { return elements[index]; }
+    const T& operator[](size_t index) const { return elements[index]; }
+    T& front() { return elements[0]; }
+    const T& front() const { return elements[0]; }
+    T& back() { return elements[count - 1]; }
+    const T& back() const { return elements[count - 1]; }
+
+    // --- Modification ---
+
+    void reserve(size_t wanted) {
+        if (wanted <= slots) {
+            return;
+        }
+        T* grown = static_cast<T*>(::operator new(wanted * sizeof(T)));
+        std::uninitialized_move(elements, elements + count, grown);
+        std::destroy(elements, elements + count);
+        releaseHeap();
+        elements = grown;
+        slots = wanted;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (count == slots) {
+            // Build the element first: args may refer to an element that reserve() is about to move.
+            T value(std::forward<Args>(args)...);
+            reserve(slots * 2);
+            ::new (static_cast<void*>(elements + count)) T(std::move(value));
+        } else {
+            ::new (static_cast<void*>(elements + count)) T(std::forward<Args>(args)...);
+        }
+        return elements[count++];
+    }
+
+    void pop_back() {
+        elements[--count].~T();
+    }
+
+    T* erase(const T* position) {
+        return erase(position, position + 1);
+    }
+
+    T* erase(const T* first, const T* last) {
+        T* begin_erased = elements + (first - elements);
+        T* end_erased = elements + (last - elements);
+        T* new_end = std::move(end_erased, end(), begin_erased);
+        std::destroy(new_end, end());
+        count = static_cast<size_t>(new_end - elements);
+        return begin_erased;
+    }
+
+    void clear() {
+        std::destroy(elements, elements + count);
+        count = 0;
+    }
+
+    friend bool operator==(const SmallVector& a, const SmallVector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+    friend bool operator!=(const SmallVector& a, const SmallVector& b) { return !(a == b); }
+
+private:
+    T* inlineBuffer() { return reinterpret_cast<T*>(storage); }
+    const T* inlineBuffer() const { return reinterpret_cast<const T*>(storage); }
+
+    void releaseHeap() {
+        if (!isInline()) {
+            ::operator delete(elements);
+            elements = inlineBuffer();
+            slots = N;
+        }
+    }
+
+    /**
+     * @brief Takes other's elements, stealing its heap buffer if it has one. Expects this to be empty and inline.
+     */
+    void moveFrom(SmallVector& other) {
+        if (!other.isInline()) {
+            elements = other.elements;
+            slots = other.slots;
+            count = other.count;
+            other.elements = other.inlineBuffer();
+            other.slots = N;
+            other.count = 0;
+            return;
+        }
+        std::uninitialized_move(other.begin(), other.end(), elements);
+        count = other.count;
+        other.clear();
+    }
+
+    static_assert(N > 0, "SmallVector needs room for at least one inline element");
+
+    alignas(T) unsigned char storage[N * sizeof(T)];
+    T* elements = inlineBuffer();
+    size_t count = 0;
+    size_t slots = N;
+};
+
+#endif // SMALL_VECTOR_HPP
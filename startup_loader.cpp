@@ -0,0 +1,213 @@
+/**
+ * @file startup_loader.cpp
+ * @brief Implementation of the ParallelDirectoryWalker class.
+ */
+
+#include "startup_loader.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const size_t MAX_HEADER_LINES = 32;
+
+std::string trimCopy(const std::string& str) {
+    const char* whitespace = " \t\r\n";
+    size_t first = str.find_first_not_of(whitespace);
+    if (first == std::string::npos) return "";
+    size_t last = str.find_last_not_of(whitespace);
+    return str.substr(first, last - first + 1);
+}
+
+time_t parseDate(const std::string& value) {
+    if (!value.empty() && std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return static_cast<time_t>(std::stoll(value));
+    }
+    std::tm tm = {};
+    std::istringstream in(value);
+    in >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+    if (in.fail()) return 0;
+    tm.tm_isdst = -1;
+    return std::mktime(&tm);
+}
+
+bool isNoteFile(const fs::path& path, int& id) {
+    const std::string stem = path.stem().string();
+    if (path.extension() != ".txt" || stem.empty() || stem.size() > 9 ||
+        !std::all_of(stem.begin(), stem.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return false;
+    }
+    id = std::stoi(stem);
+    return true;
+}
+
+} // namespace
+
+ParallelDirectoryWalker::ParallelDirectoryWalker(unsigned thread_count)
+    : threads(thread_count ? thread_count : std::max(1u, std::thread::hardware_concurrency())) {}
+
+std::vector<ScannedFolder> ParallelDirectoryWalker::scan(const std::string& root) const {
+    TRACE_SCOPE("startup.scan");
+    std::error_code ec;
+    if (!fs::is_directory(root, ec)) {
+        return {};
+    }
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::deque<std::pair<fs::path, size_t>> queue{{fs::path(root), 0}};
+    size_t active = 0;
+    std::vector<ScannedFolder> results;
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            work_available.wait(lock, [&] { return !queue.empty() || active == 0; });
+            if (queue.empty()) {
+                return; // No queued work and nobody left to produce more
+            }
+            auto [dir, depth] = std::move(queue.front());
+            queue.pop_front();
+            ++active;
+            lock.unlock();
+
+            ScannedFolder folder;
+            TRACE_SCOPE("startup.scan_directory");
+            std::error_code path_ec;
+            folder.relative_path = depth == 0 ? "" : fs::relative(dir, root, path_ec).generic_string();
+            folder.name = depth == 0 ? "" : dir.filename().string();
+            folder.depth = depth;
+            std::vector<fs::path> subdirectories;
+            std::error_code dir_ec;
+            for (fs::directory_iterator it(dir, dir_ec), end; !dir_ec && it != end; it.increment(dir_ec)) {
+                std::error_code entry_ec;
+                int id = 0;
+                if (it->is_directory(entry_ec)) {
+                    subdirectories.push_back(it->path());
+                } else if (isNoteFile(it->path(), id)) {
+                    NoteHeader header;
+                    if (readHeader(it->path().string(), header)) {
+                        folder.notes.push_back(std::move(header));
+                    }
+                }
+            }
+            std::sort(folder.notes.begin(), folder.notes.end(),
+                      [](const NoteHeader& a, const NoteHeader& b) { return a.id < b.id; });
+
+            lock.lock();
+            for (auto& subdirectory : subdirectories) {
+                queue.emplace_back(std::move(subdirectory), depth + 1);
+            }
+            results.push_back(std::move(folder));
+            --active;
+            work_available.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i) {
+        pool.emplace_back([&worker] {
+            TRACE_THREAD_NAME("loader");
+            worker();
+        });
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    std::sort(results.begin(), results.end(), [](const ScannedFolder& a, const ScannedFolder& b) {
+        return a.depth != b.depth ? a.depth < b.depth : a.relative_path < b.relative_path;
+    });
+    return results;
+}
+
+bool ParallelDirectoryWalker::readHeader(const std::string& file_path, NoteHeader& header) {
+    TRACE_SCOPE("startup.read_header");
+    int id = 0;
+    if (!isNoteFile(file_path, id)) {
+        return false;
+    }
+    std::ifstream in(file_path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    header = NoteHeader();
+    header.id = id;
+    header.file_path = file_path;
+    header.title = fs::path(file_path).stem().string();
+
+    std::error_code ec;
+    auto write_time = fs::last_write_time(file_path, ec);
+    if (!ec) {
+        auto system_time = std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+            write_time - fs::file_time_type::clock::now() + std::chrono::system_clock::now());
+        header.last_modified_date = std::chrono::system_clock::to_time_t(system_time);
+        header.creation_date = header.last_modified_date;
+    }
+
+    std::string line;
+    size_t count = 0;
+    bool header_block = true;
+    for (; count < MAX_HEADER_LINES && std::getline(in, line); ++count) {
+        std::string trimmed = trimCopy(line);
+        if (trimmed.empty()) {
+            if (count > 0) {
+                header.body_offset = static_cast<uint64_t>(in.tellg());
+            }
+            return true;
+        }
+        size_t colon = trimmed.find(':');
+        std::string key = colon == std::string::npos ? "" : trimmed.substr(0, colon);
+        std::string value = colon == std::string::npos ? "" : trimCopy(trimmed.substr(colon + 1));
+        if (key == "Title") {
+            header.title = value;
+        } else if (key == "Created") {
+            header.creation_date = parseDate(value);
+        } else if (key == "Modified") {
+            header.last_modified_date = parseDate(value);
+        } else if (key == "Tags") {
+            std::stringstream tags(value);
+            std::string tag;
+            while (std::getline(tags, tag, ',')) {
+                if (!trimCopy(tag).empty()) header.tags.push_back(trimCopy(tag));
+            }
+        } else if (key != "ID") {
+            header_block = false;
+            break;
+        }
+    }
+    if (header_block && count > 0 && in.eof()) {
+        header.body_offset = fs::file_size(file_path, ec); // Header only, empty body
+        return true;
+    }
+    // Not a header block: the whole file is the body.
+    header.title = fs::path(file_path).stem().string();
+    header.tags.clear();
+    header.body_offset = 0;
+    return true;
+}
+
+std::string ParallelDirectoryWalker::readBody(const std::string& file_path, uint64_t body_offset) {
+    TRACE_SCOPE("storage.read_body");
+    std::ifstream in(file_path, std::ios::binary);
+    if (!in || !in.seekg(static_cast<std::streamoff>(body_offset))) {
+        return "";
+    }
+    std::string body(std::istreambuf_iterator<char>(in), (std::istreambuf_iterator<char>()));
+    NOTES_COUNT("storage.bytes_read", body.size());
+    return body;
+}
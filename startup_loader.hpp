@@ -0,0 +1,96 @@
+/**
+ * @file startup_loader.hpp
+ * @brief This file contains the parallel directory walker used for fast, lazy startup.
+ */
+
+#ifndef STARTUP_LOADER_HPP
+#define STARTUP_LOADER_HPP
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+/**
+ * @struct NoteHeader
+ * @brief The metadata of a note file, read without loading the note body.
+ */
+struct NoteHeader {
+    int id = 0;
+    std::string title;
+    time_t creation_date = 0;
+    time_t last_modified_date = 0;
+    std::vector<std::string> tags;
+    std::string file_path;    // Where the body lives
+    uint64_t body_offset = 0; // Byte offset of the body inside the file
+};
+
+/**
+ * @struct ScannedFolder
+ * @brief A directory found by the walker, with the note headers it contains.
+ */
+struct ScannedFolder {
+    std::string relative_path; // Relative to the scanned root; empty for the root itself
+    std::string name;
+    size_t depth = 0;
+    std::vector<NoteHeader> notes;
+};
+
+/**
+ * @struct StartupReport
+ * @brief Timings of the last initializeFromFileSystem call.
+ */
+struct StartupReport {
+    double metadata_ms = 0.0; // Directory walk and header parsing
+    double total_ms = 0.0;    // Including building the folder tree and indexes
+    size_t note_count = 0;
+    size_t folder_count = 0;
+    bool lazy = false;
+};
+
+/**
+ * @class ParallelDirectoryWalker
+ * @brief Walks a note directory tree on several threads, reading only note headers.
+ *
+ * Directories are distributed through a shared work queue: each worker lists
+ * one directory, queues its subdirectories and parses the header block of
+ * every "<id>.txt" file it contains. A header block is a run of "Key: value"
+ * lines (Title, Created, Modified, Tags) terminated by an empty line; the body
+ * starts right after it. Files without such a block are treated as body-only.
+ */
+class ParallelDirectoryWalker {
+public:
+    /**
+     * @brief Constructs a walker.
+     * @param thread_count The number of worker threads; 0 uses the hardware concurrency.
+     */
+    explicit ParallelDirectoryWalker(unsigned thread_count = 0);
+
+    /**
+     * @brief Scans a directory tree.
+     * @param root The directory to scan. A missing directory yields an empty result.
+     * @return Every directory found, sorted so that parents precede their children.
+     */
+    std::vector<ScannedFolder> scan(const std::string& root) const;
+
+    /**
+     * @brief Parses the header block of a single note file.
+     * @param file_path The path of the note file.
+     * @param header Receives the parsed metadata.
+     * @return True if the file name is a valid note ID and the file could be read.
+     */
+    static bool readHeader(const std::string& file_path, NoteHeader& header);
+
+    /**
+     * @brief Reads the body of a note file, skipping its header block.
+     * @param file_path The path of the note file.
+     * @param body_offset The offset reported by readHeader().
+     * @return The note body, or an empty string if the file cannot be read.
+     */
+    static std::string readBody(const std::string& file_path, uint64_t body_offset);
+
+private:
+    unsigned threads;
+};
+
+#endif // STARTUP_LOADER_HPP
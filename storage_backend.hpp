@@ -0,0 +1,128 @@
+/**
+ * @file storage_backend.hpp
+ * @brief This file contains the interface implemented by note storage engines.
+ */
+
+#ifndef STORAGE_BACKEND_HPP
+#define STORAGE_BACKEND_HPP
+
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @struct StoredNote
+ * @brief The persisted form of a note, independent of the in-memory object graph.
+ */
+struct StoredNote {
+    int id = 0;
+    int folder_id = 0;
+    std::string title;
+    std::string content;
+    std::vector<std::string> tags;
+    time_t creation_date = 0;
+    time_t last_modified_date = 0;
+    bool in_trash = false;
+};
+
+/**
+ * @struct StoredFolder
+ * @brief The persisted form of a folder. A parent ID of 0 means the root folder.
+ */
+struct StoredFolder {
+    int id = 0;
+    int parent_id = 0;
+    std::string name;
+    bool in_trash = false;
+};
+
+/**
+ * @class StorageBackend
+ * @brief Abstract persistence engine used by NoteManager.
+ *
+ * A backend receives individual mutations as they happen and can replay the
+ * resulting state when the application starts. Implementations decide how the
+ * mutations are laid out on disk.
+ */
+class StorageBackend {
+public:
+    virtual ~StorageBackend() = default;
+
+    /**
+     * @brief Opens the underlying storage, recovering from any interrupted write.
+     * @return True if the storage is ready for use, false otherwise.
+     */
+    virtual bool open() = 0;
+
+    /**
+     * @brief Streams the persisted state to the caller.
+     * Every folder is reported before any note.
+     * @param on_folder Called once for each live folder.
+     * @param on_note Called once for each live note.
+     * @return True if the whole state was replayed, false otherwise.
+     */
+    virtual bool replay(const std::function<void(const StoredFolder&)>& on_folder,
+                        const std::function<void(StoredNote&&)>& on_note) = 0;
+
+    /**
+     * @brief Creates or replaces a note.
+     * @param note The full note state.
+     * @return True if the mutation was recorded, false otherwise.
+     */
+    virtual bool putNote(const StoredNote& note) = 0;
+
+    /**
+     * @brief Permanently removes a note.
+     * @param note_id The ID of the note.
+     * @return True if the mutation was recorded, false otherwise.
+     */
+    virtual bool removeNote(int note_id) = 0;
+
+    /**
+     * @brief Moves a note to another folder (including in and out of the trash).
+     * @param note_id The ID of the note.
+     * @param folder_id The ID of the destination folder.
+     * @param in_trash The trash status of the note after the move.
+     * @return True if the mutation was recorded, false otherwise.
+     */
+    virtual bool moveNote(int note_id, int folder_id, bool in_trash) = 0;
+
+    /**
+     * @brief Adds a tag to a note.
+     * @param note_id The ID of the note.
+     * @param tag_name The name of the tag.
+     * @return True if the mutation was recorded, false otherwise.
+     */
+    virtual bool addTag(int note_id, const std::string& tag_name) = 0;
+
+    /**
+     * @brief Removes a tag from a note.
+     * @param note_id The ID of the note.
+     * @param tag_name The name of the tag.
+     * @return True if the mutation was recorded, false otherwise.
+     */
+    virtual bool removeTag(int note_id, const std::string& tag_name) = 0;
+
+    /**
+     * @brief Creates or replaces a folder.
+     * @param folder The full folder state.
+     * @return True if the mutation was recorded, false otherwise.
+     */
+    virtual bool putFolder(const StoredFolder& folder) = 0;
+
+    /**
+     * @brief Permanently removes a folder.
+     * @param folder_id The ID of the folder.
+     * @return True if the mutation was recorded, false otherwise.
+     */
+    virtual bool removeFolder(int folder_id) = 0;
+
+    /**
+     * @brief Makes every recorded mutation durable.
+     * @return True if the data reached stable storage, false otherwise.
+     */
+    virtual bool sync() = 0;
+};
+
+#endif // STORAGE_BACKEND_HPP
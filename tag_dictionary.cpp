@@ -0,0 +1,130 @@
+/**
+ * @file tag_dictionary.cpp
+ * @brief Implementation of the TagDictionary class.
+ */
+
+#include "tag_dictionary.hpp"
+
+#include <algorithm>
+
+uint32_t TagDictionary::intern(const std::string& name) {
+    auto it = ids_by_name.find(name);
+    if (it != ids_by_name.end()) {
+        return it->second;
+    }
+    const uint32_t tag_id = static_cast<uint32_t>(names.size());
+    ids_by_name.emplace(name, tag_id);
+    names.push_back(name);
+    notes_by_tag.emplace_back();
+    return tag_id;
+}
+
+uint32_t TagDictionary::find(const std::string& name) const {
+    auto it = ids_by_name.find(name);
+    return it != ids_by_name.end() ? it->second : NO_TAG;
+}
+
+bool TagDictionary::tagNote(int note_id, const std::string& name) {
+    const uint32_t tag_id = intern(name);
+    if (!notes_by_tag[tag_id].add(static_cast<uint32_t>(note_id))) {
+        return false;
+    }
+    tags_by_note[note_id].push_back(tag_id);
+    return true;
+}
+
+bool TagDictionary::untagNote(int note_id, const std::string& name) {
+    const uint32_t tag_id = find(name);
+    if (tag_id == NO_TAG || !notes_by_tag[tag_id].remove(static_cast<uint32_t>(note_id))) {
+        return false;
+    }
+    auto it = tags_by_note.find(note_id);
+    if (it != tags_by_note.end()) {
+        auto& tag_ids = it->second;
+        tag_ids.erase(std::remove(tag_ids.begin(), tag_ids.end(), tag_id), tag_ids.end());
+        if (tag_ids.empty()) {
+            tags_by_note.erase(note_id);
+        }
+    }
+    return true;
+}
+
+void TagDictionary::setNoteTags(int note_id, const std::vector<std::string>& tag_names) {
+    removeNote(note_id);
+    for (const auto& tag_name : tag_names) {
+        tagNote(note_id, tag_name);
+    }
+}
+
+void TagDictionary::removeNote(int note_id) {
+    auto it = tags_by_note.find(note_id);
+    if (it == tags_by_note.end()) {
+        return;
+    }
+    for (uint32_t tag_id : it->second) {
+        notes_by_tag[tag_id].remove(static_cast<uint32_t>(note_id));
+    }
+    tags_by_note.erase(it);
+}
+
+std::vector<uint32_t> TagDictionary::clearTag(const std::string& name) {
+    const uint32_t tag_id = find(name);
+    if (tag_id == NO_TAG) {
+        return {};
+    }
+    std::vector<uint32_t> note_ids = notes_by_tag[tag_id].toVector();
+    for (uint32_t note_id : note_ids) {
+        untagNote(static_cast<int>(note_id), name);
+    }
+    return note_ids;
+}
+
+bool TagDictionary::hasTag(int note_id, const std::string& name) const {
+    const uint32_t tag_id = find(name);
+    return tag_id != NO_TAG && notes_by_tag[tag_id].contains(static_cast<uint32_t>(note_id));
+}
+
+const RoaringBitmap* TagDictionary::notesWith(const std::string& name) const {
+    const uint32_t tag_id = find(name);
+    return tag_id != NO_TAG ? &notes_by_tag[tag_id] : nullptr;
+}
+
+RoaringBitmap TagDictionary::notesWithAll(const std::vector<std::string>& tag_names) const {
+    std::vector<const RoaringBitmap*> bitmaps;
+    for (const auto& tag_name : tag_names) {
+        const RoaringBitmap* bitmap = notesWith(tag_name);
+        if (!bitmap || bitmap->empty()) {
+            return RoaringBitmap();
+        }
+        bitmaps.push_back(bitmap);
+    }
+    if (bitmaps.empty()) {
+        return RoaringBitmap();
+    }
+    // Start from the rarest tag so the running intersection stays small.
+    std::sort(bitmaps.begin(), bitmaps.end(), [](const RoaringBitmap* a, const RoaringBitmap* b) {
+        return a->cardinality() < b->cardinality();
+    });
+    RoaringBitmap result = *bitmaps.front();
+    for (size_t i = 1; i < bitmaps.size() && !result.empty(); ++i) {
+        result = RoaringBitmap::intersect(result, *bitmaps[i]);
+    }
+    return result;
+}
+
+RoaringBitmap TagDictionary::notesWithAny(const std::vector<std::string>& tag_names) const {
+    RoaringBitmap result;
+    for (const auto& tag_name : tag_names) {
+        if (const RoaringBitmap* bitmap = notesWith(tag_name)) {
+            result = RoaringBitmap::unite(result, *bitmap);
+        }
+    }
+    return result;
+}
+
+void TagDictionary::clear() {
+    ids_by_name.clear();
+    names.clear();
+    notes_by_tag.clear();
+    tags_by_note.clear();
+}
@@ -0,0 +1,137 @@
+/**
+ * @file tag_dictionary.hpp
+ * @brief This file contains the tag dictionary that maps tag names to the notes carrying them.
+ */
+
+#ifndef TAG_DICTIONARY_HPP
+#define TAG_DICTIONARY_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "roaring_bitmap.hpp"
+#include "id_index.hpp"
+
+/**
+ * @class TagDictionary
+ * @brief Interns tag names into compact integer IDs and keeps a bitmap of note IDs per tag.
+ *
+ * Every tag name is stored once and referred to by a dense ID, which indexes
+ * the per-tag RoaringBitmap of notes. Tag queries become bitmap operations:
+ * "all of these tags" is an intersection, "any of these tags" a union, and
+ * both return note IDs in ascending order. A reverse map from note ID to tag
+ * IDs lets a note's tags be replaced or dropped without scanning every tag.
+ */
+class TagDictionary {
+public:
+    /**
+     * @brief The ID returned for names that have never been interned.
+     */
+    static const uint32_t NO_TAG = UINT32_MAX;
+
+    /**
+     * @brief Gets the ID of a tag name, adding the name if it is new.
+     * @param name The tag name.
+     * @return The tag ID.
+     */
+    uint32_t intern(const std::string& name);
+
+    /**
+     * @brief Gets the ID of a tag name without adding it.
+     * @param name The tag name.
+     * @return The tag ID, or NO_TAG if the name is unknown.
+     */
+    uint32_t find(const std::string& name) const;
+
+    /**
+     * @brief Gets the name of an interned tag.
+     * @param tag_id A valid tag ID.
+     * @return The tag name.
+     */
+    const std::string& name(uint32_t tag_id) const { return names[tag_id]; }
+
+    /**
+     * @brief Gets the number of interned tag names.
+     * @return The number of tags.
+     */
+    size_t size() const { return names.size(); }
+
+    /**
+     * @brief Records that a note carries a tag.
+     * @param note_id The ID of the note.
+     * @param name The tag name.
+     * @return True if the note did not carry the tag yet.
+     */
+    bool tagNote(int note_id, const std::string& name);
+
+    /**
+     * @brief Records that a note no longer carries a tag.
+     * @param note_id The ID of the note.
+     * @param name The tag name.
+     * @return True if the note carried the tag.
+     */
+    bool untagNote(int note_id, const std::string& name);
+
+    /**
+     * @brief Replaces the full set of tags of a note.
+     * @param note_id The ID of the note.
+     * @param names The tag names the note carries now.
+     */
+    void setNoteTags(int note_id, const std::vector<std::string>& names);
+
+    /**
+     * @brief Forgets every tag of a note.
+     * @param note_id The ID of the note.
+     */
+    void removeNote(int note_id);
+
+    /**
+     * @brief Detaches a tag from every note. The name stays interned.
+     * @param name The tag name.
+     * @return The IDs of the notes that carried the tag.
+     */
+    std::vector<uint32_t> clearTag(const std::string& name);
+
+    /**
+     * @brief Checks whether a note carries a tag.
+     * @param note_id The ID of the note.
+     * @param name The tag name.
+     * @return True if the note carries the tag.
+     */
+    bool hasTag(int note_id, const std::string& name) const;
+
+    /**
+     * @brief Gets the notes carrying a tag.
+     * @param name The tag name.
+     * @return The bitmap of note IDs, or nullptr if the name is unknown.
+     */
+    const RoaringBitmap* notesWith(const std::string& name) const;
+
+    /**
+     * @brief Gets the notes carrying every one of the given tags.
+     * @param names The tag names. An empty list yields an empty set.
+     * @return The intersection of the tags' bitmaps.
+     */
+    RoaringBitmap notesWithAll(const std::vector<std::string>& names) const;
+
+    /**
+     * @brief Gets the notes carrying at least one of the given tags.
+     * @param names The tag names.
+     * @return The union of the tags' bitmaps.
+     */
+    RoaringBitmap notesWithAny(const std::vector<std::string>& names) const;
+
+    /**
+     * @brief Removes every tag name and note association.
+     */
+    void clear();
+
+private:
+    std::unordered_map<std::string, uint32_t> ids_by_name;
+    std::vector<std::string> names;              // Indexed by tag ID
+    std::vector<RoaringBitmap> notes_by_tag;     // Indexed by tag ID
+    IdHashMap<std::vector<uint32_t>> tags_by_note; // Tag IDs carried by each note
+};
+
+#endif // TAG_DICTIONARY_HPP
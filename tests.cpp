@@ -0,0 +1,267 @@
+/**
+ * @file tests.cpp
+ * @brief Concurrency stress tests, NoteBatch checks and journal recovery checks.
+ */
+
+#include "tests.hpp"
+#include "journal_storage.hpp"
+#include "note_batch.hpp"
+
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace {
+
+const int STRESS_NOTE_COUNT = 64;
+const long long STRESS_UNITS_PER_NOTE = 1000;
+
+long long balanceOf(const NoteRecord& note) {
+    return std::stoll(*note.content);
+}
+
+NoteRecord balanceRecord(int id, long long balance) {
+    NoteRecord record;
+    record.id = id;
+    record.folder_id = 1 + id % 4;
+    record.title = "Account " + std::to_string(id);
+    record.content = std::make_shared<const std::string>(std::to_string(balance));
+    return record;
+}
+
+} // namespace
+
+bool runSnapshotStressTest(int reader_threads, int writer_threads, int updates_per_writer) {
+    std::cout << "--- SUITE: Snapshot Concurrency ---\n";
+    SnapshotStore store;
+    store.update([](SnapshotStore::Writer& writer) {
+        for (int folder_id = 1; folder_id <= 4; ++folder_id) {
+            FolderRecord folder;
+            folder.id = folder_id;
+            folder.name = "Folder " + std::to_string(folder_id);
+            writer.putFolder(folder);
+        }
+        for (int id = 1; id <= STRESS_NOTE_COUNT; ++id) {
+            writer.putNote(balanceRecord(id, STRESS_UNITS_PER_NOTE));
+        }
+    });
+    const long long expected_total = STRESS_NOTE_COUNT * STRESS_UNITS_PER_NOTE;
+
+    std::atomic<int> writers_running{writer_threads};
+    std::atomic<long long> failures{0};
+    std::atomic<long long> snapshots_checked{0};
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writer_threads; ++w) {
+        threads.emplace_back([&, w] {
+            std::mt19937 rng(static_cast<unsigned>(w) * 7919u + 1u);
+            std::uniform_int_distribution<int> pick(1, STRESS_NOTE_COUNT);
+            for (int i = 0; i < updates_per_writer; ++i) {
+                const int from = pick(rng);
+                const int to = pick(rng);
+                const bool recreate = i % 16 == 0;
+                store.update([&](SnapshotStore::Writer& writer) {
+                    auto source = writer.findNote(from);
+                    auto target = writer.findNote(to);
+                    if (from == to || !source || !target) {
+                        return;
+                    }
+                    const long long amount = std::min<long long>(balanceOf(*source), 1 + i % 7);
+                    if (recreate) {
+                        // Delete the source and recreate it empty, handing its whole balance over.
+                        writer.putNote(balanceRecord(to, balanceOf(*target) + balanceOf(*source)));
+                        writer.removeNote(from);
+                        writer.putNote(balanceRecord(from, 0));
+                    } else {
+                        writer.putNote(balanceRecord(from, balanceOf(*source) - amount));
+                        writer.putNote(balanceRecord(to, balanceOf(*target) + amount));
+                    }
+                });
+            }
+            --writers_running;
+        });
+    }
+    for (int r = 0; r < reader_threads; ++r) {
+        threads.emplace_back([&] {
+            uint64_t last_version = 0;
+            do {
+                auto snapshot = store.current();
+                if (snapshot->version() < last_version) {
+                    ++failures;
+                }
+                last_version = snapshot->version();
+                long long total = 0;
+                snapshot->notes().forEach([&](const std::shared_ptr<const NoteRecord>& note) { total += balanceOf(*note); });
+                size_t per_folder = 0;
+                for (int folder_id = 1; folder_id <= 4; ++folder_id) {
+                    per_folder += snapshot->notesInFolder(folder_id).size();
+                }
+                if (total != expected_total || snapshot->notes().size() != STRESS_NOTE_COUNT ||
+                    per_folder != STRESS_NOTE_COUNT || snapshot->folders().size() != 4) {
+                    ++failures;
+                }
+                ++snapshots_checked;
+            } while (writers_running > 0);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto final_snapshot = store.current();
+    long long final_total = 0;
+    final_snapshot->notes().forEach([&](const std::shared_ptr<const NoteRecord>& note) { final_total += balanceOf(*note); });
+    const bool passed = failures == 0 && final_total == expected_total;
+    std::cout << "[1/1] " << reader_threads << " readers checked " << snapshots_checked << " snapshots while "
+              << writer_threads << " writers published up to version " << final_snapshot->version() << "... "
+              << (passed ? "PASSED" : "FAILED (" + std::to_string(failures.load()) + " torn snapshots)") << "\n";
+    std::cout << "--- SUITE COMPLETE: " << (passed ? "1/1" : "0/1") << " PASSED ---\n\n";
+    return passed;
+}
+
+bool runBatchValidationTest(NoteManager& manager) {
+    std::cout << "--- SUITE: Batch Validation ---\n";
+    const std::string tag_name = "batch-validation-test";
+    int passed = 0;
+    int total = 0;
+    auto check = [&](const std::string& name, bool ok) {
+        ++total;
+        passed += ok ? 1 : 0;
+        std::cout << "[" << total << "] " << name << "... " << (ok ? "PASSED" : "FAILED") << "\n";
+    };
+
+    NoteBatch setup(manager);
+    const int existing_id = setup.createNote("Batch test", "Original body");
+    check("Commit a batch that creates a note", setup.commit() && manager.findNoteById(existing_id));
+    auto existing = manager.findNoteById(existing_id);
+    auto unchanged = [&]() {
+        return existing && manager.findNoteById(existing_id) == existing && !existing->isInTrash() &&
+               existing->getTitle() == "Batch test" && existing->getContent() == "Original body" &&
+               !existing->hasTag(tag_name);
+    };
+
+    NoteBatch batch(manager);
+    batch.editNote(existing_id, "Edited", "Edited body");
+    batch.deleteNote(existing_id);
+    batch.addTagToNote(existing_id, tag_name);
+    check("Reject a note used after it was deleted in the batch",
+          !batch.commit() && batch.getError().find("deleted earlier") != std::string::npos && unchanged());
+
+    batch.editNote(existing_id, "Edited", "Edited body");
+    batch.createNote("Lost", "No such folder", {}, INT_MAX);
+    check("Reject creating a note in a missing folder", !batch.commit() && unchanged());
+
+    batch.moveNote(existing_id, INT_MAX);
+    check("Reject moving a note to a missing folder", !batch.commit() && unchanged());
+
+    batch.editNote(existing_id, "Edited", "Edited body");
+    batch.addTagToNote(existing_id, "   ");
+    check("Reject an empty tag name", !batch.commit() && unchanged());
+
+    const int created_id = batch.createNote("Untagged", "Never committed", {"   "});
+    check("Reject an empty tag on a created note", !batch.commit() && !manager.findNoteById(created_id));
+
+    batch.editNote(INT_MAX, "Nobody", "No such note");
+    check("Reject an unknown note", !batch.commit() && unchanged());
+
+    const int new_id = batch.createNote("Created", "Draft");
+    batch.addTagToNote(new_id, tag_name);
+    batch.editNote(new_id, "Created and edited", "Final body");
+    batch.moveNote(new_id, existing->getParentFolder() ? existing->getParentFolder()->getId() : 0);
+    const bool committed = batch.commit();
+    auto created = manager.findNoteById(new_id);
+    check("Refer to a note created earlier in the same batch",
+          committed && created && created->hasTag(tag_name) && created->getTitle() == "Created and edited" &&
+              created->getContent() == "Final body");
+
+    NoteBatch cleanup(manager);
+    cleanup.deleteNote(existing_id, true);
+    if (created) cleanup.deleteNote(new_id, true);
+    check("Remove the test notes", cleanup.commit() && !manager.findNoteById(existing_id) && !manager.findNoteById(new_id));
+    manager.deleteTag(tag_name);
+
+    std::cout << "--- SUITE COMPLETE: " << passed << "/" << total << " PASSED ---\n\n";
+    return passed == total;
+}
+
+bool runJournalRecoveryTest(const std::string& path) {
+    std::cout << "--- SUITE: Journal Recovery ---\n";
+    const int record_count = 10;
+    int passed = 0;
+    int total = 0;
+    auto check = [&](const std::string& name, bool ok) {
+        ++total;
+        passed += ok ? 1 : 0;
+        std::cout << "[" << total << "] " << name << "... " << (ok ? "PASSED" : "FAILED") << "\n";
+    };
+    auto readFile = [&]() {
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+    auto writeFile = [&](const std::string& data) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    };
+    auto countNotes = [&]() {
+        JournalStorage journal(path);
+        if (!journal.open()) return -1;
+        int count = 0;
+        journal.replay([](const StoredFolder&) {}, [&](StoredNote&&) { ++count; });
+        return count;
+    };
+
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    std::vector<uint64_t> record_ends; // Offset just past each record
+    {
+        JournalStorage journal(path);
+        bool written = journal.open();
+        for (int i = 1; i <= record_count && written; ++i) {
+            StoredNote note;
+            note.id = i;
+            note.title = "Note " + std::to_string(i);
+            note.content = std::string(100, static_cast<char>('a' + i));
+            written = journal.putNote(note) && journal.sync();
+            record_ends.push_back(journal.fileBytes());
+        }
+        check("Write " + std::to_string(record_count) + " records", written);
+    }
+    if (record_ends.size() != static_cast<size_t>(record_count)) {
+        std::filesystem::remove(path, ec);
+        std::cout << "--- SUITE COMPLETE: " << passed << "/" << total << " PASSED ---\n\n";
+        return false;
+    }
+    const std::string intact = readFile();
+    check("Replay every record", countNotes() == record_count);
+
+    // The length field is the first four bytes of a frame, least significant first.
+    const uint64_t fourth_record = record_ends[2];
+    std::string damaged = intact;
+    damaged[fourth_record + 1] ^= 0x10;
+    writeFile(damaged);
+    {
+        JournalStorage journal(path);
+        check("Refuse a journal whose length field mid-file runs past the end",
+              !journal.open() && journal.getError().find("damaged") != std::string::npos);
+    }
+    check("Keep the records after a damaged length field", readFile() == damaged);
+
+    damaged = intact;
+    damaged[fourth_record + 3] ^= 0x80;
+    writeFile(damaged);
+    check("Refuse a length field above the record size limit", countNotes() == -1 && readFile() == damaged);
+
+    damaged = intact;
+    damaged[record_ends[record_count - 2] + 1] ^= 0x10;
+    writeFile(damaged);
+    check("Drop a last record whose length runs past the end", countNotes() == record_count - 1);
+
+    writeFile(intact.substr(0, record_ends[record_count - 1] - 20));
+    check("Drop a torn last record", countNotes() == record_count - 1);
+
+    std::filesystem::remove(path, ec);
+    std::cout << "--- SUITE COMPLETE: " << passed << "/" << total << " PASSED ---\n\n";
+    return passed == total;
+}
@@ -10,4 +10,35 @@
  */
 bool runAllTests(NoteManager& manager);
 
-#endif // TESTS_HPP
\ No newline at end of file
+/**
+ * @brief Stress-tests SnapshotStore with concurrent readers and writers.
+ *
+ * Writers move units of a fixed total between notes, and delete and recreate
+ * notes, each change as one update. Readers check that every snapshot they
+ * see keeps the total and the note count, and that versions never go back.
+ * @param reader_threads The number of reader threads.
+ * @param writer_threads The number of writer threads.
+ * @param updates_per_writer The number of updates each writer publishes.
+ * @return True if no reader observed a torn or stale snapshot, false otherwise.
+ */
+bool runSnapshotStressTest(int reader_threads = 4, int writer_threads = 2, int updates_per_writer = 20000);
+
+/**
+ * @brief Checks NoteBatch validation: a batch that uses a note deleted earlier in it, a missing
+ * folder, an empty tag or an unknown note is rejected without changing anything, and a batch
+ * may refer to notes it creates. The notes and tag it creates are removed afterwards.
+ * @param manager A reference to the NoteManager to run the test against.
+ * @return True if all checks pass, false otherwise.
+ */
+bool runBatchValidationTest(NoteManager& manager);
+
+/**
+ * @brief Checks that JournalStorage tells a damaged record from a torn tail: a corrupted length
+ * field mid-file makes open() fail and leaves the file as it was, while a record cut short or
+ * overrunning the end of the file is dropped. The journal file is removed afterwards.
+ * @param path The journal file to create.
+ * @return True if all checks pass, false otherwise.
+ */
+bool runJournalRecoveryTest(const std::string& path = "journal_recovery_test.journal");
+
+#endif // TESTS_HPP
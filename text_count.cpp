@@ -0,0 +1,74 @@
+/**
+ * @file text_count.cpp
+ * @brief Implementation of the text counting functions.
+ */
+
+#include "text_count.hpp"
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NOTES_TEXT_COUNT_SSE2 1
+#endif
+
+namespace {
+
+unsigned popcount16(unsigned bits) {
+    bits = bits - ((bits >> 1) & 0x5555u);
+    bits = (bits & 0x3333u) + ((bits >> 2) & 0x3333u);
+    bits = (bits + (bits >> 4)) & 0x0F0Fu;
+    return (bits + (bits >> 8)) & 0x1Fu;
+}
+
+/**
+ * @brief Counts [data, data + size) into counts, given whether the byte before data was a space.
+ */
+void countScalar(const char* data, size_t size, bool previous_space, TextCounts& counts) {
+    for (size_t i = 0; i < size; ++i) {
+        const char c = data[i];
+        const bool space = isTextSpace(c);
+        counts.words += !space && previous_space;
+        counts.chars += (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+        previous_space = space;
+    }
+}
+
+} // namespace
+
+TextCounts countTextScalar(const char* data, size_t size) {
+    TextCounts counts;
+    countScalar(data, size, true, counts);
+    return counts;
+}
+
+TextCounts countText(const char* data, size_t size) {
+    TextCounts counts;
+    size_t i = 0;
+    bool previous_space = true;
+#ifdef NOTES_TEXT_COUNT_SSE2
+    const __m128i continuation_mask = _mm_set1_epi8(static_cast<char>(0xC0));
+    const __m128i continuation = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i sign = _mm_set1_epi8(static_cast<char>(0x80));
+    const __m128i control_limit = _mm_set1_epi8(static_cast<char>(0x80 + 5)); // '\t'..'\r' is 5 values
+    for (; i + 16 <= size; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const unsigned continuations = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(bytes, continuation_mask), continuation)));
+        // SSE2 only compares signed bytes: flipping the sign bit turns (byte - '\t') < 5 unsigned into a signed test.
+        const __m128i control =
+            _mm_cmplt_epi8(_mm_xor_si128(_mm_sub_epi8(bytes, tab), sign), control_limit);
+        const unsigned spaces =
+            static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(control, _mm_cmpeq_epi8(bytes, space))));
+        // A word starts at every non-space byte whose predecessor (shifted in from the last block) is a space.
+        const unsigned preceded_by_space = ((spaces << 1) | (previous_space ? 1u : 0u)) & 0xFFFFu;
+        counts.words += popcount16(~spaces & preceded_by_space & 0xFFFFu);
+        counts.chars += 16 - popcount16(continuations);
+        previous_space = (spaces & 0x8000u) != 0;
+    }
+#endif
+    countScalar(data + i, size - i, previous_space, counts);
+    return counts;
+}
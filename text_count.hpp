@@ -0,0 +1,45 @@
+/**
+ * @file text_count.hpp
+ * @brief Word and character counting for note bodies.
+ */
+
+#ifndef TEXT_COUNT_HPP
+#define TEXT_COUNT_HPP
+
+#include <cstddef>
+
+/**
+ * @struct TextCounts
+ * @brief The counts shown for a note: words and UTF-8 code points.
+ */
+struct TextCounts {
+    size_t words = 0; ///< Maximal runs of non-whitespace bytes.
+    size_t chars = 0; ///< UTF-8 code points, i.e. bytes that are not continuation bytes (10xxxxxx).
+};
+
+/**
+ * @brief Checks whether a byte separates words: space, \\t, \\n, \\v, \\f or \\r, as std::isspace in the C locale.
+ */
+inline bool isTextSpace(char c) {
+    return c == ' ' || (static_cast<unsigned char>(c) >= '\t' && static_cast<unsigned char>(c) <= '\r');
+}
+
+/**
+ * @brief Counts the words and code points of a UTF-8 buffer, 16 bytes at a time with SSE2 where available.
+ *
+ * Both counts are per byte class, so they need no decoding and invalid UTF-8
+ * cannot derail them. Code points are additive over any split of the buffer;
+ * a word is counted where a non-space byte follows a space or the start.
+ *
+ * @param data The text.
+ * @param size The size in bytes.
+ * @return The counts.
+ */
+TextCounts countText(const char* data, size_t size);
+
+/**
+ * @brief The byte-at-a-time version of countText, used for the tail of the buffer and as a reference.
+ */
+TextCounts countTextScalar(const char* data, size_t size);
+
+#endif // TEXT_COUNT_HPP
@@ -0,0 +1,144 @@
+/**
+ * @file trace.cpp
+ * @brief Implementation of the Tracer class.
+ */
+
+#include "trace.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+uint64_t steadyNanoseconds() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+void writeJsonString(std::FILE* out, const char* text) {
+    std::fputc('"', out);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', out);
+            std::fputc(*c, out);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            std::fprintf(out, "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(*c)));
+        } else {
+            std::fputc(*c, out);
+        }
+    }
+    std::fputc('"', out);
+}
+
+} // namespace
+
+Tracer& Tracer::global() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::Tracer() : epoch_ns(steadyNanoseconds()) {}
+
+void Tracer::start() {
+    recording.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::stop() {
+    recording.store(false, std::memory_order_relaxed);
+}
+
+uint64_t Tracer::now() const {
+    return steadyNanoseconds() - epoch_ns;
+}
+
+Tracer::ThreadBuffer& Tracer::localBuffer() {
+    // One cached buffer per thread; the tracer owns it so it survives the thread for the final export.
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        buffer->thread_id = static_cast<uint32_t>(buffers.size() + 1);
+        buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.name = name;
+}
+
+void Tracer::record(const char* name, uint64_t start_ns, uint64_t end_ns) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() >= MAX_EVENTS_PER_THREAD) {
+        ++buffer.dropped;
+        return;
+    }
+    buffer.events.push_back(Event{name, start_ns, end_ns - start_ns});
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->events.clear();
+        buffer->events.shrink_to_fit();
+        buffer->dropped = 0;
+    }
+}
+
+size_t Tracer::eventCount() const {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    size_t count = 0;
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+bool Tracer::writeChromeTrace(const std::string& file_path) const {
+    std::FILE* out = std::fopen(file_path.c_str(), "wb");
+    if (!out) {
+        return false;
+    }
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", out);
+    bool first = true;
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    for (const auto& buffer : buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        if (!buffer->name.empty()) {
+            std::fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                         first ? "" : ",\n", buffer->thread_id);
+            writeJsonString(out, buffer->name.c_str());
+            std::fputs("}}", out);
+            first = false;
+        }
+        for (const Event& event : buffer->events) {
+            // Complete ("X") events in microseconds; the viewer nests them by time on each thread.
+            std::fputs(first ? "{\"name\":" : ",\n{\"name\":", out);
+            writeJsonString(out, event.name);
+            std::fprintf(out, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", buffer->thread_id,
+                         static_cast<double>(event.start_ns) / 1000.0,
+                         static_cast<double>(event.duration_ns) / 1000.0);
+            first = false;
+        }
+        if (buffer->dropped > 0) {
+            std::fprintf(out, "%s{\"name\":\"trace buffer full\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,"
+                              "\"ts\":%.3f,\"args\":{\"dropped\":%llu}}",
+                         first ? "" : ",\n", buffer->thread_id,
+                         buffer->events.empty()
+                             ? 0.0
+                             : static_cast<double>(buffer->events.back().start_ns + buffer->events.back().duration_ns) /
+                                   1000.0,
+                         static_cast<unsigned long long>(buffer->dropped));
+            first = false;
+        }
+    }
+    std::fputs("\n]}\n", out);
+    const bool ok = std::ferror(out) == 0;
+    return std::fclose(out) == 0 && ok;
+}
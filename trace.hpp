@@ -0,0 +1,159 @@
+/**
+ * @file trace.hpp
+ * @brief Scoped trace spans recorded per thread and exported in the Chrome trace event format.
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class Tracer
+ * @brief Collects timed spans from every thread and writes them as a Chrome trace.
+ *
+ * Each thread appends to its own buffer, so recording a span takes an
+ * uncontended lock and a vector push; buffers are only shared while a trace is
+ * written. Nothing is recorded until start() is called, and a span opened while
+ * the tracer is stopped costs one atomic load. The written file opens in
+ * chrome://tracing or https://ui.perfetto.dev, where nested spans on the same
+ * thread stack up into the call path of a slow interaction.
+ *
+ * Spans are normally opened with TRACE_SCOPE, which compiles to nothing unless
+ * NOTES_ENABLE_TRACING is defined.
+ */
+class Tracer {
+public:
+    /// Spans recorded per thread before further spans on that thread are dropped (about 24 MiB).
+    static constexpr size_t MAX_EVENTS_PER_THREAD = size_t(1) << 20;
+
+    /**
+     * @brief Gets the process-wide tracer.
+     */
+    static Tracer& global();
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Starts recording spans. Spans recorded earlier are kept.
+     */
+    void start();
+
+    /**
+     * @brief Stops recording spans. Spans already open are still recorded when they close.
+     */
+    void stop();
+
+    bool isRecording() const { return recording.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Forgets every recorded span. Thread names are kept.
+     */
+    void clear();
+
+    /**
+     * @brief Names the calling thread in the trace, e.g. "ui" or "loader".
+     * @param name The thread name.
+     */
+    void setThreadName(const std::string& name);
+
+    /**
+     * @brief Records a finished span on the calling thread.
+     * @param name The span name. Must outlive the tracer; string literals do.
+     * @param start_ns The start, from now().
+     * @param end_ns The end, from now().
+     */
+    void record(const char* name, uint64_t start_ns, uint64_t end_ns);
+
+    /**
+     * @brief Gets the current time on the trace clock, in nanoseconds since the tracer was created.
+     */
+    uint64_t now() const;
+
+    /**
+     * @brief Writes every recorded span as a Chrome trace JSON file.
+     * @param file_path The file to write.
+     * @return True on success, false if the file could not be written.
+     */
+    bool writeChromeTrace(const std::string& file_path) const;
+
+    /**
+     * @brief Gets the number of spans recorded so far, over all threads.
+     */
+    size_t eventCount() const;
+
+private:
+    Tracer(); // Per-thread buffers are cached in a thread_local, so there is only the global tracer
+
+    struct Event {
+        const char* name;
+        uint64_t start_ns;
+        uint64_t duration_ns;
+    };
+
+    struct ThreadBuffer {
+        uint32_t thread_id = 0;
+        std::string name;
+        mutable std::mutex mutex; // Taken by the owning thread on every span, by readers rarely
+        std::vector<Event> events;
+        uint64_t dropped = 0;
+    };
+
+    ThreadBuffer& localBuffer();
+
+    std::atomic<bool> recording{false};
+    const uint64_t epoch_ns;
+
+    mutable std::mutex buffers_mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers; // Kept after their thread exits
+};
+
+/**
+ * @class TraceSpan
+ * @brief Records the lifetime of the object as a span, if the tracer was recording when it was created.
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : name(Tracer::global().isRecording() ? name : nullptr), start_ns(this->name ? Tracer::global().now() : 0) {}
+
+    ~TraceSpan() {
+        if (name) {
+            Tracer& tracer = Tracer::global();
+            tracer.record(name, start_ns, tracer.now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name;
+    uint64_t start_ns;
+};
+
+#define NOTES_TRACE_CONCAT_(a, b) a##b
+#define NOTES_TRACE_CONCAT(a, b) NOTES_TRACE_CONCAT_(a, b)
+
+#ifdef NOTES_ENABLE_TRACING
+/**
+ * @brief Traces the rest of the enclosing scope as a span called `name` (a string literal).
+ */
+#define TRACE_SCOPE(name) TraceSpan NOTES_TRACE_CONCAT(notes_trace_span_, __LINE__)(name)
+
+/**
+ * @brief Names the calling thread in the trace.
+ */
+#define TRACE_THREAD_NAME(name) Tracer::global().setThreadName(name)
+#else
+#define TRACE_SCOPE(name) static_cast<void>(0)
+#define TRACE_THREAD_NAME(name) static_cast<void>(0)
+#endif
+
+#endif // TRACE_HPP
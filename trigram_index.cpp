@@ -0,0 +1,169 @@
+/**
+ * @file trigram_index.cpp
+ * @brief Implementation of the TrigramIndex class.
+ */
+
+#include "trigram_index.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace {
+
+unsigned char foldCase(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+}
+
+uint32_t packTrigram(unsigned char a, unsigned char b, unsigned char c) {
+    return (static_cast<uint32_t>(foldCase(a)) << 16) | (static_cast<uint32_t>(foldCase(b)) << 8) | foldCase(c);
+}
+
+} // namespace
+
+std::vector<uint32_t> TrigramIndex::extractTrigrams(std::string_view text) {
+    return extractTrigrams(std::vector<std::string_view>{text});
+}
+
+std::vector<uint32_t> TrigramIndex::extractTrigrams(const std::vector<std::string_view>& chunks) {
+    std::vector<uint32_t> trigrams;
+    size_t size = 0;
+    for (std::string_view chunk : chunks) {
+        size += chunk.size();
+    }
+    if (size < MIN_QUERY_LENGTH) {
+        return trigrams;
+    }
+    trigrams.reserve(size - 2);
+    uint32_t window = 0; // The last three bytes, packed like packTrigram()
+    size_t seen = 0;
+    for (std::string_view chunk : chunks) {
+        for (char c : chunk) {
+            window = ((window << 8) | foldCase(static_cast<unsigned char>(c))) & 0xFFFFFFu;
+            if (++seen >= MIN_QUERY_LENGTH) {
+                trigrams.push_back(window);
+            }
+        }
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+void TrigramIndex::addDocument(int note_id, std::string_view title, std::string_view content) {
+    addDocument(note_id, title, std::vector<std::string_view>{content});
+}
+
+void TrigramIndex::addDocument(int note_id, std::string_view title, const std::vector<std::string_view>& content) {
+    removeDocument(note_id);
+
+    // Index title + '\n' + content without building it: the title, the content, and the few
+    // trigrams around the separator, which keeps the end of the title and the start of the
+    // content from forming real trigrams.
+    std::string seam(title.substr(title.size() - std::min<size_t>(title.size(), 2)));
+    seam += '\n';
+    const size_t seam_size = seam.size() + 2;
+    for (auto chunk = content.begin(); chunk != content.end() && seam.size() < seam_size; ++chunk) {
+        seam.append(chunk->substr(0, seam_size - seam.size()));
+    }
+    std::vector<uint32_t> trigrams = extractTrigrams(content);
+    for (std::string_view part : {title, std::string_view(seam)}) {
+        const std::vector<uint32_t> more = extractTrigrams(part);
+        const size_t middle = trigrams.size();
+        trigrams.insert(trigrams.end(), more.begin(), more.end());
+        std::inplace_merge(trigrams.begin(), trigrams.begin() + static_cast<std::ptrdiff_t>(middle), trigrams.end());
+        trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    }
+    for (uint32_t trigram : trigrams) {
+        std::vector<int>& list = notes_by_trigram[trigram];
+        if (list.empty() || list.back() < note_id) {
+            list.push_back(note_id);
+        } else {
+            list.insert(std::lower_bound(list.begin(), list.end(), note_id), note_id);
+        }
+    }
+    trigrams_by_note[note_id] = std::move(trigrams);
+}
+
+bool TrigramIndex::removeDocument(int note_id) {
+    auto doc_it = trigrams_by_note.find(note_id);
+    if (doc_it == trigrams_by_note.end()) {
+        return false;
+    }
+    for (uint32_t trigram : doc_it->second) {
+        auto list_it = notes_by_trigram.find(trigram);
+        if (list_it == notes_by_trigram.end()) continue;
+        std::vector<int>& list = list_it->second;
+        auto pos = std::lower_bound(list.begin(), list.end(), note_id);
+        if (pos != list.end() && *pos == note_id) {
+            list.erase(pos);
+        }
+        if (list.empty()) {
+            notes_by_trigram.erase(list_it);
+        }
+    }
+    trigrams_by_note.erase(doc_it);
+    return true;
+}
+
+bool TrigramIndex::candidates(const std::string& fragment, std::vector<int>& candidates) const {
+    candidates.clear();
+    if (fragment.size() < MIN_QUERY_LENGTH) {
+        return false;
+    }
+
+    std::vector<const std::vector<int>*> lists;
+    for (uint32_t trigram : extractTrigrams(fragment)) {
+        auto it = notes_by_trigram.find(trigram);
+        if (it == notes_by_trigram.end()) {
+            return true; // Some trigram never occurs: nothing can match
+        }
+        lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<int>* a, const std::vector<int>* b) { return a->size() < b->size(); });
+
+    candidates = *lists.front();
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+        const std::vector<int>& list = *lists[i];
+        auto cursor = list.begin();
+        size_t kept = 0;
+        for (int id : candidates) {
+            cursor = std::lower_bound(cursor, list.end(), id);
+            if (cursor == list.end()) break;
+            if (*cursor == id) {
+                candidates[kept++] = id;
+            }
+        }
+        candidates.resize(kept);
+    }
+    return true;
+}
+
+size_t TrigramIndex::estimateMatches(const std::string& fragment) const {
+    if (fragment.size() < MIN_QUERY_LENGTH) {
+        return SIZE_MAX;
+    }
+    size_t estimate = SIZE_MAX;
+    for (uint32_t trigram : extractTrigrams(fragment)) {
+        auto it = notes_by_trigram.find(trigram);
+        estimate = std::min(estimate, it == notes_by_trigram.end() ? size_t(0) : it->second.size());
+    }
+    return estimate;
+}
+
+bool TrigramIndex::containsIgnoreCase(std::string_view text, std::string_view fragment) {
+    auto it = std::search(text.begin(), text.end(), fragment.begin(), fragment.end(), [](char a, char b) {
+        return foldCase(static_cast<unsigned char>(a)) == foldCase(static_cast<unsigned char>(b));
+    });
+    return it != text.end() || fragment.empty();
+}
+
+size_t TrigramIndex::documentCount() const {
+    return trigrams_by_note.size();
+}
+
+void TrigramIndex::clear() {
+    notes_by_trigram.clear();
+    trigrams_by_note.clear();
+}
@@ -0,0 +1,96 @@
+/**
+ * @file trigram_index.hpp
+ * @brief This file contains the declaration of the trigram index used for substring search.
+ */
+
+#ifndef TRIGRAM_INDEX_HPP
+#define TRIGRAM_INDEX_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+/**
+ * @class TrigramIndex
+ * @brief Maps every three-byte window of a note's text to the notes containing it.
+ *
+ * A substring query of length n >= 3 can only match notes that contain all of
+ * its n - 2 trigrams, so intersecting their posting lists yields a small
+ * candidate set that the caller then verifies against the real text. Matching
+ * is case-insensitive for ASCII letters.
+ */
+class TrigramIndex {
+public:
+    /**
+     * @brief The shortest fragment the index can narrow down.
+     */
+    static const size_t MIN_QUERY_LENGTH = 3;
+
+    /**
+     * @brief Adds a note to the index, replacing any previous entry for the same ID.
+     * @param note_id The ID of the note.
+     * @param title The title of the note.
+     * @param content The content of the note.
+     */
+    void addDocument(int note_id, std::string_view title, std::string_view content);
+
+    /**
+     * @brief Adds a note whose content is held in pieces (see Note::forEachContentChunk), without joining them.
+     * @param note_id The ID of the note.
+     * @param title The title of the note.
+     * @param content The pieces of the content, in order.
+     */
+    void addDocument(int note_id, std::string_view title, const std::vector<std::string_view>& content);
+
+    /**
+     * @brief Removes a note from the index.
+     * @param note_id The ID of the note to remove.
+     * @return True if the note was indexed, false otherwise.
+     */
+    bool removeDocument(int note_id);
+
+    /**
+     * @brief Computes the notes that may contain a fragment.
+     * @param fragment The text to look for.
+     * @param candidates Receives the sorted IDs of notes containing every trigram of the fragment.
+     * @return False if the fragment is shorter than MIN_QUERY_LENGTH and cannot be narrowed down.
+     */
+    bool candidates(const std::string& fragment, std::vector<int>& candidates) const;
+
+    /**
+     * @brief Gets the number of notes containing a trigram of the fragment, for the rarest one.
+     * @param fragment The text to look for.
+     * @return An upper bound on the number of matches, or SIZE_MAX if the fragment is too short.
+     */
+    size_t estimateMatches(const std::string& fragment) const;
+
+    /**
+     * @brief Checks whether a text contains a fragment, ignoring ASCII case.
+     * @param text The text to search.
+     * @param fragment The fragment to look for.
+     * @return True if the fragment occurs in the text.
+     */
+    static bool containsIgnoreCase(std::string_view text, std::string_view fragment);
+
+    /**
+     * @brief Gets the number of indexed notes.
+     * @return The number of documents.
+     */
+    size_t documentCount() const;
+
+    /**
+     * @brief Removes every entry from the index.
+     */
+    void clear();
+
+private:
+    static std::vector<uint32_t> extractTrigrams(std::string_view text);
+    static std::vector<uint32_t> extractTrigrams(const std::vector<std::string_view>& chunks); // Windows may span two pieces
+
+    std::unordered_map<uint32_t, std::vector<int>> notes_by_trigram;
+    std::unordered_map<int, std::vector<uint32_t>> trigrams_by_note; // Distinct trigrams, for removal
+};
+
+#endif // TRIGRAM_INDEX_HPP
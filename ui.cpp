@@ -0,0 +1,270 @@
+/**
+ * @file ui.cpp
+ * @brief Implementation of the MainWindow folder tree and note list.
+ */
+
+#include "ui.hpp"
+#include "trace.hpp"
+
+#include <QCloseEvent>
+#include <QItemSelectionModel>
+#include <QSignalBlocker>
+
+// --- Folder Tree ---
+
+void MainWindow::setupFolderTree() {
+    folderTreeModel = new FolderTreeModel(this);
+    folderTree = new QTreeView(this);
+    folderTree->setModel(folderTreeModel);
+    folderTree->setHeaderHidden(true);
+    folderTree->setUniformRowHeights(true);
+    folderTree->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    connect(folderTree->selectionModel(), &QItemSelectionModel::currentChanged, this,
+            [this](const QModelIndex& current, const QModelIndex&) { onFolderSelected(current); });
+}
+
+void MainWindow::loadFolderTree() {
+    TRACE_SCOPE("ui.loadFolderTree");
+    std::vector<std::shared_ptr<Folder>> roots{noteManager.getRootFolder()};
+    auto trash = noteManager.getTrashFolder();
+    if (trash && !trash->getParent()) {
+        roots.push_back(trash);
+    }
+    if (roots == folderTreeModel->rootFolders()) {
+        return;
+    }
+    folderTreeModel->setRootFolders(std::move(roots));
+    folderTree->expand(folderTreeModel->index(0, 0));
+}
+
+void MainWindow::onFolderSelected(const QModelIndex& index) {
+    TRACE_SCOPE("ui.onFolderSelected");
+    auto folder = folderTreeModel->folderAt(index);
+    if (folder) {
+        loadNotesForFolder(folder);
+    }
+}
+
+// --- Note List ---
+
+void MainWindow::setupNoteList() {
+    noteListModel = new NoteListModel(this);
+    noteList = new QListView(this);
+    noteList->setModel(noteListModel);
+    // Every row has the same height, so the view can lay out 50k rows without measuring them
+    // and only asks the model for the rows it paints.
+    noteList->setUniformItemSizes(true);
+    noteList->setLayoutMode(QListView::Batched);
+    noteList->setBatchSize(256);
+    noteList->setSelectionMode(QAbstractItemView::SingleSelection);
+    noteList->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    connect(noteList->selectionModel(), &QItemSelectionModel::currentChanged, this,
+            [this](const QModelIndex& current, const QModelIndex&) { onNoteSelected(current); });
+}
+
+void MainWindow::loadNotesForFolder(const std::shared_ptr<Folder>& folder) {
+    TRACE_SCOPE("ui.loadNotesForFolder");
+    closeEditorNote();
+    searchCursor.reset();
+    currentFolder = folder;
+    noteListModel->setFolder(folder);
+}
+
+void MainWindow::refreshUI() {
+    TRACE_SCOPE("ui.refreshUI");
+    loadFolderTree();
+    // Both models track their folders row by row; the list only needs a reset when the folder changed.
+    if (noteListModel->folder() != currentFolder) {
+        loadNotesForFolder(currentFolder);
+    }
+}
+
+void MainWindow::onNoteSelected(const QModelIndex& index) {
+    TRACE_SCOPE("ui.onNoteSelected");
+    saveEditorNow();
+    currentNote = noteListModel->noteAt(index);
+    // Loading a note into the editor is not an edit.
+    const QSignalBlocker blocker(noteEditor);
+    if (!currentNote) {
+        noteEditor->clear();
+        return;
+    }
+    // A large edited body is a piece table: gather its pieces rather than flattening the note.
+    QByteArray content;
+    content.reserve(static_cast<int>(currentNote->getContentSize()));
+    currentNote->forEachContentChunk(
+        [&content](std::string_view chunk) { content.append(chunk.data(), static_cast<int>(chunk.size())); });
+    noteEditor->setPlainText(QString::fromUtf8(content));
+}
+
+// --- Search ---
+
+void MainWindow::onAdvancedSearch() {
+    // The note list follows the dialog while the user types; accepting it runs the full search below.
+    // Cancelling it puts back the view it replaced: the folder or the search results, and the open note.
+    const std::shared_ptr<Folder> previous_folder = currentFolder;
+    const std::shared_ptr<Note> previous_note = currentNote;
+    std::vector<std::shared_ptr<Note>> previous_results;
+    std::unique_ptr<SearchCursor> previous_cursor;
+    bool live_results_shown = false;
+    SearchDialog dialog(this);
+    if (dialog.setupLiveSearch(noteManager)) {
+        connect(&dialog, &SearchDialog::resultsReady, this, [&](const std::vector<int>& note_ids, bool complete) {
+            if (!live_results_shown) {
+                live_results_shown = true;
+                previous_results = noteListModel->fixedNotes();
+                previous_cursor = std::move(searchCursor);
+            }
+            showLiveSearchResults(note_ids, complete);
+        });
+    }
+    if (dialog.exec() != QDialog::Accepted) {
+        if (live_results_shown) {
+            if (previous_folder) {
+                loadNotesForFolder(previous_folder);
+            } else {
+                closeEditorNote();
+                noteListModel->setNotes(std::move(previous_results));
+                currentFolder.reset();
+                searchCursor = std::move(previous_cursor);
+                scheduleNextSearchPage();
+            }
+            if (previous_note) {
+                noteList->setCurrentIndex(noteListModel->indexOfNote(previous_note->getId()));
+            }
+        }
+        return;
+    }
+    TRACE_SCOPE("ui.onAdvancedSearch");
+    closeEditorNote();
+    currentFolder.reset();
+    // Show the first page at once; the rest is evaluated a page per event loop turn.
+    searchCursor = std::make_unique<SearchCursor>(noteManager, dialog.getCriteria());
+    noteListModel->setNotes(searchCursor->next(SearchCursor::DEFAULT_PAGE_SIZE));
+    scheduleNextSearchPage();
+}
+
+void MainWindow::scheduleNextSearchPage() {
+    // At most one page is queued, even when a new search starts while the last one is still filling in.
+    if (searchPageQueued || !searchCursor || searchCursor->done()) {
+        return;
+    }
+    searchPageQueued = true;
+    QTimer::singleShot(0, this, [this]() {
+        searchPageQueued = false;
+        showNextSearchPage();
+    });
+}
+
+void MainWindow::showNextSearchPage() {
+    // Opening a folder since this page was queued drops the cursor.
+    if (!searchCursor) {
+        return;
+    }
+    TRACE_SCOPE("ui.showNextSearchPage");
+    noteListModel->appendNotes(searchCursor->next(4 * SearchCursor::DEFAULT_PAGE_SIZE));
+    scheduleNextSearchPage();
+}
+
+void MainWindow::showLiveSearchResults(const std::vector<int>& note_ids, bool /*complete*/) {
+    TRACE_SCOPE("ui.showLiveSearchResults");
+    closeEditorNote();
+    searchCursor.reset();
+    currentFolder.reset();
+    std::vector<std::shared_ptr<Note>> notes;
+    notes.reserve(note_ids.size());
+    for (int id : note_ids) {
+        if (auto note = noteManager.findNoteById(id)) {
+            notes.push_back(std::move(note));
+        }
+    }
+    // A first batch is replaced by the complete results, which start with the same notes.
+    noteListModel->setNotes(std::move(notes));
+}
+
+// --- Search Dialog ---
+
+bool SearchDialog::setupLiveSearch(NoteManager& manager) {
+    // The workers read snapshots. Turning them on here would copy every body on the GUI thread and
+    // keep copying on each autosave, so live search is only offered when the manager already has them.
+    if (!manager.getSnapshot()) {
+        return false;
+    }
+    liveSearch = std::make_unique<LiveSearch>(
+        manager, [this](uint64_t generation, const LiveSearch::Results& results, bool complete) {
+            std::vector<int> note_ids;
+            note_ids.reserve(results.size());
+            for (const auto& note : results) {
+                note_ids.push_back(note->id);
+            }
+            // Runs on a worker; hand the IDs to the GUI thread, which drops them if a newer query was submitted.
+            QMetaObject::invokeMethod(
+                this,
+                [this, generation, note_ids = std::move(note_ids), complete]() {
+                    if (liveSearch && generation == liveSearch->latestGeneration()) {
+                        emit resultsReady(note_ids, complete);
+                    }
+                },
+                Qt::QueuedConnection);
+        });
+    connect(keywordEdit, &QLineEdit::textChanged, this, &SearchDialog::onQueryEdited);
+    connect(tagsEdit, &QLineEdit::textChanged, this, &SearchDialog::onQueryEdited);
+    return true;
+}
+
+void SearchDialog::onQueryEdited() {
+    if (liveSearch) {
+        liveSearch->submit(getCriteria());
+    }
+}
+
+// --- Autosave ---
+
+void MainWindow::setupAutosave() {
+    autosave = std::make_unique<AutosaveEngine>(noteManager);
+    autosaveTimer = new QTimer(this);
+    autosaveTimer->setSingleShot(true);
+    autosaveTimer->setInterval(static_cast<int>(autosave->quietPeriod().count()));
+    connect(autosaveTimer, &QTimer::timeout, this, &MainWindow::onAutosaveTimeout);
+    connect(noteEditor, &QTextEdit::textChanged, this, &MainWindow::onEditorTextChanged);
+}
+
+void MainWindow::onEditorTextChanged() {
+    if (!currentNote) {
+        return;
+    }
+    // Only mark the note dirty here; the text is read once, when the editor goes quiet.
+    autosave->noteEdited(currentNote->getId());
+    autosaveTimer->start();
+}
+
+void MainWindow::onAutosaveTimeout() {
+    TRACE_SCOPE("ui.onAutosaveTimeout");
+    saveEditorNow();
+}
+
+void MainWindow::saveEditorNow() {
+    autosaveTimer->stop();
+    if (!currentNote || autosave->pendingNoteId() != currentNote->getId()) {
+        return;
+    }
+    autosave->save(currentNote->getId(), noteEditor->toPlainText().toStdString());
+}
+
+void MainWindow::closeEditorNote() {
+    saveEditorNow();
+    currentNote.reset();
+    // With no current note, onEditorTextChanged ignores edits; leave nothing in the editor to lose.
+    const QSignalBlocker blocker(noteEditor);
+    noteEditor->clear();
+}
+
+void MainWindow::closeEvent(QCloseEvent* event) {
+    saveEditorNow();
+    if (!autosave->flush()) {
+        noteManager.log("Autosave: some writes failed while closing.");
+    }
+    QMainWindow::closeEvent(event);
+}
@@ -22,7 +22,16 @@
 #include <QMessageBox>
 #include <QSplitter>
 #include <QTextBrowser>
+#include <QListView>
+#include <QTreeView>
+#include <QTimer>
+#include <memory>
 #include "notes.hpp"
+#include "search_cursor.hpp"
+#include "live_search.hpp"
+#include "autosave.hpp"
+#include "note_list_model.hpp"
+#include "folder_tree_model.hpp"
 #include "settingsdialog.hpp"
  
 #include <QGraphicsView>
@@ -46,12 +55,39 @@
      * @return The search criteria.
      */
     NoteManager::SearchCriteria getCriteria() const;
+
+    /**
+     * @brief Searches as the user types: every edit of the keyword or tags runs the criteria
+     * on a LiveSearch worker and emits resultsReady(). A new edit cancels the search still running
+     * for the previous one. Does nothing unless the manager keeps snapshots (`concurrent_reads = true`),
+     * since without them the search would run on the GUI thread.
+     * @param manager The manager to search; must outlive the dialog.
+     * @return True if live search is on.
+     */
+    bool setupLiveSearch(NoteManager& manager);
+
+signals:
+    /**
+     * @brief Emitted with the results of the latest criteria.
+     * @param note_ids The IDs of the matching notes, in result order.
+     * @param complete False for a first batch sent before the search has finished.
+     */
+    void resultsReady(const std::vector<int>& note_ids, bool complete);
+
+private slots:
+    /**
+     * @brief Slot for keyword and tag edits: submits the new criteria.
+     */
+    void onQueryEdited();
+
  private:
     QLineEdit* keywordEdit;
     QLineEdit* tagsEdit;
     QDateTimeEdit* startDateEdit;
     QDateTimeEdit* endDateEdit;
     QCheckBox* searchTrashCheck;
+
+    std::unique_ptr<LiveSearch> liveSearch; // Null until setupLiveSearch()
 };
 
 /**
@@ -104,6 +140,13 @@ public:
      */
     ~MainWindow() override;
 
+protected:
+    /**
+     * @brief Saves the editor and waits for pending writes before the window closes.
+     * @param event The close event.
+     */
+    void closeEvent(QCloseEvent* event) override;
+
 private slots:
     // --- Action Slots ---
     /**
@@ -133,22 +176,38 @@ private slots:
 
     /**
      * @brief Slot for when a folder is selected.
-     * @param item The selected item.
-     * @param column The selected column.
+     * @param index The model index of the selected folder.
      */
-    void onFolderSelected(QTreeWidgetItem* item, int column);
+    void onFolderSelected(const QModelIndex& index);
 
     /**
      * @brief Slot for when a note is selected.
-     * @param item The selected item.
+     * @param index The model index of the selected note.
+     */
+    void onNoteSelected(const QModelIndex& index);
+
+    /**
+     * @brief Slot for editor changes: marks the note dirty and restarts the autosave timer.
+     */
+    void onEditorTextChanged();
+
+    /**
+     * @brief Slot for the autosave timer: saves the editor once it has been quiet.
      */
-    void onNoteSelected(QListWidgetItem* item);
+    void onAutosaveTimeout();
 
     /**
      * @brief Slot for performing an advanced search.
      */
     void onAdvancedSearch();
 
+    /**
+     * @brief Slot for results of the search dialog's live search: shows them in the note list.
+     * @param note_ids The IDs of the matching notes.
+     * @param complete Whether the search has finished.
+     */
+    void showLiveSearchResults(const std::vector<int>& note_ids, bool complete);
+
     /**
      * @brief Slot for showing the trash.
      */
@@ -228,6 +287,36 @@ private slots:
        */
       void setupUI();
 
+    /**
+     * @brief Creates the note list view and its model, and connects its selection.
+     * Called by setupUI.
+     */
+    void setupNoteList();
+
+    /**
+     * @brief Creates the folder tree view and its model, and connects its selection.
+     * Called by setupUI.
+     */
+    void setupFolderTree();
+
+    /**
+     * @brief Creates the autosave engine and timer, and connects the editor to them.
+     * Called by setupUI after the editor exists.
+     */
+    void setupAutosave();
+
+    /**
+     * @brief Saves the editor's text into the current note if it has unsaved edits.
+     * Called before the editor shows another note and when the window closes.
+     */
+    void saveEditorNow();
+
+    /**
+     * @brief Saves and closes the note in the editor, leaving the editor empty.
+     * Called whenever the note list stops showing the note being edited.
+     */
+    void closeEditorNote();
+
     /**
      * @brief Sets up the menu bar.
      */
@@ -250,19 +339,13 @@ private slots:
 
     // --- Data Loading & UI Refreshing ---
     /**
-     * @brief Loads the folder tree.
+     * @brief Points the folder tree model at the root and trash folders.
+     * Does nothing if they are already shown; later changes reach the view through the model.
      */
     void loadFolderTree();
 
     /**
-     * @brief Populates a folder in the folder tree.
-     * @param parentItem The parent item.
-     * @param folder The folder to populate.
-     */
-    void populateFolder(QTreeWidgetItem* parentItem, const std::shared_ptr<Folder>& folder);
-
-    /**
-     * @brief Loads the notes for a folder.
+     * @brief Shows the notes of a folder. The model then follows the folder's changes by itself.
      * @param folder The folder to load the notes for.
      */
     void loadNotesForFolder(const std::shared_ptr<Folder>& folder);
@@ -272,13 +355,26 @@ private slots:
      */
     void refreshUI();
 
+    /**
+     * @brief Queues showNextSearchPage() for the next event loop turn, unless the search is complete.
+     */
+    void scheduleNextSearchPage();
+
+    /**
+     * @brief Adds the next page of the running search to the note list, and schedules the one after.
+     * Each page is fetched in its own event loop turn, so the window stays responsive.
+     */
+    void showNextSearchPage();
+
     // --- Core Components ---
     NoteManager& noteManager;
 
     // --- Main Widgets ---
     QSplitter* mainSplitter;
-    QTreeWidget* folderTree;
-    QListWidget* noteList;
+    QTreeView* folderTree;
+    FolderTreeModel* folderTreeModel;
+    QListView* noteList;
+    NoteListModel* noteListModel;
     QTextEdit* noteEditor;
     QTextBrowser* logViewer; // For displaying logs
     QGraphicsView* boardView;
@@ -309,6 +405,14 @@ private slots:
         // --- State Tracking ---
         std::shared_ptr<Folder> currentFolder;
     std::shared_ptr<Note> currentNote;
+
+    // --- Autosave ---
+    std::unique_ptr<AutosaveEngine> autosave;
+    QTimer* autosaveTimer;
+
+    // --- Search ---
+    std::unique_ptr<SearchCursor> searchCursor; // Results still to be shown; null when the list shows a folder
+    bool searchPageQueued = false;
 };
 
 #endif // UI_HPP